@@ -212,6 +212,7 @@ int    b_dot_cmd(register int n,char *argv[],Shbltin_t *context)
 	register Shell_t *shp = context->shp;
 	struct sh_scoped savst, *prevscope = shp->st.self;
 	char *filename=0, *buffer=0;
+	void	*cache=0;
 	int	fd;
 	struct dolnod   *saveargfor;
 	volatile struct dolnod   *argsave=0;
@@ -258,6 +259,8 @@ int    b_dot_cmd(register int n,char *argv[],Shbltin_t *context)
 			if((fd=path_open(shp,script,path_get(shp,script))) < 0)
 				errormsg(SH_DICT,ERROR_system(1),e_open,script);
 			filename = path_fullname(shp,stkptr(shp->stk,PATH_OFFSET));
+			if(!sh_isstate(SH_PROFILE))
+				fd = sh_cacheopen(shp,fd,filename,&cache);
 		}
 	}
 	*prevscope = shp->st;
@@ -292,6 +295,7 @@ int    b_dot_cmd(register int n,char *argv[],Shbltin_t *context)
 			buffer = malloc(IOBSIZE+1);
 			iop = sfnew(NIL(Sfio_t*),buffer,IOBSIZE,fd,SF_READ);
 			sh_offstate(SH_NOFORK);
+			shp->cache = cache;
 			sh_eval(iop,sh_isstate(SH_PROFILE)?SH_FUNEVAL:0);
 		}
 	}
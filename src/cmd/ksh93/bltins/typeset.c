@@ -175,9 +175,14 @@ int    b_alias(int argc,register char *argv[],Shbltin_t *context)
 		argv += (opt_info.index-1);
 		if(flag&NV_TAGGED)
 		{
-			/* hacks to handle hash -r | -- */
+			/* hacks to handle hash -r | -s | -- */
 			if(argv[1] && argv[1][0]=='-')
 			{
+				if(argv[1][1]=='s' && argv[1][2]==0)
+				{
+					path_dirstats(tdata.sh,sfstdout);
+					return(0);
+				}
 				if(argv[1][1]=='r' && argv[1][2]==0)
 				{
 					Namval_t *np = nv_search((char*)PATHNOD,tdata.sh->var_tree,HASH_BUCKET);
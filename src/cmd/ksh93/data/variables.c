@@ -127,10 +127,14 @@ const Shtable_t shtab_stats[] =
 	"nv_cachehit",		STAT_NVHITS,
 	"nv_opens",		STAT_NVOPEN,
 	"pathsearch",		STAT_PATHS,
+	"pipe_noforks",		STAT_PIPENOFORK,
 	"posixfuncall",		STAT_SVFUNCT,
 	"simplecmds",		STAT_SCMDS,
 	"spawns",		STAT_SPAWN,
-	"subshell",		STAT_SUBSHELL
+	"src_cachehits",	STAT_CACHEHIT,
+	"src_cachewrites",	STAT_CACHEWRITE,
+	"subshell",		STAT_SUBSHELL,
+	"subshell_forks",	STAT_SUBFORK
 };
 #endif /* SHOPT_STATS */
 
@@ -149,6 +149,7 @@ struct shared
 	Stk_t		*stk;		/* stack poiter */ \
 	Sfio_t		*heredocs;	/* current here-doc temp file */ \
 	Sfio_t		*funlog;	/* for logging function definitions */ \
+	void		*cache;		/* script cache for the next sh_eval() */ \
 	int		**fdptrs;	/* pointer to file numbers */ \
 	int		savexit; \
 	char		*lastarg; \
@@ -407,6 +408,9 @@ extern void 		sh_envput(Env_t*, Namval_t*);
 extern void 		sh_envnolocal(Namval_t*,void*);
 extern Sfdouble_t	sh_arith(Shell_t*,const char*);
 extern void		*sh_arithcomp(Shell_t *,char*);
+extern void		sh_cacheclose(Shell_t*,void*,int);
+extern void		sh_cachedump(Shell_t*,void*,Shnode_t*);
+extern int		sh_cacheopen(Shell_t*,int,const char*,void**);
 extern pid_t 		sh_fork(Shell_t*,int,int*);
 extern pid_t		_sh_fork(Shell_t*,pid_t, int ,int*);
 extern char 		*sh_mactrim(Shell_t*,char*,int);
@@ -496,10 +500,14 @@ extern const char	e_dict[];
 #   define	STAT_NVHITS	7
 #   define	STAT_NVOPEN	8
 #   define	STAT_PATHS	9
-#   define	STAT_SVFUNCT	10
-#   define	STAT_SCMDS	11
-#   define	STAT_SPAWN	12
-#   define	STAT_SUBSHELL	13
+#   define	STAT_PIPENOFORK	10
+#   define	STAT_SVFUNCT	11
+#   define	STAT_SCMDS	12
+#   define	STAT_SPAWN	13
+#   define	STAT_CACHEHIT	14
+#   define	STAT_CACHEWRITE	15
+#   define	STAT_SUBSHELL	16
+#   define	STAT_SUBFORK	17
     extern const Shtable_t shtab_stats[];
 #   define sh_stats(x)	(shgd->stats[(x)]++)
 #else
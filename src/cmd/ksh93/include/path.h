@@ -73,6 +73,8 @@ typedef struct pathcomp
 /* pathname handling routines */
 extern void		path_newdir(Shell_t*,Pathcomp_t*);
 extern Pathcomp_t	*path_dirfind(Pathcomp_t*,const char*,int);
+extern void		path_dirflush(Shell_t*);
+extern void		path_dirstats(Shell_t*,Sfio_t*);
 extern Pathcomp_t	*path_unsetfpath(Shell_t*);
 extern Pathcomp_t	*path_addpath(Shell_t*,Pathcomp_t*,const char*,int);
 extern Pathcomp_t	*path_dup(Pathcomp_t*);
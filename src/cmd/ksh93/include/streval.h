@@ -92,16 +92,40 @@ struct mathtab
 	Sfdouble_t	(*fnptr)(Sfdouble_t,...);
 };
 
+/*
+ * integer program compiled from code when the expression has
+ * only integer operators and literals; it runs in Sflong_t
+ * when all its variables are integers and falls back to code
+ */
+typedef struct _arith_iop_
+{
+	Sflong_t	num;		/* literal value		*/
+	short		op;		/* A_* operator			*/
+	short		arg;		/* variable or jump target	*/
+	short		pc;		/* offset of the op in code	*/
+} Arith_iop_t;
+
+typedef struct _arith_ivar_
+{
+	char		*value;		/* node or name in expr		*/
+	short		flag;
+	short		store;		/* assigned by the expression	*/
+} Arith_ivar_t;
+
 typedef struct _arith_
 {
 	Shell_t		*shp;
 	unsigned char	*code;
 	const char	*expr;
 	Sfdouble_t	(*fun)(const char**,struct lval*,int,Sfdouble_t);
+	Arith_iop_t	*icode;		/* integer program or 0		*/
+	Arith_ivar_t	*ivar;		/* integer program variables	*/
 	short		size;
 	short		staksize;
 	short		emode;
 	short		elen;
+	short		isize;		/* number of icode ops		*/
+	short		nivar;		/* number of ivar variables	*/
 } Arith_t;
 #define ARITH_COMP	04	/* set when compile separate from execute */
 #define ARITH_ASSIGNOP	010	/* set during assignment operators  */
@@ -200,6 +224,7 @@ extern const struct 		mathtab shtab_math[];
 #define ASSIGN	1
 #define VALUE	2
 #define MESSAGE	3
+#define BIND	4	/* integer storage for an icode variable */
 
 extern Sfdouble_t strval(Shell_t*,const char*,char**,Sfdouble_t(*)(const char**,struct lval*,int,Sfdouble_t),int);
 extern Arith_t *arith_compile(Shell_t *,const char*,char**,Sfdouble_t(*)(const char**,struct lval*,int,Sfdouble_t),int);
@@ -65,10 +65,11 @@ static Namval_t *scope(register Namval_t *np,register struct lval *lvalue,int as
 	Shell_t		*shp = lvalue->shp;
 	int	flags = HASH_NOSCOPE|HASH_SCOPE|HASH_BUCKET;
 	int	c=0,nosub = lvalue->nosub;
+	int	bind = assign<0;
 	Dt_t	*sdict = (shp->st.real_fun? shp->st.real_fun->sdict:0);
 	Dt_t	*nsdict = (shp->namespace?nv_dict(shp->namespace):0);
 	Dt_t	*root = shp->var_tree;
-	assign = assign?NV_ASSIGN:NV_NOASSIGN;
+	assign = assign>0?NV_ASSIGN:NV_NOASSIGN;
 	lvalue->nosub = 0;
 	if(nosub<0 && lvalue->ovalue)
 		return((Namval_t*)lvalue->ovalue);
@@ -79,7 +80,7 @@ static Namval_t *scope(register Namval_t *np,register struct lval *lvalue,int as
 		/* do binding to node now */
 		int c = cp[flag];
 		cp[flag] = 0;
-		if((!(np = nv_open(cp,shp->var_tree,assign|NV_VARNAME|NV_NOADD|NV_NOFAIL)) || nv_isnull(np)) && sh_macfun(shp,cp, offset = staktell()))
+		if((!(np = nv_open(cp,shp->var_tree,assign|NV_VARNAME|NV_NOADD|NV_NOFAIL)) || nv_isnull(np)) && !bind && sh_macfun(shp,cp, offset = staktell()))
 		{
 			Fun = sh_arith(shp,sub=stakptr(offset));
 			FunNode.nvalue.ldp = &Fun;
@@ -484,6 +485,41 @@ static Sfdouble_t arith(const char **ptr, struct lval *lvalue, int type, Sfdoubl
 		return(r);
 	    }
 
+	    case BIND:
+	    {
+		/* plain integer variables only, n!=0 when assigned */
+		register Namval_t *np;
+		if(sh_isoption(SH_NOEXEC))
+			return(-1);
+#if SHOPT_OPTIMIZE
+		if(shp->argaddr)
+			return(-1);
+#endif /* SHOPT_OPTIMIZE */
+		if(!(np = scope((Namval_t*)lvalue->value,lvalue,-1)) || np->nvfun || nv_isnull(np) || np->nvalue.cp==Empty)
+			return(-1);
+		if(nv_isattr(np,NV_INTEGER|NV_ZFILL|NV_SHORT|NV_UNSIGN|NV_BINARY|NV_ARRAY|NV_REF|NV_TABLE)!=NV_INTEGER)
+			return(-1);
+		if(n)
+		{
+			if(nv_isattr(np,NV_RDONLY) || sh_isoption(SH_ALLEXPORT))
+				return(-1);
+			shp->argaddr = 0;
+			if(shp->subshell)
+				np = sh_assignok(np,1);
+			if(nv_isattr(np,NV_EXPORT))
+				nv_offattr(np,NV_IMPORT);
+			if(nv_size(np) <= 1)
+				nv_setsize(np,10);
+		}
+		if(nv_isattr(np,NV_LONG))
+		{
+			lvalue->ptr = (void*)np->nvalue.llp;
+			return(sizeof(Sflong_t));
+		}
+		lvalue->ptr = (void*)np->nvalue.lp;
+		return(sizeof(int32_t));
+	    }
+
 	    case MESSAGE:
 		sfsync(NIL(Sfio_t*));
 #if 0
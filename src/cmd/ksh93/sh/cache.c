@@ -0,0 +1,182 @@
+/***********************************************************************
+*                                                                      *
+*               This software is part of the ast package               *
+*          Copyright (c) 1982-2011 AT&T Intellectual Property          *
+*                      and is licensed under the                       *
+*                 Eclipse Public License, Version 1.0                  *
+*                    by AT&T Intellectual Property                     *
+*                                                                      *
+*                A copy of the License is available at                 *
+*          http://www.eclipse.org/org/documents/epl-v10.html           *
+*         (with md5 checksum b35adb5213ca9657e911e9befb180842)         *
+*                                                                      *
+*              Information and Software Systems Research               *
+*                            AT&T Research                             *
+*                           Florham Park NJ                            *
+*                                                                      *
+*                  David Korn <dgk@research.att.com>                   *
+*                                                                      *
+***********************************************************************/
+#pragma prototyped
+/*
+ * compiled script cache
+ *
+ * scripts read with . and autoloaded function files are kept
+ * in shcomp format in the $SHCACHE directory
+ * each cache file starts with a key line that records the script
+ * path, device, inode, size and modify time, the shell version,
+ * and the aliases and options that change how a script parses
+ */
+
+#include	"defs.h"
+#include	"shnodes.h"
+#include	"path.h"
+#include	"io.h"
+#include	"variables.h"
+#include	<ls.h>
+#include	<tmx.h>
+
+#define CNTL(x)		((x)&037)
+#define VERSION		3
+
+static const char header[6] = { CNTL('k'),CNTL('s'),CNTL('h'),0,VERSION,0 };
+
+typedef struct _cache_
+{
+	Sfio_t		*out;		/* compiled script being written */
+	char		*tmp;		/* temporary file for out */
+	char		*path;		/* cache file */
+} Cache_t;
+
+/*
+ * return the key line for script <path> with status <sp>
+ */
+static char *cachekey(Shell_t *shp, const char *path, struct stat *sp)
+{
+	register Namval_t	*np;
+	register char		*cp;
+	unsigned long		sum = 0;
+	int			opts = 0;
+	if(!sh_isstate(SH_NOALIAS))
+	{
+		for(np=(Namval_t*)dtfirst(shp->alias_tree); np; np=(Namval_t*)dtnext(shp->alias_tree,np))
+		{
+			sum = strsum(nv_name(np),sum);
+			if(cp = nv_getval(np))
+				sum = strsum(cp,sum);
+		}
+		opts |= 1;
+	}
+	if(sh_isoption(SH_BRACEEXPAND))
+		opts |= 2;
+	if(sh_isoption(SH_KEYWORD))
+		opts |= 4;
+	if(sh_isoption(SH_POSIX))
+		opts |= 010;
+#if SHOPT_BASH
+	if(sh_isoption(SH_BASH))
+		opts |= 020;
+#endif /* SHOPT_BASH */
+	sfprintf(shp->strbuf,"#!ksh %d %s %lu %lu %I*u %I*u %lx %o %s\n",VERSION,fmtident(e_version),(unsigned long)sp->st_dev,(unsigned long)sp->st_ino,sizeof(Sfulong_t),(Sfulong_t)sp->st_size,sizeof(Sfulong_t),(Sfulong_t)tmxgetmtime(sp),sum,opts,path);
+	return(strdup(sfstruse(shp->strbuf)));
+}
+
+/*
+ * return a file descriptor for the compiled form of script <path> open on <fd>
+ * <fd> is returned as is when there is no valid cache file
+ * in that case *cache is set when a new cache file can be written
+ * by passing it to sh_eval() through shp->cache
+ */
+int sh_cacheopen(Shell_t *shp, int fd, const char *path, void **cache)
+{
+	register Namval_t	*np;
+	register Cache_t	*cp;
+	register char		*dir, *key, *name, *buf;
+	struct stat		statb, cstatb;
+	int			n, cfd;
+	*cache = 0;
+	if(shp->shcomp || sh_isoption(SH_NOEXEC) || sh_isoption(SH_VERBOSE) || sh_isstate(SH_VERBOSE))
+		return(fd);
+	if(!(np = nv_search("SHCACHE",shp->var_tree,0)) || !(dir = nv_getval(np)) || *dir!='/')
+		return(fd);
+	if(fstat(fd,&statb)<0 || !S_ISREG(statb.st_mode) || statb.st_size==0)
+		return(fd);
+	key = cachekey(shp,path,&statb);
+	sfprintf(shp->strbuf,"%s/%08lx",dir,strsum(path,0));
+	name = strdup(sfstruse(shp->strbuf));
+	n = strlen(key);
+	if((cfd = sh_open(name,O_RDONLY,0)) >= 0)
+	{
+		buf = (char*)malloc(n);
+		if(fstat(cfd,&cstatb)>=0 && S_ISREG(cstatb.st_mode) && cstatb.st_uid==geteuid() && !(cstatb.st_mode&(S_IWGRP|S_IWOTH)) && read(cfd,buf,n)==n && memcmp(buf,key,n)==0 && (cfd = sh_iomovefd(cfd)) > 0)
+		{
+			free((void*)buf);
+			free((void*)key);
+			free((void*)name);
+			fcntl(cfd,F_SETFD,FD_CLOEXEC);
+			shp->fdstatus[cfd] |= IOCLEX;
+			sh_close(fd);
+			sh_stats(STAT_CACHEHIT);
+			return(cfd);
+		}
+		free((void*)buf);
+		sh_close(cfd);
+	}
+	if(eaccess(dir,W_OK|X_OK)<0 && (errno!=ENOENT || mkdir(dir,S_IRWXU)<0))
+		goto done;
+	if(!(cp = newof(0,Cache_t,1,0)))
+		goto done;
+	if(!(cp->tmp = pathtemp(NiL,0,dir,"ksh",&cfd)))
+	{
+		free((void*)cp);
+		goto done;
+	}
+	if(!(cp->out = sfnew(NiL,NiL,SF_UNBOUND,cfd,SF_WRITE)))
+	{
+		close(cfd);
+		remove(cp->tmp);
+		free((void*)cp->tmp);
+		free((void*)cp);
+		goto done;
+	}
+	fcntl(cfd,F_SETFD,FD_CLOEXEC);
+	sfwrite(cp->out,key,n);
+	sfwrite(cp->out,header,sizeof(header));
+	cp->path = name;
+	name = 0;
+	*cache = (void*)cp;
+	sh_stats(STAT_CACHEWRITE);
+ done:
+	free((void*)key);
+	if(name)
+		free((void*)name);
+	return(fd);
+}
+
+/*
+ * add parse tree <t> to <cache>
+ */
+void sh_cachedump(Shell_t *shp, void *cache, Shnode_t *t)
+{
+	register Cache_t *cp = (Cache_t*)cache;
+	if(t && !sferror(cp->out) && sh_tdump(cp->out,t) < 0)
+		sfset(cp->out,SF_ERROR,1);
+}
+
+/*
+ * close <cache>
+ * the cache file is replaced when <commit> is set and all trees were written
+ */
+void sh_cacheclose(Shell_t *shp, void *cache, int commit)
+{
+	register Cache_t *cp = (Cache_t*)cache;
+	if(sfsync(cp->out) < 0 || sferror(cp->out))
+		commit = 0;
+	if(sfclose(cp->out) < 0)
+		commit = 0;
+	if(!commit || rename(cp->tmp,cp->path) < 0)
+		remove(cp->tmp);
+	free((void*)cp->tmp);
+	free((void*)cp->path);
+	free((void*)cp);
+}
@@ -341,6 +341,7 @@ static void put_restricted(register Namval_t* np,const char *val,int flags,Namfu
 	if(np==PATHNOD	|| (path_scoped=(strcmp(name,PATHNOD->nvname)==0)))		
 	{
 		nv_scan(shp->track_tree,rehash,(void*)0,NV_TAGGED,NV_TAGGED);
+		path_dirflush(shp);
 		if(path_scoped && !val)
 			val = PATHNOD->nvalue.cp;
 	}
@@ -1775,7 +1776,7 @@ static Namfun_t	 stat_child_fun =
 
 static void stat_init(Shell_t *shp)
 {
-	int		i,nstat = STAT_SUBSHELL+1;
+	int		i,nstat = STAT_SUBFORK+1;
 	struct Stats	*sp = newof(0,struct Stats,1,nstat*NV_MINSZ);
 	Namval_t	*np;
 	sp->numnodes = nstat;
@@ -27,6 +27,8 @@
 #include	"defs.h"
 #include	<fcin.h>
 #include	<ls.h>
+#include	<ast_dir.h>
+#include	<tmx.h>
 #include	<nval.h>
 #include	"variables.h"
 #include	"path.h"
@@ -586,6 +588,7 @@ char *path_fullname(Shell_t *shp,const char *name)
 static void funload(Shell_t *shp,int fno, const char *name)
 {
 	char		*pname,*oldname=shp->st.filename, buff[IOBSIZE+1];
+	void		*cache;
 	Namval_t	*np;
 	struct Ufunction *rp,*rpfirst;
 	int		 savestates = sh_getstate(), oldload=shp->funload;
@@ -621,6 +624,8 @@ static void funload(Shell_t *shp,int fno, const char *name)
 	shp->st.filename = pname;
 	shp->funload = 1;
 	error_info.line = 0;
+	fno = sh_cacheopen(shp,fno,pname,&cache);
+	shp->cache = cache;
 	sh_eval(sfnew(NIL(Sfio_t*),buff,IOBSIZE,fno,SF_READ),SH_FUNEVAL);
 	sh_close(fno);
 	shp->readscript = 0;
@@ -726,6 +731,179 @@ int	path_search(Shell_t *shp,register const char *name,Pathcomp_t **oldpp, int f
 	return(0);
 }
 
+/*
+ * the names in each absolute directory searched by path_absolute()
+ * the directory is stat()ed at most once a second or after PATH is
+ * assigned and is reread when its modify or change time differs
+ * a search that fails stat()s the directories it skipped again
+ */
+typedef struct Pathdir_s
+{
+	Dtlink_t	link;
+	Time_t		mtime;		/* directory modify time of names */
+	Time_t		ctime;		/* directory change time of names */
+	time_t		checked;	/* time directory was last stat()ed */
+	int		stale;		/* last skip used an earlier check */
+	char		**names;	/* sorted directory entries */
+	int		nnames;
+	char		dir[1];
+} Pathdir_t;
+
+static Dtdisc_t	Pathdisc =
+{
+	offsetof(Pathdir_t,dir), 0, offsetof(Pathdir_t,link)
+};
+
+static struct
+{
+	Dt_t		*dict;
+	Sfio_t		*buf;
+	unsigned long	hits;		/* stat()s avoided */
+	unsigned long	misses;		/* stat()s needed */
+	unsigned long	reads;		/* directories read */
+	unsigned long	checks;		/* directories stat()ed */
+} pathdirs;
+
+static int pathdircmp(const void *a, const void *b)
+{
+	return(strcmp(*(char**)a,*(char**)b));
+}
+
+/*
+ * stat() directory dp->dir and reread its names if it changed
+ * returns 0 if the names cannot be used
+ */
+static int path_dircheck(register Pathdir_t *dp, time_t now)
+{
+	register char		*cp;
+	register int		n;
+	DIR			*dirf;
+	struct dirent		*ep;
+	struct stat		statb;
+	size_t			size;
+	dp->checked = now;
+	pathdirs.checks++;
+	if(stat(dp->dir,&statb)<0)
+		goto discard;
+	if(!dp->names || tmxgetmtime(&statb)!=dp->mtime || tmxgetctime(&statb)!=dp->ctime)
+	{
+		if(dp->names)
+		{
+			free((void*)dp->names);
+			dp->names = 0;
+		}
+		if(!pathdirs.buf && !(pathdirs.buf = sfstropen()))
+			goto discard;
+		if(!(dirf = opendir(dp->dir)))
+			goto discard;
+		pathdirs.reads++;
+		sfstrseek(pathdirs.buf,0,SEEK_SET);
+		for(n=0; ep = readdir(dirf); n++)
+			sfputr(pathdirs.buf,ep->d_name,0);
+		closedir(dirf);
+		size = sfstrtell(pathdirs.buf);
+		if(!(dp->names = (char**)malloc(n*sizeof(char*)+size)))
+			goto discard;
+		cp = memcpy((char*)&dp->names[n],sfstrbase(pathdirs.buf),size);
+		for(dp->nnames=0; dp->nnames < n; cp+=strlen(cp)+1)
+			dp->names[dp->nnames++] = cp;
+		qsort((void*)dp->names,n,sizeof(char*),pathdircmp);
+		/* a change later in the same second may not change the time so the names are not trusted */
+		dp->mtime = statb.st_mtime>=now ? 0 : tmxgetmtime(&statb);
+		dp->ctime = tmxgetctime(&statb);
+	}
+	return(1);
+discard:
+	if(dp->names)
+	{
+		free((void*)dp->names);
+		dp->names = 0;
+	}
+	return(0);
+}
+
+/*
+ * returns 0 when <name> is known not to be in directory <dir>
+ */
+static int path_indir(const char *dir, const char *name)
+{
+	register Pathdir_t	*dp;
+	time_t			now = time(NiL);
+	int			stale;
+	if(!pathdirs.dict && !(pathdirs.dict = dtopen(&Pathdisc,Dtset)))
+		return(1);
+	if(!(dp = (Pathdir_t*)dtmatch(pathdirs.dict,dir)))
+	{
+		if(!(dp = newof((Pathdir_t*)0,Pathdir_t,1,strlen(dir))))
+			return(1);
+		strcpy(dp->dir,dir);
+		dtinsert(pathdirs.dict,dp);
+	}
+	stale = dp->checked==now;
+	dp->stale = 0;
+	if((!stale && !path_dircheck(dp,now)) || !dp->names || !dp->mtime || bsearch((void*)&name,(void*)dp->names,dp->nnames,sizeof(char*),pathdircmp))
+	{
+		pathdirs.misses++;
+		return(1);
+	}
+	dp->stale = stale;
+	pathdirs.hits++;
+	return(0);
+}
+
+/*
+ * the directories in pp that were skipped with a snapshot checked before
+ * this search are checked again in case <name> was added since then
+ * returns 1 if <name> is now in one of them
+ */
+static int path_recheck(register Pathcomp_t *pp, const char *name)
+{
+	register Pathdir_t	*dp;
+	time_t			now = time(NiL);
+	int			r = 0;
+	if(!pathdirs.dict)
+		return(0);
+	for(; pp; pp=pp->next)
+	{
+		if(*pp->name!='/' || !(dp = (Pathdir_t*)dtmatch(pathdirs.dict,pp->name)) || !dp->stale)
+			continue;
+		dp->stale = 0;
+		if(path_dircheck(dp,now) && (!dp->mtime || bsearch((void*)&name,(void*)dp->names,dp->nnames,sizeof(char*),pathdircmp)))
+			r = 1;
+	}
+	return(r);
+}
+
+/*
+ * check each directory snapshot again on its next use
+ * called when PATH is assigned
+ */
+void path_dirflush(Shell_t *shp)
+{
+	register Pathdir_t	*dp;
+	NOT_USED(shp);
+	if(!pathdirs.dict)
+		return;
+	for(dp=(Pathdir_t*)dtfirst(pathdirs.dict); dp; dp=(Pathdir_t*)dtnext(pathdirs.dict,dp))
+		dp->checked = 0;
+}
+
+/*
+ * print the directory snapshot statistics for hash -s
+ */
+void path_dirstats(Shell_t *shp, Sfio_t *out)
+{
+	register Pathdir_t	*dp;
+	int			n=0;
+	NOT_USED(shp);
+	if(pathdirs.dict)
+	{
+		for(dp=(Pathdir_t*)dtfirst(pathdirs.dict); dp; dp=(Pathdir_t*)dtnext(pathdirs.dict,dp))
+			n++;
+	}
+	sfprintf(out,"dirs=%d reads=%lu checks=%lu hits=%lu misses=%lu\n",n,pathdirs.reads,pathdirs.checks,pathdirs.hits,pathdirs.misses);
+}
+
 /*
  * do a path search and find the full pathname of file name
  */
@@ -733,13 +911,17 @@ Pathcomp_t *path_absolute(Shell_t *shp,register const char *name, Pathcomp_t *pp
 {
 	register int	f,isfun;
 	int		noexec=0;
-	Pathcomp_t	*oldpp;
+	int		usedir = !strchr(name,'/');
+	int		rechecked = 0;
+	Pathcomp_t	*oldpp, *first;
 	Namval_t	*np;
 	char		*cp;
 	char		*bp;
 	shp->path_err = ENOENT;
 	if(!pp && !(pp=path_get(shp,"")))
 		return(0);
+	first = pp;
+again:
 	shp->path_err = 0;
 	while(1)
 	{
@@ -753,6 +935,11 @@ Pathcomp_t *path_absolute(Shell_t *shp,register const char *name, Pathcomp_t *pp
 		}
 		if(!oldpp)
 		{
+			if(usedir && !rechecked++ && path_recheck(first,name))
+			{
+				pp = first;
+				goto again;
+			}
 			shp->path_err = ENOENT;
 			return(0);
 		}
@@ -863,8 +1050,18 @@ Pathcomp_t *path_absolute(Shell_t *shp,register const char *name, Pathcomp_t *pp
 #endif /* SHOPT_DYNAMIC */
 		}
 		shp->bltin_dir = 0;
-		sh_stats(STAT_PATHS);
-		f = canexecute(shp,stakptr(PATH_OFFSET),isfun);
+#if !_WINIX
+		if(usedir && !isfun && *oldpp->name=='/' && !path_indir(oldpp->name,name))
+		{
+			errno = ENOENT;
+			f = -1;
+		}
+		else
+#endif /* !_WINIX */
+		{
+			sh_stats(STAT_PATHS);
+			f = canexecute(shp,stakptr(PATH_OFFSET),isfun);
+		}
 		if(isfun && f>=0 && (cp = strrchr(name,'.')))
 		{
 			*cp = 0;
@@ -902,6 +1099,13 @@ Pathcomp_t *path_absolute(Shell_t *shp,register const char *name, Pathcomp_t *pp
 	}
 	if(f<0)
 	{
+		if(usedir && !rechecked++ && path_recheck(first,name))
+		{
+			/* a skipped directory changed after its snapshot was checked */
+			pp = first;
+			noexec = 0;
+			goto again;
+		}
 		shp->path_err = (noexec?noexec:ENOENT);
 		return(0);
 	}
@@ -45,6 +45,9 @@
 
 #define MAXLEVEL	9
 #define SMALL_STACK	12
+#define ICODE_OPS	128	/* maximum ops in an integer program */
+#define ICODE_VARS	16	/* maximum variables in an integer program */
+#define ICODE_SIZE	1024	/* maximum code size for an integer program */
 
 /*
  * The following are used with tokenbits() macro
@@ -152,6 +155,235 @@ static Sfdouble_t U2F(Sfulong_t u)
 #define U2F(x)		x
 #endif
 
+/*
+ * run the integer program of ep on Sflong_t values
+ * all variables are bound to their integer storage first and
+ * -1 is returned without running anything if one can't be bound
+ * 0 is returned with the value in *np when the program completes
+ * on overflow, division by zero, or an out of range shift the op is
+ * left to the floating point executor: the stack is copied to sp,tp,
+ * *cpp is set to the op in code, and the stack depth is returned
+ */
+static int intexec(Arith_t *ep, Sfdouble_t *sp, char *tp, Sfdouble_t *np, unsigned char **cpp)
+{
+	register Arith_iop_t	*ip = ep->icode;
+	register Arith_iop_t	*end = ip + ep->isize;
+	register Sflong_t	n=0, *xp;
+	register Sfulong_t	u;
+	Sflong_t		*stack, small_stack[SMALL_STACK+1];
+	void			*addr[ICODE_VARS];
+	char			size[ICODE_VARS];
+	const char		*ptr = "";
+	struct lval		node;
+	int			i;
+	node.shp = ep->shp;
+	node.expr = ep->expr;
+	node.elen = ep->elen;
+	node.ovalue = 0;
+	for(i=0; i < ep->nivar; i++)
+	{
+		node.value = ep->ivar[i].value;
+		node.flag = ep->ivar[i].flag;
+		node.emode = ep->emode;
+		node.level = level;
+		node.nosub = 0;
+		node.eflag = 0;
+		node.ptr = 0;
+		switch((int)(*ep->fun)(&ptr,&node,BIND,(Sfdouble_t)ep->ivar[i].store))
+		{
+		    case sizeof(int32_t):
+			size[i] = sizeof(int32_t);
+			break;
+		    case sizeof(Sflong_t):
+			size[i] = sizeof(Sflong_t);
+			break;
+		    default:
+			return(-1);
+		}
+		addr[i] = (void*)node.ptr;
+	}
+#define iget(v)		(size[v]==sizeof(int32_t)?(Sflong_t)*(int32_t*)addr[v]:*(Sflong_t*)addr[v])
+#define iput(v,x)	(size[v]==sizeof(int32_t)?(Sflong_t)(*(int32_t*)addr[v]=(int32_t)(x)):(*(Sflong_t*)addr[v]=(x)))
+	if(ep->staksize < SMALL_STACK)
+		stack = small_stack;
+	else
+		stack = (Sflong_t*)stakalloc(ep->staksize*sizeof(Sflong_t));
+	xp = stack-1;
+	while(ip < end)
+	{
+		switch(ip->op)
+		{
+		    case A_JMP:
+			ip = ep->icode + ip->arg;
+			continue;
+		    case A_JMPZ:
+			if(!n)
+			{
+				ip = ep->icode + ip->arg;
+				continue;
+			}
+			break;
+		    case A_JMPNZ:
+			if(n)
+			{
+				ip = ep->icode + ip->arg;
+				continue;
+			}
+			break;
+		    case A_POP:
+			xp--;
+			break;
+		    case A_PUSHV:
+			*++xp = n = iget(ip->arg);
+			break;
+		    case A_PUSHN:
+			*++xp = n = ip->num;
+			break;
+		    case A_STORE:
+			*xp = n = iput(ip->arg,n);
+			break;
+		    case A_NOTNOT:
+			*xp = n = (n!=0);
+			break;
+		    case A_NOT:
+			*xp = n = !n;
+			break;
+		    case A_TILDE:
+			*xp = n = ~n;
+			break;
+		    case A_UMINUS:
+			if(n==LLONG_MIN)
+				goto bail;
+			*xp = n = -n;
+			break;
+		    case A_INCR:
+			if(n==LLONG_MAX)
+				goto bail;
+			*xp = n = iput(ip->arg,n+1);
+			break;
+		    case A_DECR:
+			if(n==LLONG_MIN)
+				goto bail;
+			*xp = n = iput(ip->arg,n-1);
+			break;
+		    case A_PLUSPLUS:
+			if(n==LLONG_MAX)
+				goto bail;
+			iput(ip->arg,n+1);
+			break;
+		    case A_MINUSMINUS:
+			if(n==LLONG_MIN)
+				goto bail;
+			iput(ip->arg,n-1);
+			break;
+		    case A_PLUS:
+			u = (Sfulong_t)xp[-1] + (Sfulong_t)n;
+			if(((xp[-1]^(Sflong_t)u)&(n^(Sflong_t)u)) < 0)
+				goto bail;
+			*--xp = n = (Sflong_t)u;
+			break;
+		    case A_MINUS:
+			u = (Sfulong_t)xp[-1] - (Sfulong_t)n;
+			if(((xp[-1]^n)&(xp[-1]^(Sflong_t)u)) < 0)
+				goto bail;
+			*--xp = n = (Sflong_t)u;
+			break;
+		    case A_TIMES:
+			if(xp[-1]!=(int32_t)xp[-1] || n!=(int32_t)n)
+			{
+				if(n==-1 && xp[-1]==LLONG_MIN || xp[-1]==-1 && n==LLONG_MIN)
+					goto bail;
+				u = (Sfulong_t)xp[-1] * (Sfulong_t)n;
+				if(n && (Sflong_t)u/n != xp[-1])
+					goto bail;
+			}
+			n = xp[-1] * n;
+			*--xp = n;
+			break;
+		    case A_DIV:
+			if(!n || n==-1 && xp[-1]==LLONG_MIN)
+				goto bail;
+			n = xp[-1] / n;
+			*--xp = n;
+			break;
+		    case A_MOD:
+			if(!n || n==-1 && xp[-1]==LLONG_MIN)
+				goto bail;
+			n = xp[-1] % n;
+			*--xp = n;
+			break;
+		    case A_LSHIFT:
+			if(n<0 || n>=(Sflong_t)(8*sizeof(Sflong_t)))
+				goto bail;
+			n = xp[-1] << n;
+			*--xp = n;
+			break;
+		    case A_RSHIFT:
+			if(n<0 || n>=(Sflong_t)(8*sizeof(Sflong_t)))
+				goto bail;
+			n = xp[-1] >> n;
+			*--xp = n;
+			break;
+		    case A_AND:
+			n = xp[-1] & n;
+			*--xp = n;
+			break;
+		    case A_OR:
+			n = xp[-1] | n;
+			*--xp = n;
+			break;
+		    case A_XOR:
+			n = xp[-1] ^ n;
+			*--xp = n;
+			break;
+		    case A_EQ:
+			n = (xp[-1]==n);
+			*--xp = n;
+			break;
+		    case A_NEQ:
+			n = (xp[-1]!=n);
+			*--xp = n;
+			break;
+		    case A_LT:
+			n = (xp[-1]<n);
+			*--xp = n;
+			break;
+		    case A_LE:
+			n = (xp[-1]<=n);
+			*--xp = n;
+			break;
+		    case A_GT:
+			n = (xp[-1]>n);
+			*--xp = n;
+			break;
+		    case A_GE:
+			n = (xp[-1]>=n);
+			*--xp = n;
+			break;
+		}
+		ip++;
+	}
+	*np = n;
+	return(0);
+bail:
+	/* ++ and -- restart at the push of their lvalue */
+	switch(ip->op)
+	{
+	    case A_INCR: case A_DECR: case A_PLUSPLUS: case A_MINUSMINUS:
+		xp--;
+	}
+	*cpp = ep->code + ip->pc;
+	*np = n;
+	for(i=0; stack+i <= xp; i++)
+	{
+		sp[i+1] = stack[i];
+		tp[i+1] = 0;
+	}
+	return(i);
+#undef iget
+#undef iput
+}
+
 Sfdouble_t	arith_exec(Arith_t *ep)
 {
 	register Sfdouble_t num=0,*dp,*sp;
@@ -184,6 +416,25 @@ Sfdouble_t	arith_exec(Arith_t *ep)
 		sp = (Sfdouble_t*)stakalloc(ep->staksize*(sizeof(Sfdouble_t)+1));
 	tp = (char*)(sp+ep->staksize);
 	tp--,sp--;
+	if(ep->icode)
+	{
+		Sfdouble_t	d;
+		unsigned char	*pc;
+		if((c=intexec(ep,sp,tp,&d,&pc))==0)
+		{
+			if(level>0)
+				level--;
+			return(d);
+		}
+		if(c>0)
+		{
+			num = d;
+			cp = pc;
+			sp += c;
+			tp += c;
+			lastsub = 0;
+		}
+	}
 	while(c = *cp++)
 	{
 		if(c&T_NOFLOAT)
@@ -897,11 +1148,139 @@ again:
 	return(1);
 }
 
+/*
+ * compile the integer program for the code on the stak that ends at offset
+ * the integer program is appended to the stak and its offset returned
+ * 0 is returned if the code has floating point literals, function calls,
+ * subscripts, or operators with no integer op
+ */
+static int intcomp(const char *string, int offset, short *nop, short *nvar)
+{
+	unsigned char	*base = (unsigned char*)stakptr(0);
+	unsigned char	*code = base+sizeof(Arith_t);
+	unsigned char	*cp = code;
+	Arith_iop_t	iop[ICODE_OPS], *ip;
+	Arith_ivar_t	ivar[ICODE_VARS], *vp;
+	short		map[ICODE_SIZE];
+	Sfdouble_t	d;
+	char		*value;
+	int		c, i, n=0, nv=0, last= -1, lastpc=0, len=strlen(string);
+	if(offset-sizeof(Arith_t) > ICODE_SIZE)
+		return(0);
+	while(c = *cp)
+	{
+		if(n>=ICODE_OPS)
+			return(0);
+		ip = &iop[n];
+		ip->pc = cp-code;
+		ip->op = c&T_OP;
+		ip->arg = 0;
+		ip->num = 0;
+		map[cp-code] = n++;
+		cp++;
+		switch(c&T_OP)
+		{
+		    case A_JMP: case A_JMPZ: case A_JMPNZ:
+			cp = roundptr(base,cp,short);
+			ip->arg = *((short*)cp) - sizeof(Arith_t);
+			cp += sizeof(short);
+			break;
+		    case A_ENUM:
+			n--;
+			break;
+		    case A_ASSIGNOP1:
+			ip->op = A_PUSHV;
+			/* FALL THRU */
+		    case A_PUSHV: case A_STORE: case A_ASSIGNOP:
+			cp = roundptr(base,cp,Sfdouble_t*);
+			value = *((char**)cp);
+			cp += sizeof(Sfdouble_t*);
+			c = *(short*)cp;
+			cp += sizeof(short);
+			if(value>=string && value<string+len)
+			{
+				if(c<=0 || memchr(value,'[',c) || value[c]=='[' || value[c] && value[c+1]=='[')
+					return(0);
+			}
+			else if(c)
+				return(0);
+			for(vp=ivar; vp < &ivar[nv]; vp++)
+			{
+				if(vp->value==value && vp->flag==c)
+					break;
+				if(vp->flag==c && c>0 && vp->value>=string && vp->value<string+len && value>=string && value<string+len && memcmp(vp->value,value,c)==0)
+					break;
+			}
+			if(vp == &ivar[nv])
+			{
+				if(nv>=ICODE_VARS)
+					return(0);
+				vp->value = value;
+				vp->flag = c;
+				vp->store = 0;
+				nv++;
+			}
+			ip->arg = vp-ivar;
+			if(ip->op==A_PUSHV)
+			{
+				last = ip->arg;
+				lastpc = ip->pc;
+			}
+			else
+			{
+				ip->op = A_STORE;
+				vp->store = 1;
+			}
+			break;
+		    case A_INCR: case A_DECR: case A_PLUSPLUS: case A_MINUSMINUS:
+			if(last<0 || n<2 || iop[n-2].op!=A_PUSHV)
+				return(0);
+			ip->arg = last;
+			ip->pc = lastpc;
+			ivar[last].store = 1;
+			break;
+		    case A_PUSHN:
+			cp = roundptr(base,cp,Sfdouble_t);
+			d = *((Sfdouble_t*)cp);
+			cp += sizeof(Sfdouble_t);
+			if(*cp++ || d <= LDBL_LLONG_MIN || d >= LDBL_LLONG_MAX || (Sflong_t)d != d)
+				return(0);
+			ip->num = (Sflong_t)d;
+			break;
+		    case A_POP: case A_NOTNOT: case A_NOT: case A_TILDE: case A_UMINUS:
+		    case A_PLUS: case A_MINUS: case A_TIMES: case A_DIV: case A_MOD:
+		    case A_LSHIFT: case A_RSHIFT: case A_AND: case A_OR: case A_XOR:
+		    case A_EQ: case A_NEQ: case A_LT: case A_LE: case A_GT: case A_GE:
+			break;
+		    default:
+			return(0);
+		}
+	}
+	if(n==0)
+		return(0);
+	map[cp-code] = n;
+	for(i=0; i < n; i++)
+	{
+		ip = &iop[i];
+		if(ip->op==A_JMP || ip->op==A_JMPZ || ip->op==A_JMPNZ)
+			ip->arg = map[ip->arg];
+	}
+	offset = round(offset,pow2size(sizeof(Sflong_t)));
+	stakseek(offset+n*sizeof(Arith_iop_t)+nv*sizeof(Arith_ivar_t));
+	base = (unsigned char*)stakptr(offset);
+	memcpy(base,iop,n*sizeof(Arith_iop_t));
+	memcpy(base+n*sizeof(Arith_iop_t),ivar,nv*sizeof(Arith_ivar_t));
+	*nop = n;
+	*nvar = nv;
+	return(offset);
+}
+
 Arith_t *arith_compile(Shell_t *shp,const char *string,char **last,Sfdouble_t(*fun)(const char**,struct lval*,int,Sfdouble_t),int emode)
 {
 	struct vars cur;
 	register Arith_t *ep;
-	int offset;
+	int offset, ioffset=0;
+	short isize, nivar;
 	memset((void*)&cur,0,sizeof(cur));
 	cur.shp = shp;
      	cur.expr = cur.nextchr = string;
@@ -924,7 +1303,19 @@ Arith_t *arith_compile(Shell_t *shp,const char *string,char **last,Sfdouble_t(*f
 	}
 	stakputc(0);
 	offset = staktell();
+	if((emode&ARITH_COMP) && !cur.errmsg.value)
+		ioffset = intcomp(string,offset,&isize,&nivar);
 	ep = (Arith_t*)stakfreeze(0);
+	ep->icode = 0;
+	ep->ivar = 0;
+	ep->isize = ep->nivar = 0;
+	if(ioffset)
+	{
+		ep->icode = (Arith_iop_t*)((char*)ep+ioffset);
+		ep->ivar = (Arith_ivar_t*)(ep->icode+isize);
+		ep->isize = isize;
+		ep->nivar = nivar;
+	}
 	ep->shp = shp;
 	ep->expr = string;
 	ep->elen = strlen(string);
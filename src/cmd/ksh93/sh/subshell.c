@@ -190,6 +190,7 @@ void sh_subfork(void)
 		sh_subtmpfile(shp);
 	shp->curenv = 0;
 	shp->savesig = -1;
+	sh_stats(STAT_SUBFORK);
 	if(pid = sh_fork(shp,FSHOWME,NIL(int*)))
 	{
 		shp->curenv = curenv;
@@ -180,6 +180,193 @@ static void iounpipe(Shell_t *shp)
 	usepipe = 0;
 }
 
+/*
+ * The following functions run the elements of a pipeline one after the
+ * other in the current process.  This is only done when each element
+ * other than the last is known to finish:
+ * the first element must be a built-in whose output is bounded by its
+ * arguments and the others built-in filters that read only standard input.
+ * Outside of a command substitution the last element must also be a
+ * built-in and the shell must not be interactive.
+ * The output of each element is kept in a temp file or pipe that
+ * becomes the standard input of the next element.
+ */
+
+static const char	*pipe_source[] =
+{
+	"echo", "false", "print", "printf", "true", 0
+};
+
+static const char	*pipe_filter[] =
+{
+	"cat", "cksum", "cut", "fmt", "fold", "head", "md5sum",
+	"paste", "rev", "sum", "tee", "uniq", "wc", 0
+};
+
+/*
+ * return the built-in node for simple command <t>
+ * if <names> is not null the command name must be one of <names>
+ * only built-ins bound by name or by a tracked alias are found
+ * so that no PATH search or function autoload is done here
+ */
+static Namval_t *pipe_cmd(Shell_t *shp, register const Shnode_t *t, const char **names)
+{
+	register Namval_t	*np;
+	char			*name;
+	if((t->tre.tretyp&COMMSK)!=TCOM || !t->com.comarg)
+		return(0);
+	if(np = (Namval_t*)t->com.comnamp)
+		name = nv_name(np);
+	else if(t->com.comtyp&COMSCAN)
+	{
+		if(!(t->com.comarg->argflag&ARG_RAW))
+			return(0);
+		name = t->com.comarg->argval;
+	}
+	else
+		name = ((struct dolnod*)t->com.comarg)->dolval[ARG_SPARE];
+	if(names)
+	{
+		char	*base = path_basename(name);
+		while(*names && strcmp(*names,base))
+			names++;
+		if(!*names)
+			return(0);
+	}
+	if(!np)
+	{
+		if(strchr(name,'/'))
+			np = nv_search(name,shp->bltin_tree,0);
+		else if(np=nv_search(name,shp->fun_tree,0))
+		{
+			if(!is_abuiltin(np))
+				return(0);
+		}
+		else if((np=nv_search(name,shp->track_tree,0)) && !nv_isattr(np,NV_NOALIAS) && np->nvalue.cp)
+			np = nv_search(nv_getval(np),shp->bltin_tree,0);
+		else
+			np = 0;
+	}
+	if(!np || !is_abuiltin(np) || np==SYSCOMMAND)
+		return(0);
+	/* special and declaration built-ins change the shell environment */
+	if(nv_isattr(np,BLT_SPC|BLT_DCL))
+		return(0);
+	return(np);
+}
+
+/*
+ * return 1 if built-in filter simple command <t> is known to finish
+ */
+static int pipe_bounded(register const Shnode_t *t)
+{
+	register struct argnod	*ap;
+	register char		**argv;
+	if(t->com.comio)
+		return(0);
+	/* operands could name files or devices that never end */
+	if(t->com.comtyp&COMSCAN)
+	{
+		for(ap=t->com.comarg->argnxt.ap; ap; ap=ap->argnxt.ap)
+		{
+			if(!(ap->argflag&ARG_RAW) || *ap->argval!='-' || strcmp(ap->argval,"--")==0)
+				return(0);
+		}
+	}
+	else for(argv=((struct dolnod*)t->com.comarg)->dolval+ARG_SPARE+1; *argv; argv++)
+	{
+		if(**argv!='-' || strcmp(*argv,"--")==0)
+			return(0);
+	}
+	return(1);
+}
+
+static int pipe_nofork(Shell_t *shp, register const Shnode_t *t)
+{
+	register Shnode_t	*tp;
+	int			all = 0;
+	int			first = 1;
+	if(t->tre.tretyp&FSHOWME)
+		return(0);
+#if SHOPT_COSHELL
+	if(shp->coshell)
+		return(0);
+#endif /* SHOPT_COSHELL */
+	if(!shp->comsub || !shp->subshell)
+	{
+		if(sh_isstate(SH_INTERACTIVE) || sh_isstate(SH_MONITOR) || job.jobcontrol)
+			return(0);
+		all = 1;
+	}
+	for(; (t->tre.tretyp&COMMSK)==TFIL; t=t->lst.lstrit, first=0)
+	{
+		tp = t->lst.lstlef;
+		if((tp->tre.tretyp&(COMMSK|FAMP|FCOOP|FALTPIPE))!=TFORK || tp->fork.forkio)
+			return(0);
+		if(first)
+		{
+			if(!pipe_cmd(shp,tp->fork.forktre,pipe_source) || tp->fork.forktre->com.comio)
+				return(0);
+		}
+		else if(!pipe_cmd(shp,tp->fork.forktre,pipe_filter) || !pipe_bounded(tp->fork.forktre))
+			return(0);
+	}
+	if(all && ((t->tre.tretyp&COMMSK)!=TSETIO || !pipe_cmd(shp,t->fork.forktre,NIL(const char**))))
+		return(0);
+	return(1);
+}
+
+/*
+ * run pipeline element <t> in a virtual subshell
+ * <pv>[0] is set to a file descriptor open for reading its output
+ */
+static void pipe_exec(Shell_t *shp, const Shnode_t *t, int pv[], int flags)
+{
+	Sfio_t		*iop;
+	int		fd, jmpval;
+	ssize_t		n;
+	char		*cp;
+	struct checkpt	*buffp = (struct checkpt*)stkalloc(shp->stk,sizeof(struct checkpt));
+	sh_pushcontext(shp,buffp,SH_JMPIO);
+	if(t->tre.tretyp&FPIN)
+	{
+		sh_iosave(shp,0,shp->topfd,(char*)0);
+		sh_iorenumber(shp,shp->inpipe[0],0);
+	}
+	pv[0] = pv[1] = -1;
+	jmpval = sigsetjmp(buffp->buff,0);
+	if(jmpval==0)
+	{
+		sh_stats(STAT_PIPENOFORK);
+		iop = sh_subshell(shp,t->fork.forktre,flags,1);
+		if(job.exitval)
+			*job.exitval++ = shp->exitval;
+		if((fd=sffileno(iop)) >= 0)
+		{
+			sfsync(iop);
+			if((fd = sh_fcntl(fd,F_DUPFD,10)) < 0)
+				errormsg(SH_DICT,ERROR_system(1),e_toomany);
+			lseek(fd,(off_t)0,SEEK_SET);
+			pv[0] = fd;
+		}
+		else
+		{
+			sh_pipe(pv);
+			if((n = sfseek(iop,(Sfoff_t)0,SEEK_END)) > 0 && sfseek(iop,(Sfoff_t)0,SEEK_SET)==0 && (cp = (char*)sfreserve(iop,n,0)))
+				write(pv[1],cp,n);
+			sh_close(pv[1]);
+			pv[1] = -1;
+		}
+		fcntl(pv[0],F_SETFD,FD_CLOEXEC);
+		shp->fdstatus[pv[0]] = (shp->fdstatus[pv[0]]&~IOWRITE)|IOREAD|IOCLEX;
+		sfclose(iop);
+	}
+	sh_popcontext(shp,buffp);
+	sh_iorestore(shp,buffp->topfd,jmpval);
+	if(jmpval>SH_JMPIO)
+		siglongjmp(*shp->jmplist,jmpval);
+}
+
 /*
  * print time <t> in h:m:s format with precision <p>
  */
@@ -575,11 +762,13 @@ int sh_eval(register Sfio_t *iop, int mode)
 	struct checkpt *buffp = (struct checkpt*)stkalloc(shp->stk,sizeof(struct checkpt));
 	static Sfio_t *io_save;
 	volatile int traceon=0, lineno=0;
+	void *volatile cache = shp->cache;
 	int binscript=shp->binscript;
 	char comsub = shp->comsub;
 	io_save = iop; /* preserve correct value across longjmp */
 	shp->binscript = 0;
 	shp->comsub = 0;
+	shp->cache = 0;
 #define SH_TOPFUN	0x8000	/* this is a temporary tksh hack */
 	if (mode & SH_TOPFUN)
 	{
@@ -598,12 +787,19 @@ int sh_eval(register Sfio_t *iop, int mode)
 				sh_offoption(SH_XTRACE);
 		}
 		t = (Shnode_t*)sh_parse(shp,iop,(mode&(SH_READEVAL|SH_FUNEVAL))?mode&SH_FUNEVAL:SH_NL);
+		if(cache)
+			sh_cachedump(shp,cache,t);
 		if(!(mode&SH_FUNEVAL) || !sfreserve(iop,0,0))
 		{
 			if(!(mode&SH_READEVAL))
 				sfclose(iop);
 			io_save = 0;
 			mode &= ~SH_FUNEVAL;
+			if(cache)
+			{
+				sh_cacheclose(shp,cache,1);
+				cache = 0;
+			}
 		}
 		mode &= ~SH_READEVAL;
 		if(!sh_isoption(SH_VERBOSE))
@@ -618,6 +814,8 @@ int sh_eval(register Sfio_t *iop, int mode)
 			break;
 	}
 	sh_popcontext(shp,buffp);
+	if(cache)
+		sh_cacheclose(shp,cache,0);
 	shp->binscript = binscript;
 	shp->comsub = comsub;
 	if(traceon)
@@ -2034,6 +2232,7 @@ int sh_exec(register const Shnode_t *t, int flags)
 			int	n,waitall,savewaitall=job.waitall;
 			int	savejobid = job.curjobid;
 			int	*exitval=0,*saveexitval = job.exitval;
+			int	nofork;
 			pid_t	savepgid = job.curpgid;
 #if SHOPT_COSHELL
 			int	copipe=0;
@@ -2058,7 +2257,8 @@ int sh_exec(register const Shnode_t *t, int flags)
 			pvo[2] = pvn[2] = 0;
 #endif /* SHOPT_COSHELL */
 			job.curjobid = 0;
-			if(shp->subshell)
+			nofork = pipe_nofork(shp,t);
+			if(shp->subshell && !nofork)
 			{
 				sh_subtmpfile(shp);
 				if(shp->comsub==1 && !(shp->fdstatus[1]&IONOSEEK))
@@ -2115,6 +2315,16 @@ int sh_exec(register const Shnode_t *t, int flags)
 					}
 				}
 #endif /* SHOPT_COSHELL */
+				if(nofork)
+				{
+					/* run out part of pipe to completion */
+					pipe_exec(shp,t->lst.lstlef,pvn,errorflg);
+					type = 0;
+					pipejob = 1;
+					pvo[0] = pvn[0];
+					t = t->lst.lstrit;
+					continue;
+				}
 				sh_pipe(pvn);
 #if SHOPT_COSHELL
 				pvn[2] = 0;
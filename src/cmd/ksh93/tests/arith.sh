@@ -762,4 +762,36 @@ x=0x1.0000000000000000000000000000p+6
 v=$(printf $'%.28a\n' 64)
 [[ $v == "$x" ]] || err_exit "'printf %.28a 64' failed -- expected '$x', got '$v'"
 
+# integer expressions run on Sflong_t and fall back on overflow
+unset i n s x y z
+typeset -li i n=1000 s=0
+for ((i=0; i < n; i++))
+do	(( s += i*3 % 7 - (i & 1) ))
+done
+(( s == 2499 )) || err_exit "integer loop sum is $s, should be 2499"
+typeset -li x=9223372036854775807 y
+(( y = x + 1 ))
+[[ $y == -9223372036854775808 ]] || err_exit "typeset -li overflow is $y, should be -9223372036854775808"
+[[ $(( x + x )) == 1.84467440737095516e+19 ]] || err_exit "overflow should fall back to floating point -- got $(( x + x ))"
+typeset -i z=2147483647
+(( z++ ))
+(( z == -2147483648 )) || err_exit "typeset -i should wrap to 32 bits -- got $z"
+(( z = 5, z <<= 3, z |= 1, z /= 2 ))
+(( z == 20 )) || err_exit "integer assignment operators fail -- got $z"
+(( y = -x, y-- , y-- ))
+[[ $y == -9223372036854775808 ]] || err_exit "typeset -li decrement overflow is $y"
+(( y = 7 ))
+( (( y = 9 )) )
+(( y == 7 )) || err_exit "integer assignment in subshell not restored -- got $y"
+[[ $( (( y = 11 )); print $y) == 11 ]] || err_exit 'integer assignment in command substitution fails'
+(( y == 7 )) || err_exit "integer assignment in command substitution not restored -- got $y"
+typeset -ri r=3
+( (( r = 1 )) ) 2> /dev/null && err_exit 'integer assignment to readonly variable should fail'
+unset x
+typeset -i x=0
+float f=2.5
+(( x = x + f*2 ))
+(( x == 5 )) || err_exit "integer assignment from float expression is $x, should be 5"
+( (( x / 0 )) ) 2> /dev/null && err_exit 'integer division by zero should fail'
+
 exit $((Errors<125?Errors:125))
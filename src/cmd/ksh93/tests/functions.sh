@@ -1207,4 +1207,31 @@ rc=$?
 exp=$((256+$(kill -l TERM) ))
 [[  $rc == "$exp" ]] || err_exit "expected exitval $exp got $rc"
 
+# compiled script cache
+mkdir $tmp/cachefun
+cat > $tmp/cachefun/cachefn <<- \!
+	function cachefn { print -r -- "cachefn $1 $LINENO"; }
+!
+cat > $tmp/cached.ksh <<- \!!
+	cat <<- !
+		here $1
+	!
+	print -r -- "line $LINENO"
+!!
+cmd=". $tmp/cached.ksh doc; FPATH=$tmp/cachefun; cachefn arg; print \${.sh.stats.src_cachehits} \${.sh.stats.src_cachewrites}"
+exp=$'here doc\nline 4\ncachefn arg 1'
+got=$(SHCACHE=$tmp/cache $SHELL -c "$cmd" 2>&1)
+[[ $got == "$exp"$'\n0 2' ]] || err_exit "uncached scripts wrong -- expected $(printf %q "$exp"$'\n0 2'), got $(printf %q "$got")"
+got=$(SHCACHE=$tmp/cache $SHELL -c "$cmd" 2>&1)
+[[ $got == "$exp"$'\n2 0' ]] || err_exit "cached scripts wrong -- expected $(printf %q "$exp"$'\n2 0'), got $(printf %q "$got")"
+print 'print -r -- changed' >> $tmp/cached.ksh
+got=$(SHCACHE=$tmp/cache $SHELL -c "$cmd" 2>&1)
+[[ $got == "${exp%$'\n'*}"$'\nchanged\ncachefn arg 1\n1 1' ]] || err_exit "changed script not recompiled -- got $(printf %q "$got")"
+got=$(SHCACHE=$tmp/cache $SHELL -c "alias print='print -r -- alias'; . $tmp/cached.ksh doc; print \${.sh.stats.src_cachehits}" 2>&1)
+[[ $got == *'alias -r -- line 4'*$'\n0' ]] || err_exit "cached script used after alias change -- got $(printf %q "$got")"
+print 'if then' > $tmp/cachebad.ksh
+SHCACHE=$tmp/cache $SHELL -c ". $tmp/cachebad.ksh" 2> /dev/null
+got=$(SHCACHE=$tmp/cache $SHELL -c ". $tmp/cachebad.ksh; print \${.sh.stats.src_cachehits}" 2> /dev/null)
+[[ $got == 0 ]] || err_exit "script with syntax error cached"
+
 exit $((Errors<125?Errors:125))
@@ -391,5 +391,38 @@ ${.sh.version}
 END
 ) || err_exit '${.sh.xxx} variables causes cat not be found'
 
+# PATH directory snapshots
+mkdir $tmp/snap1 $tmp/snap2
+print 'print snap2' > $tmp/snap2/snapcmd
+chmod +x $tmp/snap2/snapcmd
+touch -t 200001010000 $tmp/snap1 $tmp/snap2
+got=$($SHELL -c "
+	PATH=$tmp/snap1:$tmp/snap2:/bin:/usr/bin
+	snapcmd
+	hash -s
+	whence -q nosuchcommand
+	hash -s
+	print 'print snap1' > $tmp/snap1/snapcmd
+	chmod +x $tmp/snap1/snapcmd
+	touch -t 200101010000 $tmp/snap1
+	PATH=\$PATH
+	snapcmd
+" 2>&1)
+[[ $got == snap2$'\n'*$'\nsnap1' ]] || err_exit "PATH directory snapshots out of date -- got $(printf %q "$got")"
+print -r -- "$got" | { read; IFS=" " read -r dirs reads checks hits1 misses1; IFS=" " read -r dirs reads checks hits2 misses2; }
+[[ $misses1 == misses=* && $misses1 == "$misses2" ]] || err_exit "PATH search miss not answered from snapshots -- got $(printf %q "$got")"
+[[ $hits1 != "$hits2" ]] || err_exit "PATH search miss does not count snapshot hits -- got $(printf %q "$got")"
+mkdir $tmp/snap3
+touch -t 200001010000 $tmp/snap3
+got=$($SHELL -c "
+	PATH=$tmp/snap3:/bin:/usr/bin
+	newcmd
+	print 'print found' > $tmp/snap3/newcmd
+	chmod +x $tmp/snap3/newcmd
+	newcmd
+	exit
+" 2>/dev/null)
+[[ $got == found ]] || err_exit "command added in the same second as the PATH directory snapshot not found -- got $(printf %q "$got")"
+
 exit $((Errors<125?Errors:125))
 
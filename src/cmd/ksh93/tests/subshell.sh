@@ -617,4 +617,67 @@ do	if	[[ -e $f ]]
 	fi
 done
 
+# pipelines of built-ins and functions in command substitution
+got=$($SHELL -c '
+	builtin cat cut wc
+	x=$(printf "%s\n" a:1 b:1 | cut -d: -f2 | cat)
+	y=$(printf "%s\n" {1..5000} | cat | wc -l)
+	z=$(false | cat; print $?)
+	set -o pipefail
+	z+=$(false | cat; print $?)
+	v=1
+	w=$(v=2 | cat; print $v)
+	print -r -- $x $y $z $w ${.sh.stats.pipe_noforks}' 2>&1)
+[[ $got == '1 1 5000 01 1 6' ]] || err_exit "built-in pipeline in command substitution wrong -- expected '1 1 5000 01 1 6', got '$got'"
+got=$(print -r -- 'abc' | $SHELL -c 'builtin cat cut; x=$(cat | cut -c2); print -r -- $x' 2>&1)
+[[ $got == b ]] || err_exit "built-in pipeline in command substitution does not read standard input -- got '$got'"
+mkdir $tmp/pipefun
+print 'function cut { print fun; }' > $tmp/pipefun/cut
+got=$($SHELL -c '
+	PATH='"$tmp"'/pipefun FPATH='"$tmp"'/pipefun
+	print a | cut | read x
+	typeset -f cut > /dev/null && print -n "loaded "
+	print -r -- $x' 2>&1)
+[[ $got == fun ]] || err_exit "pipeline autoloads a function in the parent shell -- expected 'fun', got '$got'"
+got=$($SHELL -c '
+	hash -s
+	x=$(tr a b < /dev/null | true)
+	hash -s' 2>&1)
+[[ $got == *$'\n'* && ${got%%$'\n'*} == "${got#*$'\n'}" ]] || err_exit "command substitution pipeline searches PATH in the parent shell -- got $(printf %q "$got")"
+$SHELL -c '
+	builtin cat head wc
+	function f { while :; do print y; done; }
+	x=$(f | head -n 1)
+	y=$(cat /dev/zero | head -c 5 | wc -c)
+	z=$(print y | cat /dev/zero | head -c 5 | wc -c)
+	print -r -- $x $y $z' > $tmp/pipe.out 2>&1 &
+pid=$!
+{ sleep 10; kill -KILL $pid; } 2> /dev/null &
+spy=$!
+wait $pid 2> /dev/null
+kill $spy 2> /dev/null
+got=$(< $tmp/pipe.out)
+[[ $got == 'y 5 5' ]] || err_exit "command substitution pipeline with endless producer wrong or hangs -- expected 'y 5 5', got '$got'"
+got=$($SHELL -c '
+	builtin cat cut head
+	print -r -- a:1 b:2 c:3 > '"$tmp"'/pipe.in
+	printf "%s\n" a:1 b:2 c:3 | cut -d: -f2 | head -c 1
+	false | cat
+	cat '"$tmp"'/pipe.in | head -c 1
+	print -r -- " $? ${.sh.stats.pipe_noforks}"' 2>&1)
+[[ $got == '1a 0 3' ]] || err_exit "built-in pipeline wrong -- expected '1a 0 3', got '$got'"
+$SHELL -c '
+	builtin cat head wc
+	cat /dev/zero | head -c 5 | wc -c
+	print y | cat /dev/zero | head -c 5 | wc -c
+	print -r -- done' > $tmp/pipe.out 2>&1 &
+pid=$!
+{ sleep 10; kill -KILL $pid; } 2> /dev/null &
+spy=$!
+wait $pid 2> /dev/null
+kill $spy 2> /dev/null
+got=$(< $tmp/pipe.out)
+got=${got//' '/}
+[[ $got == $'5\n5\ndone' ]] || err_exit "built-in pipeline with endless producer wrong or hangs -- got $(printf %q "$got")"
+
 exit $((Errors<125?Errors:125))
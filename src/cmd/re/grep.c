@@ -107,6 +107,8 @@ USAGE_LICENSE
 #define EISDIR		(-1)
 #endif
 
+#define MANY		4	/* more -e patterns use a set	*/
+
 /*
  * snarfed from Doug McElroy's C++ version
  *
@@ -117,7 +119,10 @@ USAGE_LICENSE
  * 2. grep allows null expressions, hence REG_NULL.
  * 3. it may be possible to combine the multiple 
  * patterns of grep into single patterns.  important
- * special cases are handled by regcomb().
+ * special cases are handled by regcomb().  patterns from
+ * -f files, or more than MANY -e patterns, may number in the
+ * thousands; they are kept separate and matched in one pass
+ * by regsetexec().
  * 4. anchoring by -x has to be done separately from
  * compilation (remember that fgrep has no ^ or $ operator),
  * hence REG_LEFT|REG_RIGHT.  (An honest, but slow alternative:
@@ -153,6 +158,11 @@ static struct State_s			/* program state		*/
 	List_t		pattern;	/* pattern list			*/
 	List_t		re;		/* re list			*/
 
+	regset_t*	set;		/* many pattern set		*/
+	Item_t**	vec;		/* set index to re list item	*/
+	size_t*		index;		/* regsetexec() match indices	*/
+	size_t		nvec;		/* # set items			*/
+
 	regmatch_t	posvec[1];	/* match position vector	*/
 	regmatch_t*	pos;		/* match position pointer	*/
 	int		posnum;		/* number of match positions	*/
@@ -169,6 +179,7 @@ static struct State_s			/* program state		*/
 	unsigned char	byline;		/* multiple pattern line by line*/
 	unsigned char	count;		/* count number of hits		*/
 	unsigned char	label;		/* all patterns labeled		*/
+	unsigned char	many;		/* many patterns -- use a set	*/
 	unsigned char	match;		/* match sense			*/
 	unsigned char	query;		/* return status but no output	*/
 	unsigned char	number;		/* line numbers			*/
@@ -219,13 +230,15 @@ addre(List_t* p, char* s)
 		regfatal(&x->re, 4, c);
 	if (t)
 		sfstrclose(t);
+	if (state.many && regsetadd(state.set, &x->re))
+		error(ERROR_SYSTEM|3, "out of space (pattern `%s')", b);
 	if (!p->head)
 	{
 		p->head = p->tail = x;
 		if (state.number || state.before || state.after || !regrecord(&x->re))
 			state.byline = 1;
 	}
-	else if (state.label || regcomb(&p->tail->re, &x->re))
+	else if (state.many || state.label || regcomb(&p->tail->re, &x->re))
 	{
 		p->tail = p->tail->next = x;
 		if (!state.byline && (state.number || !state.label || !regrecord(&x->re)))
@@ -256,11 +269,18 @@ compile(void)
 	int	line;
 	size_t	n;
 	char*	s;
-	char*	t;
 	char*	file;
 	Item_t*	x;
 	Sfio_t*	f;
 
+	for (n = 0, x = state.pattern.head; x; x = x->next)
+		n++;
+	if (state.file.head || n > MANY)
+	{
+		if (!(state.set = regsetopen(NiL)))
+			error(ERROR_SYSTEM|3, "out of space (pattern set)");
+		state.many = state.byline = 1;
+	}
 	for (x = state.pattern.head; x; x = x->next)
 		addre(&state.re, x->string);
 	for (x = state.file.head; x; x = x->next)
@@ -274,25 +294,6 @@ compile(void)
 			error_info.file = s;
 			line = error_info.line;
 			error_info.line = 0;
-			while (s = (char*)sfreserve(f, SF_UNBOUND, SF_LOCKR))
-			{
-				if (!(n = sfvalue(f)))
-					break;
-				if (s[n - 1] != '\n')
-				{
-					for (t = s + n; t > s && *--t != '\n'; t--);
-					if (t == s)
-					{
-						sfread(f, s, 0);
-						break;
-					}
-					n = t - s + 1;
-				}
-				s[n - 1] = 0;
-				addre(&state.re, s);
-				s[n - 1] = '\n';
-				sfread(f, s, n);
-			}
 			while ((s = sfgetr(f, '\n', 1)) || (s = sfgetr(f, '\n', -1)))
 			{
 				error_info.line++;
@@ -305,6 +306,15 @@ compile(void)
 	}
 	if (!state.re.head)
 		error(3, "no pattern");
+	if (state.many)
+	{
+		for (n = 0, x = state.re.head; x; x = x->next)
+			n++;
+		if (!(state.vec = newof(0, Item_t*, n, 0)) || !(state.index = newof(0, size_t, n, 0)))
+			error(ERROR_SYSTEM|3, "out of space (pattern set)");
+		for (x = state.re.head; x; x = x->next)
+			state.vec[state.nvec++] = x;
+	}
 }
 
 static void
@@ -342,6 +352,37 @@ record(void* handle, const char* s, size_t len)
 	return 0;
 }
 
+/*
+ * return the matching set item with the leftmost, then longest, match
+ * in s and set state.pos to its position
+ */
+
+static Item_t*
+leftmost(char* s, size_t len, ssize_t m)
+{
+	Item_t*		x;
+	Item_t*		y = 0;
+	regmatch_t	pos;
+	ssize_t		i;
+	int		result;
+
+	for (i = 0; i < m; i++)
+	{
+		x = state.vec[state.index[i]];
+		if (!(result = regnexec(&x->re, s, len, 1, &pos, 0)))
+		{
+			if (!y || pos.rm_so < state.pos[0].rm_so || pos.rm_so == state.pos[0].rm_so && pos.rm_eo > state.pos[0].rm_eo)
+			{
+				y = x;
+				state.pos[0] = pos;
+			}
+		}
+		else if (result != REG_NOMATCH)
+			regfatal(&x->re, 4, result);
+	}
+	return y;
+}
+
 static void
 execute(Sfio_t* input, char* name)
 {
@@ -349,6 +390,8 @@ execute(Sfio_t* input, char* name)
 	char*		file;
 	Item_t*		x;
 	size_t		len;
+	ssize_t		i;
+	ssize_t		m;
 	int		result;
 	int		line;
 
@@ -385,10 +428,31 @@ execute(Sfio_t* input, char* name)
 					error(ERROR_SYSTEM|2, "read error");
 				break;
 			}
-			x = state.re.head;
-			do
+			if (state.set)
+			{
+				if ((m = regsetexec(state.set, s, len, (state.label || state.pos) ? state.nvec : 1, state.index, 0)) < 0)
+					error(ERROR_SYSTEM|3, "out of space");
+				i = 0;
+				if (!m)
+					x = 0;
+				else if (state.pos && !state.label)
+				{
+					/* the lowest matching index need not be the leftmost match */
+					x = leftmost(s, len, m);
+					i = m;
+				}
+				else
+					x = state.vec[state.index[i++]];
+			}
+			else
+				x = state.re.head;
+			for (; x; x = state.set ? (i < m ? state.vec[state.index[i++]] : 0) : x->next)
 			{
-				if (!(result = regnexec(&x->re, s, len, state.posnum, state.pos, 0)))
+				if (state.set)
+					result = state.pos && state.label ? regnexec(&x->re, s, len, state.posnum, state.pos, 0) : 0;
+				else
+					result = regnexec(&x->re, s, len, state.posnum, state.pos, 0);
+				if (!result)
 				{
 					if (!state.label)
 						break;
@@ -410,7 +474,7 @@ execute(Sfio_t* input, char* name)
 				}
 				else if (result != REG_NOMATCH)
 					regfatal(&x->re, 4, result);
-			} while (x = x->next);
+			}
 			if (!state.label && (x != 0) == state.match)
 			{
 				hits++;
@@ -6383,3 +6383,65 @@ TEST 16 'ast bm checks'
 	EXEC	-E '(ab$)'
 	EXEC	-E '(abcdef$)'
 	EXEC	'(abcdefghijklmnopqrstuvwxy$)'
+
+TEST 17 'pattern file sets'
+
+	DO	{ print -r -- $'abc\nx.z\n^h\nzz$' > set.dat ;}
+	EXEC	-f set.dat
+		INPUT - $'hello abc\nno\nxyzzy\nhabc zz\nzz top'
+		OUTPUT - $'hello abc\nxyzzy\nhabc zz'
+	EXEC	-E -f set.dat
+	EXEC	-c -f set.dat
+		OUTPUT - 3
+	EXEC	-n -f set.dat
+		OUTPUT - $'1:hello abc\n3:xyzzy\n4:habc zz'
+	EXEC	-v -f set.dat
+		OUTPUT - $'no\nzz top'
+	EXEC	-F -f set.dat
+		OUTPUT - $'hello abc\nhabc zz'
+	EXEC	-x -f set.dat
+		OUTPUT -
+		EXIT 1
+	EXEC	-e top -f set.dat
+		OUTPUT - $'hello abc\nxyzzy\nhabc zz\nzz top'
+		EXIT 0
+	DO	{ print -r -- $'a:abc\nb:x.z\nc:zz\nd:^h' > lab.dat ;}
+	EXEC	-m -f lab.dat
+		OUTPUT - $'a:hello abc\nd:hello abc\nb:xyzzy\nc:xyzzy\na:habc zz\nc:habc zz\nd:habc zz\nc:zz top'
+	EXEC	-m -c -f lab.dat
+		OUTPUT - $'a:2\nb:1\nc:3\nd:2'
+	DO	{ print -r -- $'b\na' > left.dat ;}
+	EXEC	-b -f left.dat
+		INPUT - $'xaxb\nbxa'
+		OUTPUT - $'x\E[1ma\E[0mxb\n\E[1mb\E[0mxa'
+
+TEST 18 'many -e patterns'
+
+	for op in '' -E -F
+	do
+
+	EXEC	$op -e one -e two -e three -e four -e five -e six
+		INPUT - $'zero\none\ntwo two\nthreefold\nfour\nten\nsix'
+		OUTPUT - $'one\ntwo two\nthreefold\nfour\nsix'
+		EXIT 0
+	EXEC	$op -c -e one -e two -e three -e four -e five -e six
+		OUTPUT - 5
+	EXEC	$op -v -e one -e two -e three -e four -e five -e six
+		OUTPUT - $'zero\nten'
+	EXEC	$op -x -e one -e two -e three -e four -e five -e six
+		OUTPUT - $'one\nfour\nsix'
+	EXEC	$op -n -e one -e two -e $'three\nfour' -e five -e six -e seven
+		OUTPUT - $'2:one\n3:two two\n4:threefold\n5:four\n7:six'
+	EXEC	$op -e one -e two -e three -e four -e five -e eight
+		OUTPUT - $'one\ntwo two\nthreefold\nfour'
+	EXEC	$op -e nine -e eleven -e twelve -e thirteen -e fourteen
+		OUTPUT -
+		EXIT 1
+
+	done
+
+	EXEC	-w -e one -e two -e three -e four -e five -e six
+		INPUT - $'zero\none\ntwo two\nthreefold\nfour\nten\nsix'
+		OUTPUT - $'one\ntwo two\nfour\nsix'
+		EXIT 0
+	EXEC	-E -w -e one -e two -e three -e four -e five -e six
@@ -0,0 +1,92 @@
+########################################################################
+#                                                                      #
+#               This software is part of the ast package               #
+#          Copyright (c) 1995-2012 AT&T Intellectual Property          #
+#                      and is licensed under the                       #
+#                 Eclipse Public License, Version 1.0                  #
+#                    by AT&T Intellectual Property                     #
+#                                                                      #
+#                A copy of the License is available at                 #
+#          http://www.eclipse.org/org/documents/epl-v10.html           #
+#         (with md5 checksum b35adb5213ca9657e911e9befb180842)         #
+#                                                                      #
+#              Information and Software Systems Research               #
+#                            AT&T Research                             #
+#                           Florham Park NJ                            #
+#                                                                      #
+#                 Glenn Fowler <gsf@research.att.com>                  #
+#                                                                      #
+########################################################################
+#
+# regex prefilter benchmark
+#
+#	ksh rebench.sh [ -l lines ] [ bindir ... ]
+#
+# generates a mail log like corpus and lists the grep and sed
+# elapsed seconds for each bindir (default: the grep and sed on
+# $PATH) on expressions with required chars and small first sets
+#
+
+lines=300000
+while	:
+do	case $1 in
+	-l)	lines=$2; shift 2 ;;
+	-l*)	lines=${1#-l}; shift ;;
+	*)	break ;;
+	esac
+done
+(( $# )) || set -- ''
+
+tmp=${TMPDIR:-/tmp}/rebench.$$
+trap 'rm -f $tmp' EXIT
+awk -v lines=$lines 'BEGIN {
+	srand(1)
+	split("alpha bravo charlie delta echo foxtrot golf hotel india juliet kilo lima mike", w, " ")
+	for (i = 0; i < lines; i++) {
+		s = ""
+		n = 4 + int(rand() * 8)
+		for (j = 0; j < n; j++) {
+			r = rand()
+			if (r < 0.02)
+				s = s " " w[1 + int(rand() * 13)] "@" w[1 + int(rand() * 13)] ".com"
+			else if (r < 0.10)
+				s = s " " int(rand() * 100000)
+			else
+				s = s " " w[1 + int(rand() * 13)]
+		}
+		print substr(s, 2)
+	}
+}' > $tmp
+
+typeset -a cmds=(
+	"grep -c		Q"
+	"grep -Ec		[a-z]+@[a-z]+"
+	"grep -Ec		(kilo|lima)[0-9]"
+	"grep -Ec		^[0-9]+ .*@"
+	"grep -ic		MIKE.*JULIET"
+	"sed -n -E	s/(a|b)[a-z]*@([a-z]+)/\\2/p"
+	"sed -n		/[0-9][0-9]*@/p"
+)
+
+TIMEFORMAT=%2R
+i=0
+for dir
+do	printf '%d\t%s\n' $((++i)) "${dir:-\$PATH}"
+done
+printf '\n%-40s' "$lines lines"
+i=0
+for dir
+do	printf ' %6d' $((++i))
+done
+printf '\n'
+for cmd in "${cmds[@]}"
+do	cmd=${cmd//+([	])/	}
+	arg=${cmd#*	}
+	cmd=${cmd%%	*}
+	printf '%-40s' "$cmd '$arg'"
+	for dir
+	do	t=$( { time ${dir:+$dir/}$cmd "$arg" $tmp > /dev/null 2>&1 ; } 2>&1 )
+		printf ' %6s' "$t"
+	done
+	printf '\n'
+done
@@ -37,7 +37,7 @@
  */
 
 static const char usage[] =
-"[-n?\n@(#)$Id: sort (AT&T Research) 2010-08-11 $\n]"
+"[-n?\n@(#)$Id: sort (AT&T Research) 2026-10-17 $\n]"
 USAGE_LICENSE
 "[+NAME?sort - sort and/or merge files]"
 "[+DESCRIPTION?\bsort\b sorts lines of all the \afiles\a together and "
@@ -131,9 +131,20 @@ USAGE_LICENSE
     "and exit with code \b1\b.]"
 "[C:silent-check?Like \b--check\b except no diagnostic is written.]"
 "[j:processes|nproc|jobs?Use up to \ajobs\a separate processes to sort "
-    "the input. The current implementation still uses one process for the "
-    "final merge phase; improvements are planned.]#[processes]"
+    "the input. Each process sorts a separate part of the input. The final "
+    "merge is then split into \ajobs\a key ranges, determined by sampling "
+    "the input keys, that are merged by separate processes and catenated "
+    "in order. A single final merge process is used if the input record "
+    "format cannot be sampled. If the input cannot be split between "
+    "processes, for example when it is a pipe, then the \bradix\b and "
+    "\brasp\b methods are replaced by the \bthread\b method with up to "
+    "\ajobs\a threads.]#[processes]"
 "[m:merge?Merge; the input files are already sorted.]"
+"[100:limit?Output only the first \arecords\a records of the sorted "
+    "output. The same records as \bsort | head -n\b \arecords\a are "
+    "listed, but space is proportional to \arecords\a and no intermediate "
+    "files are written. Not valid with \b--check\b, \b--merge\b or "
+    "\b-zc\b.]#[records]"
 "[u:unique?Unique. Keep only the first of multiple records that compare "
     "equal on all keys. Implies \b-s\b.]"
 "[s:stable?Stable sort. When all keys compare equal, preserve input "
@@ -178,10 +189,16 @@ USAGE_LICENSE
         "[+r?Maximum record size.]"
         "[+I?Decompress the input if it is compressed.]"
         "[+O?\bgzip\b(1) compress the output.]"
+        "[+T?\bgzip\b(1) compress intermediate files with compression "
+            "level \asize\a, from \b1\b (fastest, the default) to \b9\b "
+            "(smallest).]"
     "}"
 "[X:test?Enables implementation defined test code. Some or all of these "
     "may be disabled.]:[test]"
     "{"
+        "[+code?Time the key coder on the input records, list the "
+            "record, data and key byte counts and the elapsed microseconds, "
+            "and exit without sorting.]"
         "[+dump?List detailed information on the option settings.]"
         "[+io?List io file paths.]"
         "[+keys?List the canonical key for each record.]"
@@ -248,11 +265,13 @@ USAGE_LICENSE
 #include <wait.h>
 #include <iconv.h>
 #include <dlldefs.h>
+#include <tv.h>
 
 #define INMIN		(1024)		/* min input buffer size	*/
 #define INBRK		(64*INMIN)	/* default heap increment	*/
 #define INMAX		(1024*INBRK)	/* max input buffer size	*/
 #define INREC		(16*INMIN)	/* record begin chunk size	*/
+#define SAMPLE		64		/* key samples per partition	*/
 
 #define TEST_dump	0x80000000	/* dump the state before sort	*/
 #define TEST_io		0x40000000	/* dump io files		*/
@@ -260,6 +279,7 @@ USAGE_LICENSE
 #define TEST_read	0x10000000	/* force sfread()		*/
 #define TEST_show	0x08000000	/* show but don't do		*/
 #define TEST_reserve	0x04000000	/* force sfreserve()		*/
+#define TEST_code	0x02000000	/* time the key coder		*/
 
 #define pathstdin(s)	(!(s)||streq(s,"-")||streq(s,"/dev/stdin")||streq(s,"/dev/fd/0"))
 #define pathstdout(s)	(!(s)||streq(s,"-")||streq(s,"/dev/stdout")||streq(s,"/dev/fd/1"))
@@ -280,6 +300,12 @@ typedef struct Job_s
 	int		intermediates;	/* number of intermediate files	*/
 } Job_t;
 
+typedef struct Temp_s
+{
+	Rsdisc_t	disc;		/* recsort discipline		*/
+	int		level;		/* sfdcgzip compression level	*/
+} Temp_t;
+
 typedef struct Sort_s
 {
 	Rskeydisc_t	disc;		/* rskey discipline		*/
@@ -289,9 +315,13 @@ typedef struct Sort_s
 	Sfio_t*		tp;		/* TEST_keys tmp stream		*/
 	Sfio_t*		op;		/* output stream		*/
 	Job_t*		jobs;		/* multi-proc job table		*/
+	Rsobj_t*	split;		/* merge partition splitter keys*/
+	Sfio_t**	parts;		/* merge partition files	*/
+	Sfio_t**	part;		/* flush() partition files	*/
 	char*		overwrite;	/* -o input overwrite tmp file	*/
 	char*		buf;		/* input buffer			*/
 	Sfio_t*		opened;		/* fileopen() peek stream	*/
+	Temp_t		temp;		/* -zT intermediate discipline	*/
 	size_t		cur;		/* input buffer index		*/
 	size_t		hit;		/* input buffer index overflow	*/
 	size_t		end;		/* max input buffer index	*/
@@ -304,6 +334,10 @@ typedef struct Sort_s
 	int		map;		/* sfreserve() input		*/
 	int		mfiles;		/* multi-stage files[] count	*/
 	int		nfiles;		/* files[] count		*/
+	int		nparts;		/* number of merge partitions	*/
+	int		pbase;		/* child parts[] base index	*/
+	int		pend;		/* child parts[] end index	*/
+	int		pfiles;		/* parts[] files per partition	*/
 	int		xfiles;		/* max files[] count		*/
 	int		preserve;	/* rename() tmp output to input	*/
 	int		single;		/* one input file		*/
@@ -312,6 +346,41 @@ typedef struct Sort_s
 	Sfio_t*		files[OPEN_MAX > 68 ? 64 : (OPEN_MAX-4)];
 } Sort_t;
 
+/*
+ * -zT intermediate file compression
+ */
+
+static int
+temp(Rs_t* rs, int op, Void_t* data, Void_t* arg, Rsdisc_t* disc)
+{
+	Sfio_t*		fp = (Sfio_t*)data;
+
+	switch (op)
+	{
+	case RS_TEMP_WRITE:
+		sfset(fp, SF_READ, 0);
+		if (sfdcgzip(fp, ((Temp_t*)disc)->level|SFGZ_NOCRC|SFGZ_LAZY) <= 0)
+		{
+			error(2, "cannot push intermediate file gzip discipline");
+			return -1;
+		}
+		return 1;
+	case RS_TEMP_READ:
+		if (!sfdisc(fp, SF_POPDISC) || !sfset(fp, SF_READ, 1) || sfseek(fp, (Sfoff_t)0, SEEK_SET))
+		{
+			error(2, "cannot rewind intermediate file");
+			return -1;
+		}
+		if (sfsize(fp) > 0 && sfdcgzip(fp, SFGZ_NOCRC) <= 0)
+		{
+			error(2, "cannot push intermediate file gunzip discipline");
+			return -1;
+		}
+		return 1;
+	}
+	return 0;
+}
+
 /*
  * optget() info discipline function
  */
@@ -508,6 +577,14 @@ parse(register Sort_t* sp, char** argv)
 		case 'j':
 			key->nproc = opt_info.num;
 			continue;
+		case -100:
+			if (opt_info.number <= 0)
+			{
+				error(2, "%s: invalid record limit", opt_info.arg);
+				return -1;
+			}
+			key->disc->limit = opt_info.number;
+			continue;
 		case 'k':
 			if (rskey(key, opt_info.arg, 0))
 				return -1;
@@ -610,6 +687,14 @@ parse(register Sort_t* sp, char** argv)
 			case 'O':
 				sp->zip |= SF_WRITE;
 				break;
+			case 'T':
+				if (z > 9)
+				{
+					error(2, "%s %c%s: compression level must be 1..9", opt_info.option, n, s);
+					return -1;
+				}
+				sp->temp.level = z ? z : 1;
+				break;
 			}
 			continue;
 		case 'D':
@@ -656,7 +741,9 @@ parse(register Sort_t* sp, char** argv)
 			opt_info.num = strton(s, &e, NiL, 1);
 			if (*e)
 			{
-				if (streq(s, "dump"))
+				if (streq(s, "code"))
+					opt_info.num = TEST_code;
+				else if (streq(s, "dump"))
 					opt_info.num = TEST_dump;
 				else if (streq(s, "io"))
 					opt_info.num = TEST_io;
@@ -724,6 +811,22 @@ parse(register Sort_t* sp, char** argv)
 	}
 	key->input = argv;
 
+	/*
+	 * --limit selects the first records with a bounded heap
+	 * instead of sorting and merging everything
+	 */
+
+	if (key->disc->limit)
+	{
+		if (key->merge || key->meth == Rsverify || sp->chunk)
+		{
+			error(2, "--limit cannot be combined with --check, --merge or -zc");
+			return 1;
+		}
+		key->meth = Rslimit;
+		key->nproc = 1;
+	}
+
 	/*
 	 * disciplines have the opportunity to modify key info
 	 */
@@ -836,6 +939,89 @@ dumpkey(Rs_t* rs, unsigned char* dat, size_t datlen, unsigned char* key, size_t
 	return n;
 }
 
+/*
+ * time the key coder on the input records
+ */
+
+static int
+code(register Sort_t* sp)
+{
+	Rsdisc_t*	disc = sp->key->disc;
+	Sfio_t*		fp;
+	char*		s;
+	unsigned char*	buf;
+	unsigned char*	b;
+	unsigned char*	e;
+	unsigned char*	k;
+	ssize_t		n;
+	size_t		m;
+	size_t		z;
+	Sfulong_t	records;
+	Sfulong_t	data;
+	Sfulong_t	keys;
+	Sfulong_t	usec;
+	Tv_t		bt;
+	Tv_t		et;
+
+	if (!disc->defkeyf)
+	{
+		error(2, "no key function to time");
+		return 1;
+	}
+	buf = 0;
+	m = z = 0;
+	while (s = *sp->key->input++)
+	{
+		if (!(fp = fileopen(sp, s)))
+			continue;
+		for (;;)
+		{
+			if (m >= z)
+			{
+				z = z ? 2 * z : INBRK;
+				if (!(buf = vmnewof(Vmheap, buf, unsigned char, z, 0)))
+					error(ERROR_SYSTEM|3, "out of space");
+			}
+			if ((n = sfread(fp, buf + m, z - m)) <= 0)
+				break;
+			m += n;
+		}
+		if (n < 0)
+			error(ERROR_SYSTEM|2, "%s: read error", s);
+		if (rsfileclose(sp->rec, fp))
+			return 1;
+	}
+	b = buf;
+	e = b + m;
+	k = 0;
+	z = 0;
+	records = data = keys = 0;
+	tvgettime(&bt);
+	while (b < e && (n = reclen(disc->data, b, e - b)) > 0)
+	{
+		if (n > e - b)
+			n = e - b;
+		if (z < (m = n * disc->key + INMIN))
+		{
+			z = roundof(m, INMIN);
+			if (!(k = vmnewof(Vmheap, k, unsigned char, z, 0)))
+				error(ERROR_SYSTEM|3, "out of space");
+		}
+		keys += (*disc->defkeyf)(sp->rec, b, n, k, z, disc);
+		data += n;
+		records++;
+		b += n;
+	}
+	tvgettime(&et);
+	usec = ((Sflong_t)(et.tv_sec - bt.tv_sec) * 1000000000 + (Sflong_t)et.tv_nsec - (Sflong_t)bt.tv_nsec) / 1000;
+	sfprintf(sfstderr, "code\n\trecords=%I*u\n\tdata=%I*u\n\tkey=%I*u\n\tusec=%I*u\n", sizeof(records), records, sizeof(data), data, sizeof(keys), keys, sizeof(usec), usec);
+	if (k)
+		vmfree(Vmheap, k);
+	if (buf)
+		vmfree(Vmheap, buf);
+	return error_info.errors != 0;
+}
+
 /*
  * initialize sp from argv
  */
@@ -955,6 +1141,13 @@ init(register Sort_t* sp, Rskeydisc_t* dp, char** argv)
 		if (!sp->map || pathstdin(key->input[0]))
 		{
 	uno:
+			if (key->meth == Rsrasp || key->meth == Rsradix)
+			{
+				key->meth = Rsthread;
+				key->disc->threads = key->nproc;
+				if (key->verbose)
+					error(0, "%s %d threads", error_info.id, key->nproc);
+			}
 			key->nproc = 1;
 		}
 		else if ((n = (sp->total + key->procsize - 1) / (key->procsize)) <= 1)
@@ -1154,6 +1347,20 @@ init(register Sort_t* sp, Rskeydisc_t* dp, char** argv)
 	if (sp->zip & SF_WRITE)
 		sfdcgzip(sp->op, 0);
 
+	/*
+	 * -zT intermediate compression goes last on the discipline stack
+	 */
+
+	if (sp->temp.level)
+	{
+		Rsdisc_t*	rp;
+
+		sp->temp.disc.eventf = temp;
+		sp->temp.disc.events = RS_TEMP_WRITE|RS_TEMP_READ;
+		for (rp = key->disc; rp->disc; rp = rp->disc);
+		rp->disc = &sp->temp.disc;
+	}
+
 	/*
 	 * finally ready for recsort now
 	 */
@@ -1214,6 +1421,8 @@ flush(register Sort_t* sp, register size_t r)
 	register size_t		n;
 	register size_t		m;
 	register size_t		b;
+	int			i;
+	int			k;
 
 	if (sp->chunk)
 	{
@@ -1228,7 +1437,32 @@ flush(register Sort_t* sp, register size_t r)
 			return -1;
 		}
 	}
-	else if (sp->rec->meth->type != RS_MTVERIFY)
+	else if (sp->nparts)
+	{
+		/*
+		 * split into the key range partition files for partitions()
+		 */
+
+		if ((i = sp->pbase + sp->nfiles) >= sp->pend)
+			error(3, "cannot create intermediate sort file %d", sp->nfiles);
+		for (k = 0; k < sp->nparts; k++)
+			sp->part[k] = sp->parts[k * sp->pfiles + i];
+		sp->nfiles++;
+		if (sp->verbose)
+			error(0, "%s write %d intermediate partitions", error_info.id, sp->nparts);
+		if (rswritepart(sp->rec, sp->part, sp->nparts, sp->split, 0))
+		{
+			error(ERROR_SYSTEM|2, "intermediate sort file write error");
+			return -1;
+		}
+		for (k = 0; k < sp->nparts; k++)
+			if (rstempread(sp->rec, sp->part[k]))
+			{
+				error(ERROR_SYSTEM|2, "intermediate sort file rewind error");
+				return -1;
+			}
+	}
+	else if (!(sp->rec->meth->type & (RS_MTVERIFY|RS_MTLIMIT)))
 	{
 		/*
 		 * write to an intermediate file and rewind for rsmerge
@@ -1517,6 +1751,130 @@ partseek(Sfio_t* fp, Sfoff_t lloffset, int op, Sfdisc_t* dp)
 	return offset;
 }
 
+/*
+ * qsort() key comparison, consistent with rswritepart()
+ */
+
+static int
+keycmp(const void* a, const void* b)
+{
+	register Rsobj_t*	one = (Rsobj_t*)a;
+	register Rsobj_t*	two = (Rsobj_t*)b;
+	register ssize_t	l;
+	register ssize_t	d;
+	register int		c;
+
+	if ((d = (l = one->keylen) - two->keylen) > 0)
+		l -= d;
+	if (l > 0 && (c = memcmp(one->key, two->key, l)))
+		return c;
+	return d < 0 ? -1 : d > 0;
+}
+
+/*
+ * sample the input keys to select the sp->nparts-1
+ * key range splitters for the parallel merge
+ * files is the number of intermediate files per partition
+ * 0 returned if the final merge cannot be partitioned
+ */
+
+static int
+splitters(register Sort_t* sp, int files)
+{
+	register Rsobj_t*	op;
+	register char*		s;
+	register int		i;
+	register int		m;
+	Rs_t*			rs = sp->rec;
+	Rsdisc_t*		dp = rs->disc;
+	Rsobj_t*		sample;
+	Sfio_t*			ip;
+	char*			file;
+	unsigned char*		kb = 0;
+	size_t			kz = 0;
+	size_t			z;
+	ssize_t			k;
+	ssize_t			x;
+	off_t			offset;
+	int			del;
+
+	if (sp->chunk || (sp->test & TEST_keys) || (rs->meth->type & (RS_MTVERIFY|RS_MTCOPY)) || (files + 1) * sp->key->nproc > OPEN_MAX - 8)
+		return 0;
+	if (sp->key->fixed)
+		del = -1;
+	else if (RECTYPE(sp->key->disc->data) == REC_delimited)
+		del = REC_D_DELIMITER(sp->key->disc->data);
+	else
+		return 0;
+	m = sp->key->nproc * SAMPLE;
+	if (!(sample = vmnewof(Vmheap, 0, Rsobj_t, m, 0)))
+		return 0;
+	file = sp->key->input[0];
+	if (!(ip = fileopen(sp, file)))
+		error(ERROR_SYSTEM|3, "%s: cannot read", file);
+	if ((x = dp->key) <= 0)
+		x = mbcoll() ? 64 : 4;
+	for (op = sample, i = 0; i < m; i++)
+	{
+		offset = (sp->total / m) * i;
+		if (del < 0)
+		{
+			offset -= offset % sp->key->fixed;
+			if (sfseek(ip, offset, SEEK_SET) != offset || !(s = (char*)sfreserve(ip, sp->key->fixed, 0)))
+				continue;
+			z = sp->key->fixed;
+		}
+		else if (sfseek(ip, offset, SEEK_SET) != offset || (offset && !sfgetr(ip, del, 0)) || !(s = sfgetr(ip, del, 0)))
+			continue;
+		else
+			z = sfvalue(ip);
+		if (dp->defkeyf)
+		{
+			if (kz < x * z)
+			{
+				kz = roundof(x * z, 1024);
+				if (!(kb = vmnewof(Vmheap, kb, unsigned char, kz, 0)))
+					error(ERROR_SYSTEM|3, "out of space");
+			}
+			if ((k = (*dp->defkeyf)(rs, (unsigned char*)s, z, kb, kz, dp)) < 0)
+				continue;
+			s = (char*)kb;
+		}
+		else
+		{
+			s += dp->key;
+			if ((k = dp->keylen) <= 0)
+				k += z - dp->key;
+			if (k < 0)
+				continue;
+		}
+		if (!(op->key = vmnewof(Vmheap, 0, unsigned char, k, 1)))
+			error(ERROR_SYSTEM|3, "out of space");
+		memcpy(op->key, s, op->keylen = k);
+		op++;
+	}
+	if (kb)
+		vmfree(Vmheap, kb);
+	if (rsfileclose(rs, ip))
+		return 0;
+	sfclose(ip);
+	if ((m = op - sample) < sp->key->nproc)
+	{
+		while (op-- > sample)
+			vmfree(Vmheap, op->key);
+		vmfree(Vmheap, sample);
+		return 0;
+	}
+	qsort(sample, m, sizeof(Rsobj_t), keycmp);
+	sp->nparts = sp->key->nproc;
+	if (!(sp->split = vmnewof(Vmheap, 0, Rsobj_t, sp->nparts - 1, 0)))
+		error(ERROR_SYSTEM|3, "out of space");
+	for (i = 1; i < sp->nparts; i++)
+		sp->split[i - 1] = sample[i * m / sp->nparts];
+	vmfree(Vmheap, sample);
+	return 1;
+}
+
 /*
  * job control
  * requires single named input file
@@ -1549,8 +1907,21 @@ jobs(register Sort_t* sp)
 	}
 	f = 0;
 	for (jp = sp->jobs; jp < xp; jp++)
-		for (i = 0; i < jp->intermediates; i++)
-			if (!(sp->files[f++] = rstempwrite(sp->rec, (Sfio_t*)0)))
+		f += jp->intermediates;
+	if (splitters(sp, f))
+	{
+		if (sp->verbose)
+			error(0, "%s %d merge partitions", error_info.id, sp->nparts);
+		if (!(sp->parts = vmnewof(Vmheap, 0, Sfio_t*, f * sp->nparts, 0)) || !(sp->part = vmnewof(Vmheap, 0, Sfio_t*, sp->nparts, 0)))
+			error(ERROR_SYSTEM|3, "out of space");
+		sp->pfiles = f;
+		for (i = 0; i < f * sp->nparts; i++)
+			if (!(sp->parts[i] = rstempwrite(sp->rec, (Sfio_t*)0)))
+				error(ERROR_SYSTEM|3, "cannot create intermediate file %d", i);
+	}
+	else
+		for (i = 0; i < f; i++)
+			if (!(sp->files[i] = rstempwrite(sp->rec, (Sfio_t*)0)))
 				error(ERROR_SYSTEM|3, "cannot create intermediate file %d", i);
 	part.disc.readf = partread;
 	part.disc.writef = 0;
@@ -1574,10 +1945,18 @@ jobs(register Sort_t* sp)
 			part.offset = jp->offset;
 			sp->total = part.size = part.remain = jp->size;
 			sfdisc(ip, &part.disc);
-			for (i = 0; i < jp->intermediates; i++)
-				sp->files[i] = sp->files[j++];
-			while (i < f)
-				sp->files[i++] = 0;
+			if (sp->nparts)
+			{
+				sp->pbase = j;
+				sp->pend = j + jp->intermediates;
+			}
+			else
+			{
+				for (i = 0; i < jp->intermediates; i++)
+					sp->files[i] = sp->files[j++];
+				while (i < f)
+					sp->files[i++] = 0;
+			}
 			if (sp->verbose)
 				error(0, "%s pos %12lld : len %10lld : buf %10lld : num %2d", error_info.id, (Sflong_t)jp->offset, (Sflong_t)jp->size, (Sflong_t)jp->chunk, jp->intermediates);
 			exit(input(sp, ip, file) < 0);
@@ -1587,7 +1966,8 @@ jobs(register Sort_t* sp)
 		sfclose(ip);
 		j += jp->intermediates;
 	}
-	sp->nfiles = f;
+	if (!sp->nparts)
+		sp->nfiles = f;
 	i = 0;
 	j = sp->key->nproc;
 	while (j > 0)
@@ -1606,6 +1986,82 @@ jobs(register Sort_t* sp)
 	}
 	if (i)
 		error(3, "%d child process%s failed", i, i == 1 ? "" : "es");
+
+	/*
+	 * the children wrote the intermediates -- rewind for the parent
+	 */
+
+	if (sp->nparts)
+		f *= sp->nparts;
+	for (i = 0; i < f; i++)
+		if (rstempread(sp->rec, sp->nparts ? sp->parts[i] : sp->files[i]))
+			error(ERROR_SYSTEM|3, "intermediate sort file %d rewind error", i);
+}
+
+/*
+ * parallel partitioned merge of the jobs() intermediate files
+ * each process merges one key range into a tmp file
+ * and the tmp files are catenated in output order
+ */
+
+static void
+partitions(register Sort_t* sp)
+{
+	register int	i;
+	register int	j;
+	int		status;
+	Sfio_t**	out;
+	char		id[32];
+
+	if (!(out = vmnewof(Vmheap, 0, Sfio_t*, sp->nparts, 0)))
+		error(ERROR_SYSTEM|3, "out of space");
+	for (i = 0; i < sp->nparts; i++)
+		if (!(out[i] = rstempwrite(sp->rec, (Sfio_t*)0)))
+			error(ERROR_SYSTEM|3, "cannot create partition merge file %d", i);
+	for (i = 0; i < sp->nparts; i++)
+		switch (fork())
+		{
+		case -1:
+			error(ERROR_SYSTEM|3, "not enough child processes");
+		case 0:
+			sp->child = 1;
+			sfsprintf(id, sizeof(id), "%s#%d", error_info.id, i + 1);
+			error_info.id = id;
+			if (sp->verbose)
+				error(0, "%s merge partition", error_info.id);
+			if (rsmerge(sp->rec, out[i], sp->parts + i * sp->pfiles, sp->pfiles, RS_OTEXT))
+				error(ERROR_SYSTEM|3, "merge error");
+			exit(rstempread(sp->rec, out[i]) != 0);
+		}
+	i = 0;
+	j = sp->nparts;
+	while (j > 0)
+	{
+		if (wait(&status) != -1)
+		{
+			if (status)
+				i++;
+			j--;
+		}
+		else if (errno != EINTR)
+		{
+			error(ERROR_SYSTEM|3, "%d process%s did not complete", j, j == 1 ? "" : "es");
+			break;
+		}
+	}
+	if (i)
+		error(3, "%d merge process%s failed", i, i == 1 ? "" : "es");
+	for (i = 0; i < sp->nparts * sp->pfiles; i++)
+		rstempclose(sp->rec, sp->parts[i]);
+	if (sp->verbose)
+		error(0, "%s catenate %d partitions", error_info.id, sp->nparts);
+	for (i = 0; i < sp->nparts; i++)
+	{
+		if (rstempread(sp->rec, out[i]) || sfmove(out[i], sp->op, SF_UNBOUND, -1) < 0 || !sfeof(out[i]))
+			error(ERROR_SYSTEM|3, "%s: write error", sp->key->output);
+		rstempclose(sp->rec, out[i]);
+	}
+	vmfree(Vmheap, out);
 }
 
 /*
@@ -1679,6 +2135,8 @@ main(int argc, char** argv)
 		sfprintf(sfstderr, "main\n\tintermediates=%d\n", sort.xfiles);
 		rskeydump(sort.key, sfstderr);
 	}
+	if (sort.test & TEST_code)
+		exit(code(&sort));
 	if (sort.key->type & RS_CAT)
 	{
 		while (s = *sort.key->input++)
@@ -1724,7 +2182,13 @@ main(int argc, char** argv)
 					fp = 0;
 				}
 			}
-		if (sort.nfiles)
+		if (sort.nparts)
+		{
+			if (sort.verbose)
+				error(0, "%s merge partitions", error_info.id);
+			partitions(&sort);
+		}
+		else if (sort.nfiles)
 		{
 			if (sort.cur && flush(&sort, sort.cur) < 0)
 				return 1;
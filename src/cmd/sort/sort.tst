@@ -307,3 +307,69 @@ TEST 27 'non-newline delimited variable length records'
 	EXEC	-n -Rd:
 		INPUT -n - $'1111:222:33:4:'
 		OUTPUT -n - $'4:33:222:1111:'
+
+TEST 28 'parallel jobs with partitioned final merge'
+	DO	{ integer i; for ((i = 0; i < 4000; i++)); do print $(( (i * 7919) % 4001 )) $(( i % 13 )); done > in; }
+	EXEC	-j3 -zp1k -o j.out in
+	EXEC	-o s.out in
+		SAME j.out s.out
+	EXEC	-j3 -zp1k -n -r -k2,2 -o j.out in
+	EXEC	-n -r -k2,2 -o s.out in
+		SAME j.out s.out
+
+TEST 29 'threaded sort of standard input with -j'
+	DO	{ integer i; for ((i = 0; i < 20000; i++)); do print $(( (i * 7919) % 20011 )) $(( i % 13 )); done > in; }
+	EXEC	-j3 -o j.out
+		INPUT in
+	EXEC	-o s.out in
+		SAME j.out s.out
+	EXEC	-j3 -u -k2,2 -o j.out
+		INPUT in
+	EXEC	-u -k2,2 -o s.out in
+		SAME j.out s.out
+
+TEST 30 'bounded --limit selection'
+	EXEC	--limit=3
+		INPUT - $'5\n3\n1\n4\n2\n3'
+		OUTPUT - $'1\n2\n3'
+	EXEC	--limit=3 -n -r
+		OUTPUT - $'5\n4\n3'
+	EXEC	--limit=3 -u
+		OUTPUT - $'1\n2\n3'
+	EXEC	--limit=10 -n
+		OUTPUT - $'1\n2\n3\n3\n4\n5'
+	EXEC	--limit=2 -k2,2 -s
+		INPUT - $'a 2\nb 1\nc 2\nd 1'
+		OUTPUT - $'b 1\nd 1'
+	EXEC	--limit=3 -k2,2 -s
+		OUTPUT - $'b 1\nd 1\na 2'
+	EXEC	--limit=3 -k2,2 -u
+		OUTPUT - $'b 1\na 2'
+	EXEC	--limit=2 -m
+		OUTPUT -
+		ERROR - $'sort: --limit cannot be combined with --check, --merge or -zc'
+		EXIT 1
+
+TEST 31 'key coder escapes in long keys'
+	EXEC
+		INPUT - $'abcdefghijklmnop\xff\nabcdefgh\x02ijklmnop\nabcdefghijklmnop\nabcdefgh\x01ijklmnop\nabcdefghijklmnop\xfe\nabcdefgh'
+		OUTPUT - $'abcdefgh\nabcdefgh\x01ijklmnop\nabcdefgh\x02ijklmnop\nabcdefghijklmnop\nabcdefghijklmnop\xfe\nabcdefghijklmnop\xff'
+	EXEC	-r
+		OUTPUT - $'abcdefghijklmnop\xff\nabcdefghijklmnop\xfe\nabcdefghijklmnop\nabcdefgh\x02ijklmnop\nabcdefgh\x01ijklmnop\nabcdefgh'
+	EXEC	-t, -k2,2
+		INPUT - $'1,abcdefghijklmnop\xff,a\n2,abcdefgh\x01ijklmnop,b\n3,abcdefghijklmnop,c\n4,abcdefgh,d'
+		OUTPUT - $'4,abcdefgh,d\n2,abcdefgh\x01ijklmnop,b\n3,abcdefghijklmnop,c\n1,abcdefghijklmnop\xff,a'
+	EXEC	-t, -k2,2r -k1,1
+		OUTPUT - $'1,abcdefghijklmnop\xff,a\n3,abcdefghijklmnop,c\n2,abcdefgh\x01ijklmnop,b\n4,abcdefgh,d'
+
+TEST 32 'gzip compressed intermediate files'
+	DO	{ integer i; for ((i = 0; i < 4000; i++)); do print $(( (i * 7919) % 4001 )) $(( i % 13 )); done > in; }
+	EXEC	-zT -zp1k -o t.out in
+	EXEC	-o s.out in
+		SAME t.out s.out
+	EXEC	-zT9 -zp1k -zm4 -n -k2,2 -o t.out in
+	EXEC	-n -k2,2 -o s.out in
+		SAME t.out s.out
+	EXEC	-zT -j3 -zp1k -o t.out in
+	EXEC	-o s.out in
+		SAME t.out s.out
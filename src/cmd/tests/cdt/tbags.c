@@ -69,7 +69,7 @@ tmain()
 		}
 	}
 
-	for(meth = 0; meth < 4; ++meth)
+	for(meth = 0; meth < 5; ++meth)
 	{	switch(meth)
 		{ case 0:
 			name = "Dtobag";
@@ -91,6 +91,11 @@ tmain()
 			if(!(dt = dtopen(&Disc, Dtlist)) )
 				terror("%s: Can't open dictionary", name);
 			break;
+		  case 4:
+			name = "Dtlpbag";
+			if(!(dt = dtopen(&Disc, Dtlpbag)) )
+				terror("%s: Can't open dictionary", name);
+			break;
 		  default: terror("Unknown storage method");
 			break;
 		}
@@ -144,5 +144,34 @@ tmain()
 	if(k != 10)
 		terror("Did not see all 3's k=%d", k);
 
+	/* Dtbtbag built from the ordered bag, then grown past a few node splits */
+	dtmethod(dt, Dtbtbag);
+	if(dtsize(dt) != 100)
+		terror("Dtbtbag: size %d != 100", dtsize(dt));
+	for(i = 1; i <= 10; ++i)
+	for(k = 1; k <= 10; ++k)
+		if((long)dtinsert(dt, k) != k)
+			terror("Dtbtbag: Can't insert k=%d at iteration %d", k, i);
+	for(k = 0, i = (long)dtfirst(dt); i; k = i, i = (long)dtnext(dt,i))
+		if(i < k)
+			terror("Dtbtbag: Disorder %ld >= %ld", k, i);
+
+	for(k = 0, i = (long)dtatmost(dt,5L); i == 5; i = (long)dtnext(dt,i) )
+		k += 1;
+	if(k != 20)
+		terror("Dtbtbag: Did not see all 5's k=%d", k);
+
+	for(k = 0, i = (long)dtatleast(dt,3L); i == 3; i = (long)dtprev(dt,i) )
+		k += 1;
+	if(k != 20)
+		terror("Dtbtbag: Did not see all 3's k=%d", k);
+
+	for(k = 0; dtdelete(dt, 4L); )
+		k += 1;
+	if(k != 20 || dtsize(dt) != 180)
+		terror("Dtbtbag: deleted %d 4's, size %d", k, dtsize(dt));
+	if((long)dtatleast(dt,4L) != 5 || (long)dtatmost(dt,4L) != 3)
+		terror("Dtbtbag: Wrong neighbors of 4");
+
 	texit(0);
 }
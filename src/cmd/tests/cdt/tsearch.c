@@ -35,7 +35,7 @@ tmain()
 {
 	Dt_t*		dt;
 	Dtlink_t*	link;
-	long		i, k, count[1000];
+	long		i, k, next, count[1000];
 
 	/* testing Dtoset */
 	dt = dtopen(&Disc,Dtoset);
@@ -268,5 +268,68 @@ tmain()
 		if(count[i] != 1)
 			terror("wrong count[%d]=%d", i, count[i]);
 
+	/* test Dtlpset through table doublings and deletes while walking */
+	dtclear(dt);
+	dtmethod(dt, Dtlpset);
+	for(i = 1; i < 20000; ++i)
+		if((long)dtinsert(dt,i) != i)
+			terror("Dtlpset: Can't insert %d", i);
+	for(i = 1; i < 20000; ++i)
+		if((long)dtsearch(dt,i) != i)
+			terror("Dtlpset: Can't find %d", i);
+	if((long)dtsearch(dt,20000L) != 0)
+		terror("Dtlpset: Found 20000");
+	if(dtsize(dt) != 19999)
+		terror("Dtlpset: size %d != 19999", dtsize(dt));
+
+	for(i = 0, k = (long)dtfirst(dt); k != 0; k = next)
+	{	next = (long)dtnext(dt,k);
+		if(k%2 == 0 && (long)dtdelete(dt,k) != k)
+			terror("Dtlpset: Can't delete %d", k);
+		i += 1;
+	}
+	if(i != 19999)
+		terror("Dtlpset: walked %d objects != 19999", i);
+	for(i = 1; i < 20000; ++i)
+		if((long)dtsearch(dt,i) != (i%2 ? i : 0) )
+			terror("Dtlpset: Wrong search result for %d", i);
+	if(dtsize(dt) != 10000)
+		terror("Dtlpset: size %d != 10000", dtsize(dt));
+
+	dtmethod(dt,Dtoset);
+	for(i = 1, k = (long)dtfirst(dt); i < 20000; i += 2, k = (long)dtnext(dt,k))
+		if(i != k)
+			terror("Dtlpset: Bad value %d != %d", k, i);
+
+	/* test Dtbtset built from the odd numbers, then filled in backward */
+	dtmethod(dt, Dtbtset);
+	if(dtsize(dt) != 10000)
+		terror("Dtbtset: size %d != 10000", dtsize(dt));
+	for(i = 2; i < 20000; i += 2)
+		if((long)dtatleast(dt,i) != i+1 || (long)dtatmost(dt,i) != i-1)
+			terror("Dtbtset: Wrong neighbors of %d", i);
+	for(i = 19998; i > 0; i -= 2)
+		if((long)dtinsert(dt,i) != i)
+			terror("Dtbtset: Can't insert %d", i);
+	if((long)dtinsert(dt,7L) != 7 || dtsize(dt) != 19999)
+		terror("Dtbtset: Insert 7 twice, size %d", dtsize(dt));
+	for(i = 1; i < 20000; ++i)
+		if((long)dtsearch(dt,i) != i)
+			terror("Dtbtset: Can't find %d", i);
+	for(i = (long)dtlast(dt), k = 19999; k >= 1; i = (long)dtprev(dt,i), k -= 1)
+		if(i != k)
+			terror("Dtbtset: backwalk %d != %d", i, k);
+
+	for(k = (long)dtfirst(dt); k != 0; k = next)
+	{	next = (long)dtnext(dt,k);
+		if(k%3 != 0 && (long)dtdelete(dt,k) != k)
+			terror("Dtbtset: Can't delete %d", k);
+	}
+	for(i = 3, k = (long)dtfirst(dt); i < 20000; i += 3, k = (long)dtnext(dt,k))
+		if(i != k)
+			terror("Dtbtset: Bad value %d != %d", k, i);
+	if(dtsize(dt) != 6666)
+		terror("Dtbtset: size %d != 6666", dtsize(dt));
+
 	texit(0);
 }
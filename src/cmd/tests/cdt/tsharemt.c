@@ -0,0 +1,200 @@
+/***********************************************************************
+*                                                                      *
+*               This software is part of the ast package               *
+*          Copyright (c) 1999-2012 AT&T Intellectual Property          *
+*                      and is licensed under the                       *
+*                 Eclipse Public License, Version 1.0                  *
+*                    by AT&T Intellectual Property                     *
+*                                                                      *
+*                A copy of the License is available at                 *
+*          http://www.eclipse.org/org/documents/epl-v10.html           *
+*         (with md5 checksum b35adb5213ca9657e911e9befb180842)         *
+*                                                                      *
+*              Information and Software Systems Research               *
+*                            AT&T Research                             *
+*                           Florham Park NJ                            *
+*                                                                      *
+*                 Glenn Fowler <gsf@research.att.com>                  *
+*                                                                      *
+***********************************************************************/
+#include	"dttest.h"
+
+#include	<aso.h>
+#include	<pthread.h>
+#include	<sys/time.h>
+
+/* Test DT_SHARE dictionaries with threads searching, inserting and deleting
+** at once, then time the same mix for 1, 2, 4... threads as a scaling check.
+** The times of a plain dictionary under one mutex are shown for comparison.
+*/
+
+#define N_THREADS	8		/* max #threads			*/
+#define N_OBJ		(64*1024)	/* even objects always stay	*/
+#define N_OPS		(128*1024)	/* operations per thread	*/
+#define N_WRITE		8		/* one in N_WRITE ops is odd	*/
+
+typedef struct obj_s
+{	Dtlink_t	link;	/* embedded so nothing is allocated	*/
+	int		value;	/* even values stay in the dictionary	*/
+	int		here;	/* in dictionary, set by its owner only	*/
+} Obj_t;
+
+static Obj_t		Obj[N_OBJ];
+static Dt_t		*Dict;
+static int		Nthreads, Nstarted;
+static pthread_mutex_t	Mutex = PTHREAD_MUTEX_INITIALIZER;
+static int		Lock; /* use Mutex instead of DT_SHARE */
+
+static int mycompare(Dt_t* dt, Void_t* key1, Void_t* key2, Dtdisc_t* disc)
+{
+	return *((int*)key1) - *((int*)key2);
+}
+
+static unsigned int myhash(Dt_t* dt, Void_t* key, Dtdisc_t* disc)
+{
+	return *((unsigned int*)key) * 0x9e3779b1;
+}
+
+static Dtdisc_t Disc =
+{	DTOFFSET(Obj_t,value), sizeof(int), DTOFFSET(Obj_t,link),
+	0, 0, mycompare, myhash, 0, 0
+};
+
+static Void_t* call(Void_t* obj, int type)
+{
+	Void_t	*rv;
+
+	if(Lock)
+		pthread_mutex_lock(&Mutex);
+	rv = (*Dict->searchf)(Dict, obj, type);
+	if(Lock)
+		pthread_mutex_unlock(&Mutex);
+	return rv;
+}
+
+/* thread (p) owns odd objects whose value/2 is (p) modulo Nthreads */
+static void* worker(void* arg)
+{
+	int		p, k, n;
+	unsigned int	rand;
+	Obj_t		*o, *rv, proto;
+
+	p = (int)((long)arg);
+	rand = (unsigned int)p*7919 + 1;
+
+	asoincint(&Nstarted);
+	while(asogetint(&Nstarted) < Nthreads)
+		asorelax(1);
+
+	for(n = 0; n < N_OPS; ++n)
+	{	rand = rand*1103515245 + 12345;
+		k = (int)((rand >> 8) % N_OBJ);
+		if((n % N_WRITE) == 0) /* change an object of our own */
+			k = ((k/2/Nthreads)*Nthreads + p)*2 + 1;
+		else	k &= ~1;
+		if(k >= N_OBJ)
+			continue;
+
+		o = &Obj[k];
+		proto.value = k;
+		if(!(k&1))
+		{	if((rv = call((n&1) ? (Void_t*)&k : (Void_t*)&proto, (n&1) ? DT_MATCH : DT_SEARCH)) != o)
+				terror("thread %d: search %d returned %d", p, k, rv ? rv->value : -1);
+		}
+		else if(o->here)
+		{	if((rv = call(o, DT_DELETE)) != o)
+				terror("thread %d: delete %d returned %d", p, k, rv ? rv->value : -1);
+			if(call(&proto, DT_SEARCH))
+				terror("thread %d: %d found after delete", p, k);
+			o->here = 0;
+		}
+		else
+		{	if((rv = call(o, DT_INSERT)) != o)
+				terror("thread %d: insert %d returned %d", p, k, rv ? rv->value : -1);
+			if(call(&k, DT_MATCH) != o)
+				terror("thread %d: %d not found after insert", p, k);
+			o->here = 1;
+		}
+	}
+
+	return 0;
+}
+
+/* run Nthreads workers and return the elapsed time in milliseconds */
+static long run(int nthreads)
+{
+	int		p;
+	pthread_t	thread[N_THREADS];
+	struct timeval	tv1, tv2;
+
+	Nthreads = nthreads;
+	Nstarted = 0;
+
+	gettimeofday(&tv1, 0);
+	for(p = 0; p < Nthreads; ++p)
+		if(pthread_create(&thread[p], 0, worker, (void*)((long)p)) != 0)
+			terror("Can't create thread %d", p);
+	for(p = 0; p < Nthreads; ++p)
+		pthread_join(thread[p], 0);
+	gettimeofday(&tv2, 0);
+
+	return (tv2.tv_sec - tv1.tv_sec)*1000 + (tv2.tv_usec - tv1.tv_usec)/1000;
+}
+
+/* check that all even objects and only those odd ones marked are there */
+static void check(char* name, int nthreads)
+{
+	int		k;
+	ssize_t		n;
+
+	for(n = 0, k = 0; k < N_OBJ; ++k)
+	{	if(dtsearch(Dict, &Obj[k]) != ((k&1) && !Obj[k].here ? NIL(Obj_t*) : &Obj[k]) )
+			terror("%s with %d threads: object %d is %s", name, nthreads, k,
+				Obj[k].here ? "lost" : "still there");
+		if(!(k&1) || Obj[k].here)
+			n += 1;
+	}
+	if(dtsize(Dict) != n)
+		terror("%s with %d threads: size %d, expecting %d", name, nthreads, dtsize(Dict), n);
+}
+
+tmain()
+{
+	int		m, k, n;
+	long		ms, base[2];
+	Dtmethod_t	*meth;
+	static Dtmethod_t **Meth[] = { &Dtset, &Dtoset, &Dtlpset, &Dtbtset, 0 };
+	static char	*Name[] = { "Dtset", "Dtoset", "Dtlpset", "Dtbtset" };
+
+	topts();
+	taso(ASO_THREAD);
+
+	for(m = 0; Meth[m]; ++m)
+	{	meth = *Meth[m];
+		for(Lock = 1; Lock >= 0; --Lock)
+		{	if(!(Dict = dtopen(&Disc, meth)) )
+				terror("%s: can't open dictionary", Name[m]);
+			if(!Lock && dtcustomize(Dict, DT_SHARE, 1) != DT_SHARE)
+				terror("%s: can't turn on DT_SHARE", Name[m]);
+
+			for(k = 0; k < N_OBJ; ++k)
+			{	Obj[k].value = k;
+				if((Obj[k].here = !(k&1)) && dtinsert(Dict, &Obj[k]) != &Obj[k])
+					terror("%s: insert %d failed", Name[m], k);
+			}
+
+			for(n = 1; n <= N_THREADS; n *= 2)
+			{	ms = run(n);
+				check(Name[m], n);
+				if(n == 1)
+					base[Lock] = ms > 0 ? ms : 1;
+				tinfo("%s %s %d threads: %ldms %d.%02dx", Name[m], Lock ? "mutex" : "share", n, ms,
+					(int)((n*base[Lock]*100/(ms > 0 ? ms : 1))/100), (int)((n*base[Lock]*100/(ms > 0 ? ms : 1))%100) );
+			}
+
+			dtclose(Dict);
+		}
+	}
+
+	texit(0);
+}
@@ -0,0 +1,132 @@
+/***********************************************************************
+*                                                                      *
+*               This software is part of the ast package               *
+*          Copyright (c) 1999-2011 AT&T Intellectual Property          *
+*                      and is licensed under the                       *
+*                 Eclipse Public License, Version 1.0                  *
+*                    by AT&T Intellectual Property                     *
+*                                                                      *
+*                A copy of the License is available at                 *
+*          http://www.eclipse.org/org/documents/epl-v10.html           *
+*         (with md5 checksum b35adb5213ca9657e911e9befb180842)         *
+*                                                                      *
+*              Information and Software Systems Research               *
+*                            AT&T Research                             *
+*                           Florham Park NJ                            *
+*                                                                      *
+*                 Glenn Fowler <gsf@research.att.com>                  *
+*                                                                      *
+***********************************************************************/
+#pragma prototyped
+
+#pragma prototyped
+
+/*
+ * AT&T Research
+ *
+ * test harness for regcache and regcachestat
+ *
+ *	regcache [ pattern | -flags | =size | . | ? ] ...
+ *
+ *	pattern	regcache() pattern with the current flags, list
+ *		hit or miss and whether the re matches aXb -- a hit
+ *		must return the re from the previous call
+ *	-flags	set the flags: e for REG_EXTENDED, i for REG_ICASE,
+ *		q to list only errors and hits that return another re
+ *	=size	regcache(0,size) -- flush and resize
+ *	.	regcache(0,0) -- flush
+ *	?	list regcachestat()
+ */
+
+#include <ast.h>
+#include <regex.h>
+
+#define MAXRE	64
+
+typedef struct Seen_s
+{
+	char*		pattern;
+	regflags_t	flags;
+	regex_t*	re;
+} Seen_t;
+
+int
+main(int argc, char** argv)
+{
+	char*		s;
+	regex_t*	re;
+	char*		hit;
+	Seen_t		seen[MAXRE];
+	regcachestat_t	st;
+	unsigned long	hits;
+	regflags_t	flags;
+	int		code;
+	int		quiet;
+	int		n;
+	int		i;
+
+	flags = 0;
+	quiet = 0;
+	n = 0;
+	while (s = *++argv)
+	{
+		switch (*s)
+		{
+		case '-':
+			flags = 0;
+			quiet = 0;
+			while (*++s)
+				switch (*s)
+				{
+				case 'e':
+					flags |= REG_EXTENDED;
+					break;
+				case 'i':
+					flags |= REG_ICASE;
+					break;
+				case 'q':
+					quiet = 1;
+					break;
+				}
+			continue;
+		case '=':
+			regcache(NiL, (regflags_t)strtol(s + 1, NiL, 0), &code);
+			sfprintf(sfstdout, "regcache     resize %s %d\n", s + 1, code);
+			continue;
+		case '.':
+			regcache(NiL, 0, &code);
+			sfprintf(sfstdout, "regcache     flush %d\n", code);
+			continue;
+		case '?':
+			regcachestat(&st);
+			sfprintf(sfstdout, "regcachestat size=%d count=%d hits=%lu misses=%lu flushes=%lu\n", (int)st.rc_size, (int)st.rc_count, st.rc_hits, st.rc_misses, st.rc_flushes);
+			continue;
+		}
+		regcachestat(&st);
+		hits = st.rc_hits;
+		if (!(re = regcache(s, flags, &code)))
+		{
+			sfprintf(sfstdout, "regcache     \"%s\" error %d\n", s, code);
+			continue;
+		}
+		regcachestat(&st);
+		for (i = 0; i < n && (seen[i].flags != flags || !streq(seen[i].pattern, s)); i++);
+		if (st.rc_hits == hits)
+			hit = "miss";
+		else if (i < n && seen[i].re == re)
+			hit = "hit";
+		else
+			hit = "hit-different-re";
+		if (i < n)
+			seen[i].re = re;
+		else if (n < MAXRE)
+		{
+			seen[n].pattern = s;
+			seen[n].flags = flags;
+			seen[n++].re = re;
+		}
+		if (!quiet || *hit == 'h' && hit[3])
+			sfprintf(sfstdout, "regcache     \"%s\" %s %s\n", s, hit, regexec(re, "aXb", 0, NiL, 0) ? "nomatch" : "match");
+	}
+	return 0;
+}
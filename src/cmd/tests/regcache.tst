@@ -0,0 +1,61 @@
+# regression tests for the ast regcache() and regcachestat() routines
+
+TEST 01 'hits and misses'
+	EXEC	a.b a.b axb a.b '?'
+		OUTPUT - $'regcache     "a.b" miss match
+regcache     "a.b" hit match
+regcache     "axb" miss nomatch
+regcache     "a.b" hit match
+regcachestat size=32 count=2 hits=2 misses=2 flushes=0'
+	EXEC	axb -i axb - axb -i axb '?'
+		OUTPUT - $'regcache     "axb" miss nomatch
+regcache     "axb" miss match
+regcache     "axb" hit nomatch
+regcache     "axb" hit match
+regcachestat size=32 count=2 hits=2 misses=2 flushes=0'
+
+TEST 02 'compile errors are not cached'
+	EXEC	-e 'a(' 'a(' '?' 'a(b)' 'a(b)' '?'
+		OUTPUT - $'regcache     "a(" error 8
+regcache     "a(" error 8
+regcachestat size=32 count=0 hits=0 misses=2 flushes=0
+regcache     "a(b)" miss nomatch
+regcache     "a(b)" hit nomatch
+regcachestat size=32 count=1 hits=1 misses=3 flushes=0'
+
+TEST 03 'flush'
+	EXEC	. '?' a.b axb . '?' a.b '?' . . '?'
+		OUTPUT - $'regcache     flush 0
+regcachestat size=0 count=0 hits=0 misses=0 flushes=0
+regcache     "a.b" miss match
+regcache     "axb" miss nomatch
+regcache     flush 0
+regcachestat size=32 count=0 hits=0 misses=2 flushes=1
+regcache     "a.b" miss match
+regcachestat size=32 count=1 hits=0 misses=3 flushes=1
+regcache     flush 0
+regcache     flush 0
+regcachestat size=32 count=0 hits=0 misses=3 flushes=2'
+
+TEST 04 'least recently used entries are replaced'
+	EXEC	-q p{1..32} '?' p1 p33 '?' - p1 p33 p2 p3 p4 '?'
+		OUTPUT - $'regcachestat size=32 count=32 hits=0 misses=32 flushes=0
+regcachestat size=32 count=32 hits=1 misses=33 flushes=0
+regcache     "p1" hit nomatch
+regcache     "p33" hit nomatch
+regcache     "p2" miss nomatch
+regcache     "p3" miss nomatch
+regcache     "p4" miss nomatch
+regcachestat size=32 count=32 hits=3 misses=36 flushes=0'
+
+TEST 05 'resize'
+	EXEC	=40 -q p{1..40} '?' - p1 p40 p41 p1 p2 =8 '?'
+		OUTPUT - $'regcache     resize 40 0
+regcachestat size=40 count=40 hits=0 misses=40 flushes=0
+regcache     "p1" hit nomatch
+regcache     "p40" hit nomatch
+regcache     "p41" miss nomatch
+regcache     "p1" hit nomatch
+regcache     "p2" miss nomatch
+regcache     resize 8 0
+regcachestat size=40 count=0 hits=3 misses=42 flushes=1'
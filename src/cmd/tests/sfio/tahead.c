@@ -0,0 +1,121 @@
+/***********************************************************************
+*                                                                      *
+*               This software is part of the ast package               *
+*          Copyright (c) 1999-2011 AT&T Intellectual Property          *
+*                      and is licensed under the                       *
+*                 Eclipse Public License, Version 1.0                  *
+*                    by AT&T Intellectual Property                     *
+*                                                                      *
+*                A copy of the License is available at                 *
+*          http://www.eclipse.org/org/documents/epl-v10.html           *
+*         (with md5 checksum b35adb5213ca9657e911e9befb180842)         *
+*                                                                      *
+*              Information and Software Systems Research               *
+*                            AT&T Research                             *
+*                           Florham Park NJ                            *
+*                                                                      *
+*                 Glenn Fowler <gsf@research.att.com>                  *
+*                                                                      *
+***********************************************************************/
+#include	"sftest.h"
+#include	<sfdisc.h>
+
+#define BLOCK	1024
+#define NBLOCK	256
+
+static char	Buf[BLOCK];
+
+#if __STD_C
+static void check(Sfio_t* f, Sfoff_t pos, char* where)
+#else
+static void check(f, pos, where)
+Sfio_t*	f;
+Sfoff_t	pos;
+char*	where;
+#endif
+{
+	char	buf[BLOCK];
+	ssize_t	n, k;
+
+	if(sfseek(f,pos,SEEK_SET) != pos)
+		terror("%s: can't seek to %lld", where, (Sfoff_t)pos);
+	for(; pos < (Sfoff_t)BLOCK*NBLOCK; pos += n)
+	{	if((n = sfread(f,buf,sizeof(buf))) <= 0)
+			terror("%s: read failed at %lld", where, pos);
+		for(k = 0; k < n; ++k)
+			if(buf[k] != (char)((pos+k)%251))
+				terror("%s: bad data at %lld", where, pos+k);
+	}
+	if(sfread(f,buf,sizeof(buf)) != 0)
+		terror("%s: data past eof", where);
+}
+
+tmain()
+{
+	Sfio_t*	f;
+	int	fd[2];
+	int	i, k;
+	char	buf[4*BLOCK];
+
+	if(!(f = sfopen(NIL(Sfio_t*), tstfile("sf", 0), "w")) )
+		terror("Can't open file to write");
+	for(i = 0; i < NBLOCK; ++i)
+	{	for(k = 0; k < BLOCK; ++k)
+			Buf[k] = (char)(((Sfoff_t)i*BLOCK+k)%251);
+		if(sfwrite(f,Buf,BLOCK) != BLOCK)
+			terror("Can't write file");
+	}
+	sfclose(f);
+
+	/* not a regular file */
+	if(!(f = sfopen(NIL(Sfio_t*), "0123456789", "s")) )
+		terror("Can't open string stream");
+	if(sfdcahead(f,0,0) >= 0)
+		terror("sfdcahead() should fail on a string stream");
+	sfclose(f);
+
+	if(pipe(fd) < 0)
+		terror("Can't create pipe");
+	if(!(f = sfnew(NIL(Sfio_t*),NIL(Void_t*),(size_t)SF_UNBOUND,fd[0],SF_READ)) )
+		terror("Can't open pipe stream");
+	if(sfdcahead(f,0,0) >= 0)
+		terror("sfdcahead() should fail on a pipe");
+	sfclose(f);
+	close(fd[1]);
+
+	/* default buffering, possibly memory mapped */
+	if(!(f = sfopen(NIL(Sfio_t*), tstfile("sf", 0), "r")) )
+		terror("Can't open file to read");
+#if _lib_posix_fadvise
+	if(sfdcahead(f,0,0) < 0)
+		terror("sfdcahead() failed on a regular file");
+#else
+	(void)sfdcahead(f,0,0);
+#endif
+	check(f, (Sfoff_t)0, "default");
+	check(f, (Sfoff_t)BLOCK*NBLOCK/2+7, "default seek forward");
+	check(f, (Sfoff_t)13, "default seek back");
+	sfclose(f);
+
+	/* small read buffer so that the read-ahead window moves */
+	if(!(f = sfopen(NIL(Sfio_t*), tstfile("sf", 0), "r")) )
+		terror("Can't open file to read");
+	sfsetbuf(f,buf,sizeof(buf));
+#if _lib_posix_fadvise
+	if(sfdcahead(f,0,2) < 0)
+		terror("sfdcahead() failed on a buffered regular file");
+	if(!f->disc)
+		terror("sfdcahead() should push a discipline on a read buffer");
+#else
+	(void)sfdcahead(f,0,2);
+#endif
+	check(f, (Sfoff_t)0, "buffered");
+	check(f, (Sfoff_t)BLOCK*NBLOCK/2+7, "buffered seek forward");
+	check(f, (Sfoff_t)13, "buffered seek back");
+	if(f->disc && sfdisc(f,SF_POPDISC) == NIL(Sfdisc_t*))
+		terror("Can't pop discipline");
+	check(f, (Sfoff_t)BLOCK, "popped");
+	sfclose(f);
+
+	texit(0);
+}
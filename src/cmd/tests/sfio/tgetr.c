@@ -87,5 +87,51 @@ tmain()
 	if(!(s = sfgetr(f, '\n', 1)))
 		terror("Can't get a record");
 
+	/* records straddling and exceeding a small mapped window */
+	if(!(f = sfopen(NIL(Sfio_t*), tstfile("sf", 0), "w")) )
+		terror("Can't open file to write");
+	for(n = 0; n < 64; ++n)
+	{	for(i = 0; i < n*n*5; ++i)
+			sfputc(f, 'a' + (n+i)%26);
+		sfputc(f, '\n');
+	}
+	if(!(f = sfopen(f, tstfile("sf", 0), "r")) )
+		terror("Can't open file to read");
+	sfsetbuf(f, NIL(Void_t*), 8*1024);
+	for(n = 0; n < 64; ++n)
+	{	if(!(s = sfgetr(f, '\n', 0)) )
+			terror("Can't get record %d", n);
+		if((i = sfvalue(f)) != n*n*5+1)
+			terror("Record %d length is %d, expected %d", n, i, n*n*5+1);
+		for(i = 0; i < n*n*5; ++i)
+			if(s[i] != 'a' + (n+i)%26)
+				terror("Record %d byte %d is wrong", n, i);
+	}
+	if(sfgetr(f, '\n', 0))
+		terror("Shouldn't have gotten a record after the last one");
+
+	/* a last partial record crossing the window end */
+	if(!(f = sfopen(f, tstfile("sf", 0), "w")) )
+		terror("Can't open file to write");
+	for(i = 0; i < 8*1024-10; ++i)
+		sfputc(f, 'x');
+	sfputc(f, '\n');
+	for(i = 0; i < 20000; ++i)
+		sfputc(f, 'a' + i%26);
+	if(!(f = sfopen(f, tstfile("sf", 0), "r")) )
+		terror("Can't open file to read");
+	sfsetbuf(f, NIL(Void_t*), 8*1024);
+	if(!(s = sfgetr(f, '\n', 0)) || sfvalue(f) != 8*1024-9)
+		terror("Can't get the first record");
+	if(sfgetr(f, '\n', 0))
+		terror("Shouldn't have gotten a partial record");
+	if(!(s = sfgetr(f, '\n', SF_LASTR)) )
+		terror("Can't get the last partial record");
+	if((i = sfvalue(f)) != 20000)
+		terror("Partial record length is %d, expected 20000", i);
+	for(i = 0; i < 20000; ++i)
+		if(s[i] != 'a' + i%26)
+			terror("Partial record byte %d is wrong", i);
+
 	texit(0);
 }
@@ -0,0 +1,70 @@
+/***********************************************************************
+*                                                                      *
+*               This software is part of the ast package               *
+*          Copyright (c) 1999-2011 AT&T Intellectual Property          *
+*                      and is licensed under the                       *
+*                 Eclipse Public License, Version 1.0                  *
+*                    by AT&T Intellectual Property                     *
+*                                                                      *
+*                A copy of the License is available at                 *
+*          http://www.eclipse.org/org/documents/epl-v10.html           *
+*         (with md5 checksum b35adb5213ca9657e911e9befb180842)         *
+*                                                                      *
+*              Information and Software Systems Research               *
+*                            AT&T Research                             *
+*                           Florham Park NJ                            *
+*                                                                      *
+*                 Glenn Fowler <gsf@research.att.com>                  *
+*                                                                      *
+***********************************************************************/
+#include	"sftest.h"
+
+/* small writes followed by large pass-through writes */
+
+tmain()
+{
+	Sfio_t		*f;
+	char		buf[8*1024], big[40*1024], *s;
+	int		i, k, n;
+	Sfulong_t	calls, bytes;
+
+	for(i = 0; i < sizeof(big); ++i)
+		big[i] = 'a' + i%26;
+
+	if(!(f = sfopen(NIL(Sfio_t*), tstfile("sf", 0), "w")) )
+		terror("Can't open file to write");
+	sfsetbuf(f, buf, sizeof(buf));
+	for(k = 0; k < 32; ++k)
+	{	if(sfputr(f, "header", '\n') != 7)
+			terror("sfputr failed");
+		n = (k+1)*1024;
+		if(sfwrite(f, big, n) != n)
+			terror("sfwrite of %d bytes failed", n);
+	}
+	if(sfclose(f) < 0)
+		terror("sfclose failed");
+	sfwrstat(&calls, &bytes);
+#if _lib_writev && _sys_uio
+	if(calls == 0)
+		terror("No vectored writes");
+	if(bytes < calls*7)
+		terror("sfwrstat calls=%d bytes=%d", (int)calls, (int)bytes);
+#endif
+
+	if(!(f = sfopen(NIL(Sfio_t*), tstfile("sf", 0), "r")) )
+		terror("Can't open file to read");
+	for(k = 0; k < 32; ++k)
+	{	if(!(s = sfgetr(f, '\n', 1)) || strcmp(s, "header") != 0)
+			terror("Header %d is wrong", k);
+		n = (k+1)*1024;
+		if(!(s = sfreserve(f, n, SF_LOCKR)) )
+			terror("Can't reserve %d bytes of block %d", n, k);
+		if(memcmp(s, big, n) != 0)
+			terror("Block %d is wrong", k);
+		sfread(f, s, n);
+	}
+	if(sfgetc(f) >= 0)
+		terror("Data past the last block");
+
+	texit(0);
+}
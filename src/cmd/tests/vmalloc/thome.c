@@ -0,0 +1,121 @@
+/***********************************************************************
+*                                                                      *
+*               This software is part of the ast package               *
+*          Copyright (c) 1999-2012 AT&T Intellectual Property          *
+*                      and is licensed under the                       *
+*                 Eclipse Public License, Version 1.0                  *
+*                    by AT&T Intellectual Property                     *
+*                                                                      *
+*                A copy of the License is available at                 *
+*          http://www.eclipse.org/org/documents/epl-v10.html           *
+*         (with md5 checksum b35adb5213ca9657e911e9befb180842)         *
+*                                                                      *
+*              Information and Software Systems Research               *
+*                            AT&T Research                             *
+*                           Florham Park NJ                            *
+*                                                                      *
+*                 Glenn Fowler <gsf@research.att.com>                  *
+*                                                                      *
+***********************************************************************/
+#include	"vmtest.h"
+#include	<pthread.h>
+
+/* free() of a block in a region other than Vmregion: done at once when
+** the region is open, queued when it is locked, and the region lock is
+** released again; threads that free each other's blocks exercise both
+*/
+
+#define N_THREAD	8
+#define N_ALLOC		20000
+
+static void*	List[N_THREAD][N_ALLOC];
+
+static void* allocate(void* arg)
+{
+	int	k, thread = (int)((long)arg);
+
+	for(k = 0; k < N_ALLOC; ++k)
+		if(!(List[thread][k] = malloc(k%256 + 1)) )
+			terror("Thread %d: malloc(%d) failed", thread, k%256 + 1);
+	return (void*)0;
+}
+
+static void* release(void* arg)
+{
+	int	k, thread = ((int)((long)arg) + 1) % N_THREAD;
+
+	for(k = 0; k < N_ALLOC; ++k)
+		free(List[thread][k]);
+	return (void*)0;
+}
+
+static void run(void* (*func)(void*), char* what)
+{
+	int		i;
+	pthread_t	th[N_THREAD];
+
+	for(i = 0; i < N_THREAD; ++i)
+		if(pthread_create(&th[i], NULL, func, (void*)((long)i)) != 0 )
+			terror("Failed to create %s thread %d", what, i);
+	for(i = 0; i < N_THREAD; ++i)
+		if(pthread_join(th[i], NULL) != 0 )
+			terror("Failed waiting for %s thread %d", what, i);
+}
+
+tmain()
+{
+	Void_t		*a, *b;
+	Vmstat_t	st, vs;
+
+	topts();
+	taso(ASO_THREAD);
+
+	if(!(a = malloc(64)) || !(b = malloc(64)) )
+		terror("malloc failed");
+	if(Vmregion != Vmheap)
+		texit(0); /* frees in Vmregion itself take the unlocked path */
+	vmstat(0, &st);
+
+	/* an open region frees at once and is unlocked after */
+	free(a);
+	vmstat(0, &vs);
+	if(vs.n_direct != st.n_direct + 1 || vs.n_queue != st.n_queue)
+		terror("Direct free not counted direct=%d/%d queue=%d/%d",
+			vs.n_direct, st.n_direct, vs.n_queue, st.n_queue);
+	if(vmstat(Vmheap, NIL(Vmstat_t*)) != 0)
+		terror("Region still locked after a direct free");
+
+	/* a locked region gets the block queued */
+	if(asocasint(&Vmheap->data->lock, 0, 1) != 0)
+		terror("Can't lock Vmheap");
+	free(b);
+	if(asocasint(&Vmheap->data->lock, 1, 0) != 1)
+		terror("Vmheap lock changed by a queued free");
+	vmstat(0, &st);
+	if(st.n_queue != vs.n_queue + 1 || st.n_direct != vs.n_direct)
+		terror("Queued free not counted direct=%d/%d queue=%d/%d",
+			st.n_direct, vs.n_direct, st.n_queue, vs.n_queue);
+
+	/* the next allocation returns queued blocks */
+	vmstat(Vmheap, &vs);
+	free(malloc(8));
+	vmstat(Vmheap, &st);
+	if(st.n_busy != vs.n_busy - 1)
+		terror("Queued block not freed busy=%d was %d", st.n_busy, vs.n_busy);
+
+	/* threads free each other's blocks */
+	vmstat(0, &vs);
+	run(allocate, "allocate");
+	run(release, "release");
+	vmstat(0, &st);
+	if((st.n_direct - vs.n_direct) + (st.n_queue - vs.n_queue) < N_THREAD*N_ALLOC)
+		terror("Frees not counted direct=%d queue=%d expected %d",
+			st.n_direct - vs.n_direct, st.n_queue - vs.n_queue, N_THREAD*N_ALLOC);
+	if(st.n_home > st.n_open)
+		terror("More home region calls %d than open calls %d", st.n_home, st.n_open);
+	tinfo("regions=%d open=%d home=%d probe=%d direct=%d queue=%d",
+		st.n_region, st.n_open, st.n_home, st.n_probe,
+		st.n_direct - vs.n_direct, st.n_queue - vs.n_queue);
+
+	texit(0);
+}
@@ -0,0 +1,104 @@
+/***********************************************************************
+*                                                                      *
+*               This software is part of the ast package               *
+*          Copyright (c) 1999-2011 AT&T Intellectual Property          *
+*                      and is licensed under the                       *
+*                 Eclipse Public License, Version 1.0                  *
+*                    by AT&T Intellectual Property                     *
+*                                                                      *
+*                A copy of the License is available at                 *
+*          http://www.eclipse.org/org/documents/epl-v10.html           *
+*         (with md5 checksum b35adb5213ca9657e911e9befb180842)         *
+*                                                                      *
+*              Information and Software Systems Research               *
+*                            AT&T Research                             *
+*                           Florham Park NJ                            *
+*                                                                      *
+*                 Glenn Fowler <gsf@research.att.com>                  *
+*                                                                      *
+***********************************************************************/
+#include	"vmtest.h"
+
+#define N_BIG	8
+#define BIGSIZE	(4*1024*1024)
+
+static Void_t*	Big[N_BIG];
+static Void_t*	Fence[N_BIG];
+
+#if __STD_C
+static void release(Vmethod_t* meth, char* name)
+#else
+static void release(meth, name)
+Vmethod_t*	meth;
+char*		name;
+#endif
+{
+	Vmalloc_t*	vm;
+	Vmstat_t	st;
+	size_t		resident;
+	int		k;
+
+	if(!(vm = vmopen(Vmdcsystem, meth, 0)) )
+		terror("%s: Can't open region", name);
+
+	for(k = 0; k < N_BIG; ++k)
+	{	if(!(Big[k] = vmalloc(vm, BIGSIZE)) )
+			terror("%s: Can't allocate big block %d", name, k);
+		memset(Big[k], 1, BIGSIZE);
+		if(!(Fence[k] = vmalloc(vm, 100)) )
+			terror("%s: Can't allocate fence %d", name, k);
+		memset(Fence[k], k, 100);
+	}
+	if(vmstat(vm, &st) < 0)
+		terror("%s: Can't get statistics", name);
+	resident = st.resident;
+	if(resident > st.extent)
+		terror("%s: Resident=%d larger than extent=%d", name, resident, st.extent);
+
+	for(k = 0; k < N_BIG; ++k)
+		if(vmfree(vm, Big[k]) < 0)
+			terror("%s: Can't free big block %d", name, k);
+	if(vmcompact(vm) < 0)
+		terror("%s: Can't compact region", name);
+	if(vmstat(vm, &st) < 0)
+		terror("%s: Can't get statistics", name);
+
+#if __linux__
+	if(_Vmrelsize > 0 && st.released == 0)
+		terror("%s: No space released after freeing %d big blocks", name, N_BIG);
+#endif
+	if(st.released > 0 && st.resident >= resident)
+		terror("%s: Released=%d but resident=%d did not drop from %d",
+			name, st.released, st.resident, resident);
+
+	for(k = 0; k < N_BIG; ++k)
+	{	unsigned char*	s = (unsigned char*)Fence[k];
+		int		n;
+
+		for(n = 0; n < 100; ++n)
+			if(s[n] != k)
+				terror("%s: Fence %d corrupted at %d", name, k, n);
+	}
+
+	/* released pages must be usable again */
+	for(k = 0; k < N_BIG; ++k)
+	{	if(!(Big[k] = vmalloc(vm, BIGSIZE)) )
+			terror("%s: Can't reallocate big block %d", name, k);
+		memset(Big[k], 2, BIGSIZE);
+	}
+
+	vmclose(vm);
+}
+
+tmain()
+{
+	/* page release is off unless VMALLOC_OPTIONS asks for it */
+	if(!getenv("VMALLOC_OPTIONS") && _Vmrelsize != 0)
+		terror("Page release enabled by default: _Vmrelsize=%d", _Vmrelsize);
+	_Vmrelsize = 1024*1024;
+
+	release(Vmbest, "Vmbest");
+	release(Vmslab, "Vmslab");
+
+	texit(0);
+}
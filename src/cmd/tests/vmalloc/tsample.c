@@ -0,0 +1,118 @@
+/***********************************************************************
+*                                                                      *
+*               This software is part of the ast package               *
+*          Copyright (c) 1999-2011 AT&T Intellectual Property          *
+*                      and is licensed under the                       *
+*                 Eclipse Public License, Version 1.0                  *
+*                    by AT&T Intellectual Property                     *
+*                                                                      *
+*                A copy of the License is available at                 *
+*          http://www.eclipse.org/org/documents/epl-v10.html           *
+*         (with md5 checksum b35adb5213ca9657e911e9befb180842)         *
+*                                                                      *
+*              Information and Software Systems Research               *
+*                            AT&T Research                             *
+*                           Florham Park NJ                            *
+*                                                                      *
+*                 Glenn Fowler <gsf@research.att.com>                  *
+*                                                                      *
+***********************************************************************/
+#include	"vmtest.h"
+
+#define N_OBJ	10000
+#define OBJSIZE	100
+
+static Void_t*	Obj[N_OBJ];
+
+#if __STD_C
+static ssize_t profile(char* file, char* buf, size_t size)
+#else
+static ssize_t profile(file, buf, size)
+char*	file;
+char*	buf;
+size_t	size;
+#endif
+{
+	int	fd;
+	ssize_t	n;
+
+	if((fd = open(file, O_CREAT|O_TRUNC|O_RDWR, 0666)) < 0)
+		terror("Can't create %s", file);
+	if(vmsmpdump(fd, 0) < 0)
+		terror("Can't dump profile");
+	if(lseek(fd, (off_t)0, SEEK_SET) != 0)
+		terror("Can't rewind %s", file);
+	if((n = read(fd, buf, size-1)) <= 0)
+		terror("Empty profile");
+	buf[n] = 0;
+	close(fd);
+	return n;
+}
+
+tmain()
+{
+	char		buf[1024];
+	char*		file;
+	long		n_busy, s_busy, n, s;
+	int		k;
+
+	file = tstfile("prof", -1);
+
+	if(vmsample(1024) != 0)
+		terror("Sampling should be off initially");
+	if(vmsample(-1) != 1024)
+		terror("Can't query sampling period");
+
+	for(k = 0; k < N_OBJ; ++k)
+		if(!(Obj[k] = malloc(OBJSIZE)) )
+			terror("Can't allocate object %d", k);
+
+	profile(file, buf, sizeof(buf));
+	if(strncmp(buf, "heap profile: ", 14) != 0)
+		terror("Bad profile header '%.32s'", buf);
+	if(sscanf(buf+14, "%ld: %ld", &n_busy, &s_busy) != 2)
+		terror("Can't parse profile header '%.64s'", buf);
+	if(n_busy <= 0 || s_busy < n_busy*OBJSIZE)
+		terror("Sampled busy=%ld size=%ld after %d allocations", n_busy, s_busy, N_OBJ);
+	if(n_busy > N_OBJ)
+		terror("Sampled busy=%ld more than the %d allocations", n_busy, N_OBJ);
+	if(!strstr(buf, "heap_v2/1024"))
+		terror("Profile header has the wrong period '%.64s'", buf);
+
+	/* a failed realloc() leaves the block and its sample alone */
+	for(k = 0; k < N_OBJ; ++k)
+		if(realloc(Obj[k], ((size_t)~0) >> 2) )
+			terror("Huge realloc of object %d should fail", k);
+	profile(file, buf, sizeof(buf));
+	if(sscanf(buf+14, "%ld: %ld", &n, &s) != 2)
+		terror("Can't parse profile header '%.64s'", buf);
+	if(n != n_busy || s != s_busy)
+		terror("Sampled busy=%ld size=%ld after failed realloc, was %ld %ld", n, s, n_busy, s_busy);
+
+	/* a moved block is sampled once */
+	for(k = 0; k < N_OBJ; ++k)
+		if(!(Obj[k] = realloc(Obj[k], 4*OBJSIZE)) )
+			terror("Can't reallocate object %d", k);
+	profile(file, buf, sizeof(buf));
+	if(sscanf(buf+14, "%ld: %ld", &n_busy, &s_busy) != 2)
+		terror("Can't parse profile header '%.64s'", buf);
+	if(n_busy <= 0 || n_busy > N_OBJ)
+		terror("Sampled busy=%ld after %d reallocations", n_busy, N_OBJ);
+
+	for(k = 0; k < N_OBJ; ++k)
+		free(Obj[k]);
+
+	profile(file, buf, sizeof(buf));
+	if(sscanf(buf+14, "%ld: %ld", &n_busy, &s_busy) != 2)
+		terror("Can't parse profile header '%.64s'", buf);
+	if(n_busy != 0 || s_busy != 0)
+		terror("Sampled busy=%ld size=%ld after freeing all", n_busy, s_busy);
+
+	if(vmsample(0) != 1024)
+		terror("Can't turn sampling off");
+	if(!(Obj[0] = malloc(OBJSIZE)) )
+		terror("Can't allocate after sampling off");
+	free(Obj[0]);
+
+	texit(0);
+}
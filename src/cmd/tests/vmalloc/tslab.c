@@ -0,0 +1,145 @@
+/***********************************************************************
+*                                                                      *
+*               This software is part of the ast package               *
+*          Copyright (c) 1999-2011 AT&T Intellectual Property          *
+*                      and is licensed under the                       *
+*                 Eclipse Public License, Version 1.0                  *
+*                    by AT&T Intellectual Property                     *
+*                                                                      *
+*                A copy of the License is available at                 *
+*          http://www.eclipse.org/org/documents/epl-v10.html           *
+*         (with md5 checksum b35adb5213ca9657e911e9befb180842)         *
+*                                                                      *
+*              Information and Software Systems Research               *
+*                            AT&T Research                             *
+*                           Florham Park NJ                            *
+*                                                                      *
+*                 Glenn Fowler <gsf@research.att.com>                  *
+*                                                                      *
+***********************************************************************/
+#include	"vmtest.h"
+
+#define N_OBJ	4000
+#define N_LOOP	100000
+
+static Void_t*	Obj[N_OBJ];
+static size_t	Size[N_OBJ];
+
+#define OBJSIZE()	(random()%50 == 0 ? random()%40000 + 1 : \
+			 random()%10 == 0 ? random()%2000 + 1 : random()%200 + 1)
+
+static void fill(int k)
+{
+	memset(Obj[k], k&0377, Size[k]);
+}
+
+static void check(int k)
+{
+	unsigned char*	s = (unsigned char*)Obj[k];
+	size_t		n;
+
+	for(n = 0; n < Size[k]; ++n)
+		if(s[n] != (k&0377))
+			terror("Object %d of size %d corrupted at %d", k, Size[k], n);
+}
+
+tmain()
+{
+	Vmalloc_t*	vm;
+	Vmstat_t	st;
+	Void_t*		addr;
+	size_t		busy;
+	int		i, k, n;
+
+	srandom(0);
+
+	if(!(vm = vmopen(Vmdcsystem, Vmslab, 0)) )
+		terror("Can't open region");
+
+	for(i = 0; i < N_LOOP; ++i)
+	{	k = random()%N_OBJ;
+		if(Obj[k])
+		{	check(k);
+			if(vmaddr(vm, (char*)Obj[k] + Size[k]/2) != Size[k]/2)
+				terror("Wrong vmaddr for object %d", k);
+			if(vmsize(vm, Obj[k]) < (ssize_t)Size[k])
+				terror("Wrong vmsize for object %d", k);
+			if(vmregion(Obj[k]) != vm)
+				terror("Wrong vmregion for object %d", k);
+			if(random()%3 == 0)
+			{	n = OBJSIZE();
+				if(!(Obj[k] = vmresize(vm, Obj[k], n, VM_RSMOVE|VM_RSCOPY)) )
+					terror("Can't resize object %d", k);
+				if(n < Size[k])
+					Size[k] = n;
+				check(k);
+				Size[k] = n;
+				fill(k);
+			}
+			else
+			{	if(vmfree(vm, Obj[k]) < 0)
+					terror("Can't free object %d", k);
+				Obj[k] = NIL(Void_t*);
+			}
+		}
+		else
+		{	Size[k] = OBJSIZE();
+			if(!(Obj[k] = vmalloc(vm, Size[k])) )
+				terror("Can't allocate object %d", k);
+			if((((Vmulong_t)Obj[k])%ALIGN) != 0)
+				terror("Unaligned object %d", k);
+			fill(k);
+		}
+
+		if(i%(N_LOOP/10) == 0 && vmcompact(vm) < 0)
+			terror("Can't compact region");
+	}
+
+	for(busy = 0, n = 0, k = 0; k < N_OBJ; ++k)
+		if(Obj[k])
+		{	check(k);
+			busy += Size[k];
+			n += 1;
+		}
+	if(vmstat(vm, &st) < 0)
+		terror("Can't get statistics");
+	if(st.n_busy != n || st.s_busy < busy)
+		terror("Busy count=%d size=%d, expected %d and at least %d",
+			st.n_busy, st.s_busy, n, busy);
+	if(st.s_busy + st.s_free > st.extent)
+		terror("Busy+free=%d larger than extent=%d",
+			st.s_busy + st.s_free, st.extent);
+
+	for(k = 0; k < N_OBJ; ++k)
+	{	if(Obj[k] && vmfree(vm, Obj[k]) < 0)
+			terror("Can't free object %d", k);
+		if(Obj[k] && vmfree(vm, Obj[k]) >= 0)
+			terror("Freeing object %d twice succeeded", k);
+		Obj[k] = NIL(Void_t*);
+	}
+	if(vmcompact(vm) < 0)
+		terror("Can't compact region");
+	if(vmstat(vm, &st) < 0 || st.n_busy != 0)
+		terror("Busy blocks left after freeing all");
+
+	for(k = 0; k < 16; ++k)
+	{	n = 1 << (k+4);
+		if(!(addr = vmalign(vm, 100, n)) )
+			terror("Can't align to %d", n);
+		if(((Vmulong_t)addr)%n != 0)
+			terror("Block is not aligned to %d", n);
+		if(vmaddr(vm, addr) != 0)
+			terror("Wrong vmaddr for aligned block");
+	}
+
+	if(vmclear(vm) < 0)
+		terror("Can't clear region");
+	if(vmstat(vm, &st) < 0 || st.n_busy != 0)
+		terror("Busy blocks left after clearing");
+	if(!(addr = vmalloc(vm, 10)) || vmaddr(vm, addr) != 0)
+		terror("Can't allocate after clearing");
+
+	vmclose(vm);
+
+	texit(0);
+}
@@ -122,9 +122,23 @@ typedef struct _dtlib_s
 
 #endif /* _BLD_cdt */
 
-/* these macros lock/unlock dictionaries. DTRETURN substitutes for "return" */
-#define DTSETLOCK(dt)		(((dt)->data->type&DT_SHARE) ? asolock(&(dt)->data->lock,1,ASO_SPINLOCK) : 0 )
-#define DTCLRLOCK(dt)		(((dt)->data->type&DT_SHARE) ? asolock(&(dt)->data->lock,1,ASO_UNLOCK) : 0 )
+/* In DT_SHARE mode, data->lock is a reader/writer lock. Searches that do not
+** change the dictionary can hold it shared (DT_LKSHARE) while all else must
+** hold it alone (DT_LKALONE). A method may further divide its data while the
+** lock is shared, e.g., Dtset locks hash table slots by stripes.
+** DT_RELINK is only issued by a method already holding the lock in DT_RESTORE.
+*/
+#define DT_LKSHARE		1		/* share with other readers	*/
+#define DT_LKALONE		2		/* exclusive use		*/
+#define DT_LKWRITE		0x80000000	/* lock is held alone		*/
+#define DT_LKWAIT		0x40000000	/* a writer is waiting		*/
+
+/* these macros lock/unlock dictionaries. DTRETURN substitutes for "return".
+** (lk) is the wanted lock type and is reset to 0 if no locking is needed.
+*/
+#define DTSETLOCK(dt,lk)	((lk) = (((dt)->data->type&DT_SHARE) ? (lk) : 0), \
+				 (lk) ? _dtlock((dt),(lk)) : 0 )
+#define DTCLRLOCK(dt,lk)	((lk) ? _dtlock((dt),-(lk)) : 0 )
 #define DTRETURN(ob,rv)		do { (ob) = (rv); goto dt_return; } while(0)
 #define DTERROR(dt, mesg) 	(!((dt)->disc && (dt)->disc->eventf) ? 0 : \
 				  (*(dt)->disc->eventf)((dt),DT_ERROR,(Void_t*)(mesg),(dt)->disc) )
@@ -0,0 +1,719 @@
+/***********************************************************************
+*                                                                      *
+*               This software is part of the ast package               *
+*          Copyright (c) 1985-2012 AT&T Intellectual Property          *
+*                      and is licensed under the                       *
+*                 Eclipse Public License, Version 1.0                  *
+*                    by AT&T Intellectual Property                     *
+*                                                                      *
+*                A copy of the License is available at                 *
+*          http://www.eclipse.org/org/documents/epl-v10.html           *
+*         (with md5 checksum b35adb5213ca9657e911e9befb180842)         *
+*                                                                      *
+*              Information and Software Systems Research               *
+*                            AT&T Research                             *
+*                           Florham Park NJ                            *
+*                                                                      *
+*                 Glenn Fowler <gsf@research.att.com>                  *
+*                  David Korn <dgk@research.att.com>                   *
+*                   Phong Vo <kpv@research.att.com>                    *
+*                                                                      *
+***********************************************************************/
+#include	"dthdr.h"
+
+/*	Ordered set/multiset as a B-tree.
+**	A node keeps up to BT_MAX objects in order in one array so that a
+**	search does a binary search on each node of a short path and never
+**	changes the tree. Nodes other than the root keep at least BT_MIN
+**	objects except on the right edge where objects appended in order
+**	split nodes unevenly to pack them. The path to the object last
+**	returned is kept as a finger so that dtnext() and dtprev() take
+**	constant amortized time.
+*/
+
+#define BT_MAX		32		/* max #objects in a node, even	*/
+#define BT_MIN		(BT_MAX/2)	/* min #objects in most nodes	*/
+#define BT_DEPTH	32		/* max #levels, never reached	*/
+
+#define BT_UPPER	01	/* btfind(): go past equal objects	*/
+#define BT_STOP		02	/* btfind(): stop at an equal object	*/
+
+typedef struct _btnode_s	Btnode_t;
+struct _btnode_s
+{	int		size;		/* #objects in the node		*/
+	int		leaf;		/* node has no subtrees		*/
+	Dtlink_t*	link[BT_MAX+1];	/* objects, +1 to insert then split */
+	Btnode_t*	kid[BT_MAX+2];	/* subtrees, absent from leaves	*/
+};
+#define BTLEAF		DTOFFSET(Btnode_t,kid)	/* size of a leaf node	*/
+
+/* A position in the tree is the path to it. The last node holds it at
+** pos[lev] and the nodes above record the subtrees taken. A position at
+** the end of a node is that of the object after its subtree, if any.
+*/
+typedef struct _btpath_s
+{	int		lev;		/* last level, -1 if no position */
+	Btnode_t*	node[BT_DEPTH];
+	int		pos[BT_DEPTH];
+} Btpath_t;
+
+typedef struct _dtbtree_s
+{	Dtdata_t	data;
+	Btnode_t*	root;	/* root node			*/
+	int		depth;	/* #levels			*/
+	Btpath_t	here;	/* finger, the last object returned */
+} Dtbtree_t;
+
+#define BTLINK(p)	((p)->node[(p)->lev]->link[(p)->pos[(p)->lev]])
+#define BTCMP(dt,k,l,dc) _DTCMP((dt), (k), _DTKEY((dc),_DTOBJ((dc),(l))), (dc))
+
+static Btnode_t* btnode(Dt_t* dt, int leaf)
+{
+	Btnode_t	*nd;
+
+	if((nd = (Btnode_t*)(*dt->memoryf)(dt, NIL(Void_t*), leaf ? BTLEAF : sizeof(Btnode_t), dt->disc)) )
+	{	nd->size = 0;
+		nd->leaf = leaf;
+	}
+	else	DTERROR(dt, "Error in allocating a B-tree node");
+	return nd;
+}
+
+/* free a subtree and, if type is not 0, its objects */
+static void btfree(Dt_t* dt, Btnode_t* nd, int type)
+{
+	int	i;
+
+	for(i = 0; i <= nd->size; ++i)
+	{	if(!nd->leaf)
+			btfree(dt, nd->kid[i], type);
+		if(type && i < nd->size)
+			_dtfree(dt, nd->link[i], type);
+	}
+	(void)(*dt->memoryf)(dt, (Void_t*)nd, 0, dt->disc);
+}
+
+/* descend to the first object not less than key, or greater than key if
+** BT_UPPER. With BT_STOP, return 1 at the first equal object seen.
+*/
+static int btfind(Dt_t* dt, Btpath_t* p, Void_t* key, int type)
+{
+	int		lo, hi, mid, cmp, d;
+	Btnode_t	*nd;
+	Dtdisc_t	*disc = dt->disc;
+
+	for(d = 0, nd = ((Dtbtree_t*)dt->data)->root;; nd = nd->kid[lo], d += 1)
+	{	for(lo = 0, hi = nd->size; lo < hi; )
+		{	mid = (lo + hi)/2;
+			if((cmp = BTCMP(dt, key, nd->link[mid], disc)) == 0 && (type&BT_STOP) )
+			{	p->node[d] = nd;
+				p->pos[d] = mid;
+				p->lev = d;
+				return 1;
+			}
+			if(cmp > 0 || (cmp == 0 && (type&BT_UPPER)) )
+				lo = mid+1;
+			else	hi = mid;
+		}
+		p->node[d] = nd;
+		p->pos[d] = lo;
+		if(nd->leaf)
+			break;
+	}
+	p->lev = d;
+	return 0;
+}
+
+/* the object at a position or after it without moving there */
+static Dtlink_t* btpeek(Btpath_t* p)
+{
+	int	d;
+
+	for(d = p->lev; d >= 0; --d)
+		if(p->pos[d] < p->node[d]->size)
+			return p->node[d]->link[p->pos[d]];
+	return NIL(Dtlink_t*);
+}
+
+/* move from the end of a node to the object after it */
+static Dtlink_t* btnorm(Btpath_t* p)
+{
+	for(; p->lev >= 0; p->lev -= 1)
+		if(p->pos[p->lev] < p->node[p->lev]->size)
+			return BTLINK(p);
+	return NIL(Dtlink_t*);
+}
+
+/* move to the object before a leaf position */
+static Dtlink_t* btback(Btpath_t* p)
+{
+	for(; p->lev >= 0; p->lev -= 1)
+	{	if(p->pos[p->lev] > 0)
+		{	p->pos[p->lev] -= 1;
+			return BTLINK(p);
+		}
+	}
+	return NIL(Dtlink_t*);
+}
+
+static Dtlink_t* btnext(Btpath_t* p)
+{
+	Btnode_t	*nd = p->node[p->lev];
+
+	p->pos[p->lev] += 1;
+	if(!nd->leaf) /* to the first object of the next subtree */
+	{	for(nd = nd->kid[p->pos[p->lev]];; nd = nd->kid[0])
+		{	p->lev += 1;
+			p->node[p->lev] = nd;
+			p->pos[p->lev] = 0;
+			if(nd->leaf)
+				break;
+		}
+	}
+	return btnorm(p);
+}
+
+static Dtlink_t* btprev(Btpath_t* p)
+{
+	Btnode_t	*nd = p->node[p->lev];
+
+	if(!nd->leaf) /* to the last object of the subtree before */
+	{	for(nd = nd->kid[p->pos[p->lev]];; nd = nd->kid[nd->size])
+		{	p->lev += 1;
+			p->node[p->lev] = nd;
+			p->pos[p->lev] = nd->size;
+			if(nd->leaf)
+				break;
+		}
+	}
+	return btback(p);
+}
+
+/* move to the first or last object */
+static Dtlink_t* btend(Dt_t* dt, Btpath_t* p, int last)
+{
+	Btnode_t	*nd;
+
+	p->lev = -1;
+	for(nd = ((Dtbtree_t*)dt->data)->root; nd; nd = nd->leaf ? NIL(Btnode_t*) : nd->kid[last ? nd->size : 0])
+	{	p->lev += 1;
+		p->node[p->lev] = nd;
+		p->pos[p->lev] = last ? nd->size : 0;
+	}
+	return last ? btback(p) : btnorm(p);
+}
+
+/* position at an object matching key, preferring obj itself in a bag.
+** DT_REMOVE, DT_NEXT and DT_PREV only take obj in a bag. If there is none,
+** return NIL with p at the first object greater than key if any.
+*/
+static Dtlink_t* btlocate(Dt_t* dt, Btpath_t* p, Void_t* key, Void_t* obj, int type)
+{
+	Dtlink_t	*l;
+	Dtdisc_t	*disc = dt->disc;
+
+	if(!(dt->meth->type&DT_BTBAG) )
+	{	if(btfind(dt, p, key, BT_STOP) )
+			l = BTLINK(p);
+		else if(!(l = btnorm(p)) || BTCMP(dt, key, l, disc) != 0)
+			return NIL(Dtlink_t*);
+		return ((type&DT_REMOVE) && _DTOBJ(disc,l) != obj) ? NIL(Dtlink_t*) : l;
+	}
+
+	(void)btfind(dt, p, key, 0);
+	for(l = btnorm(p); l && BTCMP(dt, key, l, disc) == 0; l = btnext(p))
+		if(_DTOBJ(disc,l) == obj)
+			return l;
+	if(type&(DT_REMOVE|DT_NEXT|DT_PREV))
+		return NIL(Dtlink_t*);
+
+	(void)btfind(dt, p, key, 0); /* any equal object, the first */
+	return ((l = btnorm(p)) && BTCMP(dt, key, l, disc) == 0) ? l : NIL(Dtlink_t*);
+}
+
+/* insert a link at the leaf position p, splitting full nodes upward */
+static int btinsert(Dt_t* dt, Btpath_t* p, Dtlink_t* link)
+{
+	int		d, i, h, n, right;
+	Btnode_t	*nd, *rt, *kid, *new[BT_DEPTH+1];
+	Dtbtree_t	*bt = (Dtbtree_t*)dt->data;
+
+	/* get all nodes for splitting first so a failure changes nothing */
+	for(n = 0, d = p->lev; d >= 0 && p->node[d]->size == BT_MAX; --d)
+		if(!(new[n++] = btnode(dt, p->node[d]->leaf)) )
+			goto no_node;
+	if(d < 0 && (bt->depth >= BT_DEPTH || !(new[n++] = btnode(dt, 0))) )
+		goto no_node;
+
+	/* appending along the right edge packs the nodes left behind */
+	for(right = 1, d = p->lev; d >= 0; --d)
+		if(p->pos[d] != p->node[d]->size)
+			right = 0;
+
+	for(n = 0, kid = NIL(Btnode_t*), d = p->lev;; --d)
+	{	nd = p->node[d];
+		i = p->pos[d];
+		memmove(nd->link+i+1, nd->link+i, (nd->size-i)*sizeof(Dtlink_t*));
+		nd->link[i] = link;
+		if(kid)
+		{	memmove(nd->kid+i+2, nd->kid+i+1, (nd->size-i)*sizeof(Btnode_t*));
+			nd->kid[i+1] = kid;
+		}
+		if((nd->size += 1) <= BT_MAX)
+			return 0;
+
+		/* the object at h goes up, those after it go to a new node */
+		h = right ? BT_MAX-1 : BT_MAX/2;
+		rt = new[n++];
+		rt->size = nd->size - h - 1;
+		memcpy(rt->link, nd->link+h+1, rt->size*sizeof(Dtlink_t*));
+		if(!nd->leaf)
+			memcpy(rt->kid, nd->kid+h+1, (rt->size+1)*sizeof(Btnode_t*));
+		nd->size = h;
+		link = nd->link[h];
+		kid = rt;
+
+		if(d == 0) /* tree grows a level */
+		{	rt = new[n];
+			rt->size = 1;
+			rt->link[0] = link;
+			rt->kid[0] = nd;
+			rt->kid[1] = kid;
+			bt->root = rt;
+			bt->depth += 1;
+			return 0;
+		}
+	}
+
+no_node:
+	while(--n >= 0)
+		if(new[n])
+			(void)(*dt->memoryf)(dt, (Void_t*)new[n], 0, dt->disc);
+	return -1;
+}
+
+/* delete the object at p, merging or balancing nodes that get too small */
+static Dtlink_t* btdelete(Dt_t* dt, Btpath_t* p)
+{
+	int		d, i;
+	Dtlink_t	*link;
+	Btnode_t	*nd, *pa, *ls, *rs;
+	Dtbtree_t	*bt = (Dtbtree_t*)dt->data;
+
+	d = p->lev;
+	nd = p->node[d];
+	i = p->pos[d];
+	link = nd->link[i];
+	if(!nd->leaf) /* replace by the last object of the subtree before */
+	{	for(pa = nd, nd = nd->kid[i];; nd = nd->kid[nd->size])
+		{	p->node[d += 1] = nd;
+			p->pos[d] = nd->size;
+			if(nd->leaf)
+				break;
+		}
+		pa->link[i] = nd->link[nd->size-1];
+		i = nd->size-1;
+	}
+	memmove(nd->link+i, nd->link+i+1, (nd->size-i-1)*sizeof(Dtlink_t*));
+	nd->size -= 1;
+
+	for(; d > 0 && nd->size < BT_MIN; nd = pa, d -= 1)
+	{	pa = p->node[d-1];
+		i = p->pos[d-1]; /* nd is pa->kid[i] */
+		ls = i > 0 ? pa->kid[i-1] : NIL(Btnode_t*);
+		rs = i < pa->size ? pa->kid[i+1] : NIL(Btnode_t*);
+		if(ls && ls->size > BT_MIN) /* take one from the left */
+		{	memmove(nd->link+1, nd->link, nd->size*sizeof(Dtlink_t*));
+			nd->link[0] = pa->link[i-1];
+			if(!nd->leaf)
+			{	memmove(nd->kid+1, nd->kid, (nd->size+1)*sizeof(Btnode_t*));
+				nd->kid[0] = ls->kid[ls->size];
+			}
+			nd->size += 1;
+			pa->link[i-1] = ls->link[ls->size -= 1];
+			break;
+		}
+		else if(rs && rs->size > BT_MIN) /* take one from the right */
+		{	nd->link[nd->size] = pa->link[i];
+			if(!nd->leaf)
+				nd->kid[nd->size+1] = rs->kid[0];
+			nd->size += 1;
+			pa->link[i] = rs->link[0];
+			rs->size -= 1;
+			memmove(rs->link, rs->link+1, rs->size*sizeof(Dtlink_t*));
+			if(!rs->leaf)
+				memmove(rs->kid, rs->kid+1, (rs->size+1)*sizeof(Btnode_t*));
+			break;
+		}
+		else /* merge pa->kid[i] and pa->kid[i+1] around pa->link[i] */
+		{	if(ls)
+			{	rs = nd;
+				nd = ls;
+				i -= 1;
+			}
+			nd->link[nd->size] = pa->link[i];
+			memcpy(nd->link+nd->size+1, rs->link, rs->size*sizeof(Dtlink_t*));
+			if(!nd->leaf)
+				memcpy(nd->kid+nd->size+1, rs->kid, (rs->size+1)*sizeof(Btnode_t*));
+			nd->size += rs->size + 1;
+			memmove(pa->link+i, pa->link+i+1, (pa->size-i-1)*sizeof(Dtlink_t*));
+			memmove(pa->kid+i+1, pa->kid+i+2, (pa->size-i-1)*sizeof(Btnode_t*));
+			pa->size -= 1;
+			(void)(*dt->memoryf)(dt, (Void_t*)rs, 0, dt->disc);
+		}
+	}
+
+	if(!(nd = bt->root)->leaf && nd->size == 0) /* tree loses a level */
+	{	bt->root = nd->kid[0];
+		bt->depth -= 1;
+		(void)(*dt->memoryf)(dt, (Void_t*)nd, 0, dt->disc);
+	}
+
+	return link;
+}
+
+/* build a packed tree from n links in order. Each level spreads its
+** objects evenly over as few nodes as possible with one object between
+** nodes going up to the next level as a separator.
+*/
+static int btbuild(Dt_t* dt, Dtlink_t* list, ssize_t n)
+{
+	ssize_t		m, z, s, e, i, k, x;
+	int		leaf, depth;
+	Dtlink_t	*l, **obj;
+	Btnode_t	*nd, **kid;
+	Dtbtree_t	*bt = (Dtbtree_t*)dt->data;
+
+	if(!(obj = (Dtlink_t**)(*dt->memoryf)(dt, NIL(Void_t*), n*sizeof(Dtlink_t*), dt->disc)) )
+		return -1;
+	if(!(kid = (Btnode_t**)(*dt->memoryf)(dt, NIL(Void_t*), (n/(BT_MAX+1) + 2)*sizeof(Btnode_t*), dt->disc)) )
+	{	(void)(*dt->memoryf)(dt, (Void_t*)obj, 0, dt->disc);
+		return -1;
+	}
+	for(i = 0, l = list; l; l = l->_rght)
+		obj[i++] = l;
+
+	/* kid[i..] are the subtrees yet to be taken in, never behind kid[k] */
+	for(m = n, leaf = 1, depth = 1;; m = z-1, leaf = 0, depth += 1)
+	{	z = (m + 1 + BT_MAX)/(BT_MAX+1);
+		s = (m - (z-1))/z;
+		e = (m - (z-1))%z;
+		for(i = k = 0; k < z; ++k)
+		{	if(!(nd = btnode(dt, leaf)) )
+			{	for(x = 0; x < k; ++x)
+					btfree(dt, kid[x], 0);
+				for(x = i; !leaf && x <= m; ++x)
+					btfree(dt, kid[x], 0);
+				(void)(*dt->memoryf)(dt, (Void_t*)kid, 0, dt->disc);
+				(void)(*dt->memoryf)(dt, (Void_t*)obj, 0, dt->disc);
+				return -1;
+			}
+			nd->size = (int)(s + (k < e ? 1 : 0));
+			memcpy(nd->link, obj+i, nd->size*sizeof(Dtlink_t*));
+			if(!leaf)
+				memcpy(nd->kid, kid+i, (nd->size+1)*sizeof(Btnode_t*));
+			i += nd->size;
+			if(k < z-1) /* separator to the next level */
+				obj[k] = obj[i++];
+			kid[k] = nd;
+		}
+		if(z == 1)
+			break;
+	}
+
+	if(bt->root)
+		btfree(dt, bt->root, 0);
+	bt->root = kid[0];
+	bt->depth = depth;
+
+	(void)(*dt->memoryf)(dt, (Void_t*)kid, 0, dt->disc);
+	(void)(*dt->memoryf)(dt, (Void_t*)obj, 0, dt->disc);
+	return 0;
+}
+
+static Void_t* btclear(Dt_t* dt)
+{
+	Dtbtree_t	*bt = (Dtbtree_t*)dt->data;
+
+	if(bt->root)
+		btfree(dt, bt->root, DT_DELETE);
+	bt->root = NIL(Btnode_t*);
+	bt->depth = 0;
+	bt->here.lev = -1;
+	bt->data.size = 0;
+
+	return NIL(Void_t*);
+}
+
+static Void_t* btlist(Dt_t* dt, Dtlink_t* list, int type)
+{
+	ssize_t		n;
+	Void_t		*obj;
+	Dtlink_t	*l, *next, *head, *tail;
+	Btpath_t	path;
+	Dtdisc_t	*disc = dt->disc;
+	Dtbtree_t	*bt = (Dtbtree_t*)dt->data;
+
+	if(type&(DT_FLATTEN|DT_EXTRACT) )
+	{	/* links are not part of the tree so flattening changes nothing */
+		head = tail = NIL(Dtlink_t*);
+		for(l = btend(dt, &path, 0); l; l = btnext(&path))
+		{	if(tail)
+				tail = (tail->_rght = l);
+			else	head = tail = l;
+		}
+		if(tail)
+			tail->_rght = NIL(Dtlink_t*);
+
+		if(type&DT_EXTRACT)
+		{	if(bt->root)
+				btfree(dt, bt->root, 0);
+			bt->root = NIL(Btnode_t*);
+			bt->depth = 0;
+			bt->here.lev = -1;
+			bt->data.size = 0;
+		}
+		return (Void_t*)head;
+	}
+	else /* if(type&DT_RESTORE) */
+	{	/* a list in order, e.g., from an ordered method, is built packed */
+		for(n = 0, l = list; l; l = l->_rght, n += 1)
+		{	if((next = l->_rght) &&
+			   _DTCMP(dt, _DTKEY(disc,_DTOBJ(disc,l)), _DTKEY(disc,_DTOBJ(disc,next)), disc) >=
+				((dt->meth->type&DT_BTBAG) ? 1 : 0) )
+				break;
+		}
+		if(!l && n > 0 && (!bt->root || bt->root->size == 0) && btbuild(dt, list, n) >= 0)
+		{	bt->here.lev = -1;
+			bt->data.size = n;
+			return (Void_t*)list;
+		}
+
+		dt->data->size = 0;
+		for(l = list; l; l = next)
+		{	next = l->_rght;
+			obj = _DTOBJ(disc,l);
+			if((*dt->meth->searchf)(dt, (Void_t*)l, DT_RELINK) == obj)
+				dt->data->size += 1;
+		}
+		return (Void_t*)list;
+	}
+}
+
+static void btcount(Btnode_t* nd, ssize_t lev, Dtstat_t* st)
+{
+	int	i;
+
+	st->space += nd->leaf ? BTLEAF : sizeof(Btnode_t);
+	st->mlev = lev+1 > st->mlev ? lev+1 : st->mlev;
+	if(lev < DT_MAXSIZE)
+	{	st->msize = lev+1 > st->msize ? lev+1 : st->msize;
+		st->lsize[lev] += nd->size;
+		st->tsize[lev] += 1;
+	}
+	if(!nd->leaf)
+		for(i = 0; i <= nd->size; ++i)
+			btcount(nd->kid[i], lev+1, st);
+}
+
+static Void_t* btstat(Dt_t* dt, Dtstat_t* st)
+{
+	Dtbtree_t	*bt = (Dtbtree_t*)dt->data;
+
+	if(st)
+	{	memset(st, 0, sizeof(Dtstat_t));
+		st->meth  = dt->meth->type;
+		st->size  = bt->data.size;
+		st->space = sizeof(Dtbtree_t) + (dt->disc->link >= 0 ? 0 : bt->data.size*sizeof(Dthold_t));
+		if(bt->root)
+			btcount(bt->root, 0, st);
+	}
+
+	return (Void_t*)bt->data.size;
+}
+
+#if __STD_C
+static Void_t* dtbtree(Dt_t* dt, Void_t* obj, int type)
+#else
+static Void_t* dtbtree(dt,obj,type)
+Dt_t*	dt;
+Void_t*	obj;
+int	type;
+#endif
+{
+	int		lk, cmp;
+	Void_t		*key, *o;
+	Dtlink_t	*me, *l, *r;
+	Btpath_t	path, *p;
+	Dtdisc_t	*disc = dt->disc;
+	Dtbtree_t	*bt = (Dtbtree_t*)dt->data;
+
+	type = DTTYPE(dt,type); /* map type for upward compatibility */
+	if(!(type&DT_OPERATIONS) )
+		return NIL(Void_t*);
+
+	/* searches change nothing in share mode, not even the finger */
+	if(type&(DT_SEARCH|DT_MATCH|DT_ATLEAST|DT_ATMOST))
+		lk = DT_LKSHARE;
+	else	lk = (type&DT_RELINK) ? 0 : DT_LKALONE;
+	DTSETLOCK(dt,lk);
+	p = lk == DT_LKSHARE ? &path : &bt->here;
+
+	if(type&(DT_FIRST|DT_LAST) )
+	{	l = btend(dt, p, type&DT_LAST);
+		DTRETURN(obj, l ? _DTOBJ(disc,l) : NIL(Void_t*));
+	}
+	else if(type&(DT_EXTRACT|DT_RESTORE|DT_FLATTEN))
+		DTRETURN(obj, btlist(dt, (Dtlink_t*)obj, type));
+	else if(type&DT_CLEAR)
+		DTRETURN(obj, btclear(dt));
+	else if(type&DT_STAT)
+		DTRETURN(obj, btstat(dt, (Dtstat_t*)obj));
+
+	if(!obj) /* from here on, an object prototype is required */
+		DTRETURN(obj, NIL(Void_t*));
+
+	if((type&(DT_NEXT|DT_PREV)) && p->lev >= 0 && _DTOBJ(disc,BTLINK(p)) == obj)
+	{	l = (type&DT_NEXT) ? btnext(p) : btprev(p);
+		DTRETURN(obj, l ? _DTOBJ(disc,l) : NIL(Void_t*));
+	}
+
+	if(type&DT_RELINK)
+	{	me = (Dtlink_t*)obj;
+		obj = _DTOBJ(disc,me);
+		key = _DTKEY(disc,obj);
+	}
+	else
+	{	me = NIL(Dtlink_t*);
+		if(type&DT_MATCH)
+		{	key = obj;
+			obj = NIL(Void_t*);
+		}
+		else	key = _DTKEY(disc,obj);
+	}
+
+	if(!bt->root)
+	{	if(!(type&(DT_INSERT|DT_APPEND|DT_ATTACH|DT_RELINK)) )
+			DTRETURN(obj, NIL(Void_t*));
+		if(!(bt->root = btnode(dt, 1)) )
+			DTRETURN(obj, NIL(Void_t*));
+		bt->depth = 1;
+	}
+
+	if(type&(DT_SEARCH|DT_MATCH))
+	{	if(btfind(dt, p, key, (dt->meth->type&DT_BTBAG) ? 0 : BT_STOP) )
+			l = BTLINK(p);
+		else if((l = btnorm(p)) && BTCMP(dt, key, l, disc) != 0)
+			l = NIL(Dtlink_t*);
+	}
+	else if(type&DT_ATLEAST) /* the last equal object or the first after */
+	{	(void)btfind(dt, p, key, BT_UPPER);
+		r = (l = btnorm(p)) ? btprev(p) : btend(dt, p, 1);
+		if(r && BTCMP(dt, key, r, disc) == 0)
+			l = r;
+	}
+	else if(type&DT_ATMOST) /* the first equal object or the last before */
+	{	(void)btfind(dt, p, key, 0);
+		if(!(l = btnorm(p)) )
+			l = btend(dt, p, 1);
+		else if(BTCMP(dt, key, l, disc) != 0)
+			l = btprev(p);
+	}
+	else if(type&(DT_NEXT|DT_PREV))
+	{	if((l = btlocate(dt, p, key, obj, type)) )
+			l = (type&DT_NEXT) ? btnext(p) : btprev(p);
+		else if(type&DT_NEXT) /* p is at the first object after key */
+			l = p->lev >= 0 ? BTLINK(p) : NIL(Dtlink_t*);
+		else
+		{	(void)btfind(dt, p, key, 0);
+			l = btnorm(p) ? btprev(p) : btend(dt, p, 1);
+		}
+	}
+	else if(type&(DT_DELETE|DT_DETACH|DT_REMOVE))
+	{	if((l = btlocate(dt, p, key, obj, type)) )
+		{	l = btdelete(dt, p);
+			bt->data.size -= 1;
+			bt->here.lev = -1;
+			o = _DTOBJ(disc,l);
+			_dtfree(dt, l, type);
+			DTRETURN(obj, o);
+		}
+	}
+	else /* if(type&(DT_INSERT|DT_APPEND|DT_ATTACH|DT_RELINK)) */
+	{	l = NIL(Dtlink_t*);
+		if((r = btend(dt, p, 1)) && (cmp = BTCMP(dt, key, r, disc)) >= 0)
+		{	if(cmp == 0 && !(dt->meth->type&DT_BTBAG) )
+				l = r;
+			else	p->pos[p->lev] += 1; /* objects in order go last without a search */
+		}
+		else if(!(dt->meth->type&DT_BTBAG) )
+		{	if(btfind(dt, p, key, BT_STOP) || ((r = btpeek(p)) && BTCMP(dt, key, r, disc) == 0 && btnorm(p)) )
+				l = BTLINK(p);
+		}
+		else	(void)btfind(dt, p, key, BT_UPPER); /* after equal objects */
+
+		if(l) /* a set keeps the object it has */
+		{	if(type&DT_RELINK)
+				_dtfree(dt, me, DT_DELETE);
+			else	type |= DT_SEARCH; /* for announcement */
+			DTRETURN(obj, _DTOBJ(disc,l));
+		}
+
+		if(!me && !(me = _dtmake(dt, obj, type)) )
+			l = NIL(Dtlink_t*);
+		else if(btinsert(dt, p, me) < 0)
+		{	if(!(type&DT_RELINK) )
+				_dtfree(dt, me, (!(type&DT_ATTACH) && disc->makef) ? DT_DELETE : DT_DETACH);
+			l = NIL(Dtlink_t*);
+		}
+		else
+		{	if(!(type&DT_RELINK) )
+				bt->data.size += 1;
+			l = me;
+		}
+		bt->here.lev = -1;
+	}
+
+	DTRETURN(obj, l ? _DTOBJ(disc,l) : NIL(Void_t*));
+
+dt_return:
+	DTANNOUNCE(dt,obj,type);
+	DTCLRLOCK(dt,lk);
+	return obj;
+}
+
+static int btevent(Dt_t* dt, int event, Void_t* arg)
+{
+	Dtbtree_t	*bt = (Dtbtree_t*)dt->data;
+
+	if(event == DT_OPEN)
+	{	if(bt) /* already initialized */
+			return 0;
+		if(!(bt = (Dtbtree_t*)(*dt->memoryf)(dt, 0, sizeof(Dtbtree_t), dt->disc)) )
+		{	DTERROR(dt, "Error in allocating a B-tree");
+			return -1;
+		}
+		memset(bt, 0, sizeof(Dtbtree_t));
+		bt->here.lev = -1;
+		dt->data = (Dtdata_t*)bt;
+		return 1;
+	}
+	else if(event == DT_CLOSE)
+	{	if(!bt)
+			return 0;
+		(void)btclear(dt);
+		(void)(*dt->memoryf)(dt, (Void_t*)bt, 0, dt->disc);
+		dt->data = NIL(Dtdata_t*);
+		return 0;
+	}
+	else	return 0;
+}
+
+static Dtmethod_t	_Dtbtset = { dtbtree, DT_BTSET, btevent, "Dtbtset" };
+static Dtmethod_t	_Dtbtbag = { dtbtree, DT_BTBAG, btevent, "Dtbtbag" };
+__DEFINE__(Dtmethod_t*,Dtbtset,&_Dtbtset);
+__DEFINE__(Dtmethod_t*,Dtbtbag,&_Dtbtbag);
+
+#ifdef NoF
+NoF(dtbtree)
+#endif
@@ -32,6 +32,16 @@
 
 #define HLOAD(n)	(n)	/* load one-to-one	*/
 
+/* In DT_SHARE mode, operations on single objects hold the dictionary lock
+** shared and lock the stripe of their table slot. Anything changing the
+** table as a whole or walking it holds the dictionary lock alone.
+*/
+#define HSHARE		(DT_SEARCH|DT_MATCH|DT_ATLEAST|DT_ATMOST| \
+			 DT_INSERT|DT_APPEND|DT_ATTACH|DT_DELETE|DT_DETACH|DT_REMOVE)
+#define HSTRIPE		64	/* number of slot locks, a power of 2	*/
+#define HSPREAD		16	/* ints between locks, a cache line	*/
+#define HLOCK(h,s)	((h)->hlck + ((s)&(HSTRIPE-1))*HSPREAD)
+
 /* internal data structure for hash table with chaining */
 typedef struct _dthash_s
 {	Dtdata_t	data;
@@ -39,6 +49,7 @@ typedef struct _dthash_s
 	Dtlink_t*	here;	/* fingered object	*/
 	Dtlink_t**	htbl;	/* hash table slots 	*/
 	ssize_t		tblz;	/* size of hash table 	*/
+	unsigned int*	hlck;	/* slot locks for DT_SHARE	*/
 } Dthash_t;
 
 /* make/resize hash table */
@@ -255,6 +266,8 @@ Void_t*	obj;
 int	type;
 #endif
 {
+	int		lk;
+	unsigned int	*slk;
 	Dtlink_t	*lnk, *pp, *ll, *p, *l, **tbl;
 	Void_t		*key, *k, *o;
 	uint		hsh;
@@ -265,7 +278,17 @@ int	type;
 	if(!(type&DT_OPERATIONS) )
 		return NIL(Void_t*);
 
-	DTSETLOCK(dt);
+	slk = NIL(unsigned int*);
+	lk = (type&DT_RELINK) ? 0 : (type&HSHARE) ? DT_LKSHARE : DT_LKALONE;
+	DTSETLOCK(dt,lk);
+
+	if(lk == DT_LKSHARE && (!hash->htbl || !hash->hlck || (hash->type&H_FLATTEN) ||
+	   ((type&(DT_INSERT|DT_APPEND|DT_ATTACH)) && !(hash->type&H_FIXED) &&
+	    hash->tblz < HLOAD((ssize_t)asogetsize(&hash->data.size)) ) ) )
+	{	DTCLRLOCK(dt,lk); /* table must be made or changed first */
+		lk = DT_LKALONE;
+		DTSETLOCK(dt,lk);
+	}
 
 	if(!hash->htbl && htable(dt) < 0 ) /* initialize hash table */
 		DTRETURN(obj, NIL(Void_t*));
@@ -284,8 +307,12 @@ int	type;
 			DTRETURN(obj, hlist(dt, (Dtlink_t*)obj, type));
 	}
 
-	lnk = hash->here; /* fingered object */
-	hash->here = NIL(Dtlink_t*);
+	if(dt->data->type&DT_SHARE) /* other threads may have removed it */
+		lnk = NIL(Dtlink_t*);
+	else
+	{	lnk = hash->here; /* fingered object */
+		hash->here = NIL(Dtlink_t*);
+	}
 
 	if(lnk && obj == _DTOBJ(disc,lnk))
 	{	if(type&DT_SEARCH)
@@ -310,6 +337,9 @@ int	type;
 	hsh = _DTHSH(dt,key,disc);
 
 	tbl = hash->htbl + (hsh & (hash->tblz-1));
+	if(lk == DT_LKSHARE) /* table is stable, lock just this slot */
+		asolock((slk = HLOCK(hash, hsh & (hash->tblz-1))), 1, ASO_SPINLOCK);
+
 	pp = ll = NIL(Dtlink_t*);
 	for(p = NIL(Dtlink_t*), l = *tbl; l; p = l, l = l->_rght)
 	{	if(hsh == l->_hash)
@@ -329,13 +359,16 @@ int	type;
 
 	if(ll) /* found object */
 	{	if(type&(DT_SEARCH|DT_MATCH|DT_ATLEAST|DT_ATMOST) )
-		{	hash->here = ll;
+		{	if(!slk)
+				hash->here = ll;
 			DTRETURN(obj, _DTOBJ(disc,ll));
 		}
 		else if(type & (DT_NEXT|DT_PREV) )
 			DTRETURN(obj, hnext(dt, ll));
 		else if(type & (DT_DELETE|DT_DETACH|DT_REMOVE) )
-		{	hash->data.size -= 1;
+		{	if(slk)
+				asodecsize(&hash->data.size);
+			else	hash->data.size -= 1;
 			if(pp)
 				pp->_rght = ll->_rght;
 			else	*tbl = ll->_rght;
@@ -359,7 +392,7 @@ int	type;
 			DTRETURN(obj, NIL(Void_t*));
 
 	do_insert: /* inserting a new object */
-		if(hash->tblz < HLOAD(hash->data.size) )
+		if(!slk && hash->tblz < HLOAD(hash->data.size) )
 		{	htable(dt); /* resize table */
 			tbl = hash->htbl + (hsh & (hash->tblz-1));
 		}
@@ -367,19 +400,24 @@ int	type;
 		if(!lnk) /* inserting a new object */
 		{	if(!(lnk = _dtmake(dt, obj, type)) )
 				DTRETURN(obj, NIL(Void_t*));
-			hash->data.size += 1;
+			if(slk)
+				asoincsize(&hash->data.size);
+			else	hash->data.size += 1;
 		}
 
 		lnk->_hash = hsh; /* memoize the hash value */
 		lnk->_rght = *tbl; *tbl = lnk;
 
-		hash->here = lnk;
+		if(!slk)
+			hash->here = lnk;
 		DTRETURN(obj, _DTOBJ(disc,lnk));
 	}
 
 dt_return:
 	DTANNOUNCE(dt, obj, type);
-	DTCLRLOCK(dt);
+	if(slk)
+		asolock(slk, 1, ASO_UNLOCK);
+	DTCLRLOCK(dt,lk);
 	return obj;
 }
 
@@ -405,10 +443,23 @@ static int hashevent(Dt_t* dt, int event, Void_t* arg)
 			(void)hclear(dt);
 		if(hash->htbl)
 			(void)(*dt->memoryf)(dt, hash->htbl, 0, dt->disc);
+		if(hash->hlck)
+			(void)(*dt->memoryf)(dt, hash->hlck, 0, dt->disc);
 		(void)(*dt->memoryf)(dt, hash, 0, dt->disc);
 		dt->data = NIL(Dtdata_t*);
 		return 0;
 	}
+	else if(event == DT_SHARE)
+	{	if((long)arg > 0 && !hash->hlck)
+		{	if(!(hash->hlck = (unsigned int*)(*dt->memoryf)(dt, 0, HSTRIPE*HSPREAD*sizeof(unsigned int), dt->disc)) )
+			{	DTERROR(dt, "Error in allocating hash table locks");
+				return -1;
+			}
+			memset(hash->hlck, 0, HSTRIPE*HSPREAD*sizeof(unsigned int));
+		}
+		hash->here = NIL(Dtlink_t*); /* fingers are not kept in share mode */
+		return 0;
+	}
 	else	return 0;
 }
 
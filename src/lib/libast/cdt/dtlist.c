@@ -168,6 +168,7 @@ Void_t*	obj;
 int	type;
 #endif
 {
+	int		lk;
 	Dtlink_t	*r, *t, *h;
 	Void_t		*key, *o, *k;
 	Dtdisc_t	*disc = dt->disc;
@@ -177,7 +178,8 @@ int	type;
 	if(!(type&DT_OPERATIONS) )
 		return NIL(Void_t*);
 
-	DTSETLOCK(dt);
+	lk = DT_LKALONE;
+	DTSETLOCK(dt,lk);
 
 	if(type&(DT_FIRST|DT_LAST) )
 		DTRETURN(obj, lfirstlast(dt, type));
@@ -330,7 +332,7 @@ int	type;
 
 dt_return:
 	DTANNOUNCE(dt,obj,type);
-	DTCLRLOCK(dt);
+	DTCLRLOCK(dt,lk);
 	return obj;
 }
 
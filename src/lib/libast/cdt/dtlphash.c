@@ -0,0 +1,544 @@
+/***********************************************************************
+*                                                                      *
+*               This software is part of the ast package               *
+*          Copyright (c) 1985-2012 AT&T Intellectual Property          *
+*                      and is licensed under the                       *
+*                 Eclipse Public License, Version 1.0                  *
+*                    by AT&T Intellectual Property                     *
+*                                                                      *
+*                A copy of the License is available at                 *
+*          http://www.eclipse.org/org/documents/epl-v10.html           *
+*         (with md5 checksum b35adb5213ca9657e911e9befb180842)         *
+*                                                                      *
+*              Information and Software Systems Research               *
+*                            AT&T Research                             *
+*                           Florham Park NJ                            *
+*                                                                      *
+*                 Glenn Fowler <gsf@research.att.com>                  *
+*                  David Korn <dgk@research.att.com>                   *
+*                   Phong Vo <kpv@research.att.com>                    *
+*                                                                      *
+***********************************************************************/
+#include	"dthdr.h"
+
+/*	Hash table with open addressing.
+**	Slots hold the hash value of an object beside its link so that
+**	probes compare hash values in one flat array without touching the
+**	objects themselves. Collisions are resolved by linear probing with
+**	Robin Hood placement: an object farther from its home slot takes
+**	the slot of one nearer to its own. Deletion shifts the rest of a
+**	probe run back by one so there are no tombstones. A full table is
+**	doubled by moving a few slots of the old table on each insertion;
+**	until that is done, searches look in both tables.
+*/
+
+#define LP_MINBITS	4	/* smallest table has 1<<LP_MINBITS slots	*/
+#define LP_MOVE		32	/* old table slots moved per insertion	*/
+#define LPLOAD(z)	((z) - (z)/8) /* max #objects in a table of size z	*/
+
+/* home slot of a hash value. linear probing is hurt more than chaining
+** by hash functions with poor low bits, e.g., on addresses, so the value
+** is stirred a little and the high bits of the product are used.
+*/
+#define LPHOME(h,b)	((ssize_t)(((((uint)(h)) ^ (((uint)(h)) >> 15)) * 0x2c1b3c6d) >> (DT_NBITS-(b))))
+
+/* a slot of the old table that has been moved to the new table */
+static Dtlink_t		_Lpgone;
+#define LPGONE		(&_Lpgone)
+
+typedef struct _lpslot_s
+{	uint		hash;	/* hash value of object	*/
+	uint		dist;	/* 1 + distance from home, 0 if empty	*/
+	Dtlink_t*	link;	/* object, NIL if empty	*/
+} Lpslot_t;
+
+/* internal data structure for hash table with open addressing */
+typedef struct _dtlphash_s
+{	Dtdata_t	data;
+	Dtlink_t*	here;	/* fingered object	*/
+	Lpslot_t*	hslot;	/* and its slot		*/
+	Lpslot_t*	htbl;	/* hash table slots	*/
+	int		hbits;	/* log2 of table size	*/
+	ssize_t		walk;	/* an empty slot where walks begin */
+	Lpslot_t*	otbl;	/* table being moved to htbl	*/
+	int		obits;	/* log2 of its size	*/
+	ssize_t		omove;	/* its slots moved so far	*/
+} Dtlphash_t;
+
+#define LPOLD(h,s)	((h)->otbl && (s) >= (h)->otbl && (s) < (h)->otbl + (((ssize_t)1)<<(h)->obits) )
+
+/* put a link into a table, return the slot that takes it */
+static Lpslot_t* lpput(Lpslot_t* tbl, int bits, uint hsh, Dtlink_t* lnk)
+{
+	Lpslot_t	*s, *put;
+	Dtlink_t	*l;
+	uint		h, d, sd;
+	ssize_t		i, mask = (((ssize_t)1)<<bits) - 1;
+
+	put = NIL(Lpslot_t*);
+	for(i = LPHOME(hsh,bits), d = 1;; i = (i+1)&mask, d += 1)
+	{	s = tbl+i;
+		if(!s->link)
+		{	s->hash = hsh;
+			s->dist = d;
+			s->link = lnk;
+			return put ? put : s;
+		}
+		if((sd = s->dist) < d) /* take from the rich */
+		{	h = s->hash; l = s->link;
+			s->hash = hsh; s->dist = d; s->link = lnk;
+			hsh = h; lnk = l; d = sd;
+			if(!put)
+				put = s;
+		}
+	}
+}
+
+/* empty a slot and shift back the rest of its probe run */
+static void lpcut(Lpslot_t* tbl, int bits, Lpslot_t* s)
+{
+	ssize_t		i, k, mask = (((ssize_t)1)<<bits) - 1;
+
+	for(i = s-tbl;; i = k)
+	{	k = (i+1)&mask;
+		if(tbl[k].dist <= 1) /* empty or at home */
+			break;
+		tbl[i] = tbl[k];
+		tbl[i].dist -= 1;
+	}
+	tbl[i].dist = 0;
+	tbl[i].link = NIL(Dtlink_t*);
+}
+
+/* move up to n slots from the old table to the new one */
+static void lpmove(Dt_t* dt, ssize_t n)
+{
+	Lpslot_t	*s;
+	ssize_t		z;
+	Dtlphash_t	*hash = (Dtlphash_t*)dt->data;
+
+	if(!hash->otbl)
+		return;
+	for(z = ((ssize_t)1)<<hash->obits; n > 0 && hash->omove < z; --n, ++hash->omove)
+	{	s = hash->otbl + hash->omove;
+		if(s->link && s->link != LPGONE)
+		{	(void)lpput(hash->htbl, hash->hbits, s->hash, s->link);
+			s->link = LPGONE;
+		}
+	}
+	if(hash->omove >= z)
+	{	(void)(*dt->memoryf)(dt, hash->otbl, 0, dt->disc);
+		hash->otbl = NIL(Lpslot_t*);
+		hash->obits = 0;
+		hash->omove = 0;
+	}
+}
+
+/* make the initial table or start doubling the current one */
+static int lptable(Dt_t* dt)
+{
+	Lpslot_t	*tbl;
+	ssize_t		n, z;
+	int		b;
+	Dtdisc_t	*disc = dt->disc;
+	Dtlphash_t	*hash = (Dtlphash_t*)dt->data;
+
+	if(hash->otbl) /* finish the last doubling first */
+		lpmove(dt, ((ssize_t)1)<<hash->obits);
+
+	if(hash->htbl)
+		b = hash->hbits + 1;
+	else
+	{	n = 0;
+		if(disc && disc->eventf) /* let user have input */
+		{	if((*disc->eventf)(dt, DT_HASHSIZE, &n, disc) > 0 && n < 0)
+				n = -n;
+		}
+		for(b = LP_MINBITS; LPLOAD(((ssize_t)1)<<b) < n; )
+			b += 1;
+	}
+
+	z = ((ssize_t)1)<<b;
+	if(!(tbl = (Lpslot_t*)(*dt->memoryf)(dt, 0, z*sizeof(Lpslot_t), disc)) )
+	{	DTERROR(dt, "Error in allocating an extended hash table");
+		return -1;
+	}
+	memset(tbl, 0, z*sizeof(Lpslot_t));
+
+	hash->otbl = hash->htbl; /* old slots move over on insertions */
+	hash->obits = hash->hbits;
+	hash->omove = 0;
+	hash->htbl = tbl;
+	hash->hbits = b;
+	hash->walk = 0;
+
+	return 0;
+}
+
+/* find the slot of an object matching key, preferring obj itself */
+static Lpslot_t* lpfind(Dt_t* dt, uint hsh, Void_t* key, Void_t* obj, int type)
+{
+	Lpslot_t	*tbl, *ends, *s, *ms;
+	Void_t		*o;
+	uint		d;
+	int		b;
+	Dtdisc_t	*disc = dt->disc;
+	Dtlphash_t	*hash = (Dtlphash_t*)dt->data;
+
+	ms = NIL(Lpslot_t*);
+	for(tbl = hash->htbl, b = hash->hbits; tbl; tbl = tbl == hash->htbl ? hash->otbl : NIL(Lpslot_t*), b = hash->obits)
+	{	ends = tbl + (((ssize_t)1)<<b);
+		for(s = tbl + LPHOME(hsh,b), d = 1; s->dist >= d; d += 1) /* stop where key would be */
+		{	if(s->hash == hsh && s->link != LPGONE)
+			{	if((o = _DTOBJ(disc,s->link)) == obj)
+					return s;
+				if(_DTCMP(dt, key, _DTKEY(disc,o), disc) == 0)
+				{	if(!(type&(DT_REMOVE|DT_NEXT|DT_PREV)) )
+						return s;
+					if(!ms)
+						ms = s;
+				}
+			}
+			if((s += 1) == ends)
+				s = tbl;
+		}
+	}
+
+	return (type&DT_REMOVE) ? NIL(Lpslot_t*) : ms;
+}
+
+/* walks go around the new table from an empty slot then over the rest of
+** the old table. deleting the current object only shifts objects of its
+** own probe run, so a walk that deletes as it goes still sees each object once.
+*/
+static Void_t* lpnext(Dt_t* dt, Lpslot_t* s)
+{
+	ssize_t		i, mask;
+	Dtlphash_t	*hash = (Dtlphash_t*)dt->data;
+
+	if(!LPOLD(hash,s))
+	{	mask = (((ssize_t)1)<<hash->hbits) - 1;
+		if(hash->walk > mask)
+			hash->walk = 0;
+		for(i = ((s - hash->htbl) + 1)&mask; i != hash->walk; i = (i+1)&mask)
+		{	if(hash->htbl[i].link)
+			{	s = hash->htbl+i;
+				goto done;
+			}
+		}
+		if(!hash->otbl)
+			return NIL(Void_t*);
+		s = hash->otbl + hash->omove;
+	}
+	else	s += 1;
+
+	for(; s < hash->otbl + (((ssize_t)1)<<hash->obits); ++s)
+		if(s->link && s->link != LPGONE)
+			goto done;
+	return NIL(Void_t*);
+
+done:	hash->here = s->link;
+	hash->hslot = s;
+	return _DTOBJ(dt->disc, s->link);
+}
+
+static Void_t* lpfirst(Dt_t* dt)
+{
+	ssize_t		i, z;
+	Dtlphash_t	*hash = (Dtlphash_t*)dt->data;
+
+	if(hash->data.size <= 0)
+		return NIL(Void_t*);
+
+	lpmove(dt, ((ssize_t)1)<<hash->obits);
+	for(z = ((ssize_t)1)<<hash->hbits, i = 0; i < z; ++i)
+		if(!hash->htbl[i].link)
+			break;
+	hash->walk = i;
+	return lpnext(dt, hash->htbl+i);
+}
+
+static Void_t* lpclear(Dt_t* dt)
+{
+	Lpslot_t	*s, *ends;
+	Dtlphash_t	*hash = (Dtlphash_t*)dt->data;
+
+	hash->here = NIL(Dtlink_t*);
+	hash->data.size = 0;
+
+	if(hash->otbl)
+	{	for(ends = (s = hash->otbl) + (((ssize_t)1)<<hash->obits); s < ends; ++s)
+			if(s->link && s->link != LPGONE)
+				_dtfree(dt, s->link, DT_DELETE);
+		(void)(*dt->memoryf)(dt, hash->otbl, 0, dt->disc);
+		hash->otbl = NIL(Lpslot_t*);
+		hash->obits = 0;
+		hash->omove = 0;
+	}
+
+	for(ends = (s = hash->htbl) + (((ssize_t)1)<<hash->hbits); s < ends; ++s)
+	{	if(s->link)
+			_dtfree(dt, s->link, DT_DELETE);
+		s->dist = 0;
+		s->link = NIL(Dtlink_t*);
+	}
+
+	return NIL(Void_t*);
+}
+
+static Void_t* lplist(Dt_t* dt, Dtlink_t* list, int type)
+{
+	Void_t		*obj;
+	Lpslot_t	*s, *ends;
+	Dtlink_t	*l, *next, *head, *tail;
+	Dtdisc_t	*disc = dt->disc;
+	Dtlphash_t	*hash = (Dtlphash_t*)dt->data;
+
+	if(type&(DT_FLATTEN|DT_EXTRACT) )
+	{	lpmove(dt, ((ssize_t)1)<<hash->obits);
+
+		/* the slots keep their links so flattening is not destructive */
+		head = tail = NIL(Dtlink_t*);
+		for(ends = (s = hash->htbl) + (((ssize_t)1)<<hash->hbits); s < ends; ++s)
+		{	if(!(l = s->link) )
+				continue;
+			if(tail)
+				tail = (tail->_rght = l);
+			else	head = tail = l;
+			if(type&DT_EXTRACT)
+			{	s->dist = 0;
+				s->link = NIL(Dtlink_t*);
+			}
+		}
+		if(tail)
+			tail->_rght = NIL(Dtlink_t*);
+
+		if(type&DT_EXTRACT)
+		{	hash->here = NIL(Dtlink_t*);
+			hash->data.size = 0;
+		}
+		return (Void_t*)head;
+	}
+	else /* if(type&DT_RESTORE) */
+	{	dt->data->size = 0;
+		for(l = list; l; l = next)
+		{	next = l->_rght;
+			obj = _DTOBJ(disc,l);
+			if((*dt->meth->searchf)(dt, (Void_t*)l, DT_RELINK) == obj)
+				dt->data->size += 1;
+		}
+		return (Void_t*)list;
+	}
+}
+
+static Void_t* lpstat(Dt_t* dt, Dtstat_t* st)
+{
+	Lpslot_t	*s, *tbl;
+	ssize_t		i, n, z;
+	int		b;
+	Dtlphash_t	*hash = (Dtlphash_t*)dt->data;
+
+	if(st)
+	{	memset(st, 0, sizeof(Dtstat_t));
+		st->meth  = dt->meth->type;
+		st->size  = hash->data.size;
+		st->space = sizeof(Dtlphash_t) + (((ssize_t)1)<<hash->hbits)*sizeof(Lpslot_t) +
+			    (hash->otbl ? (((ssize_t)1)<<hash->obits)*sizeof(Lpslot_t) : 0) +
+			    (dt->disc->link >= 0 ? 0 : hash->data.size*sizeof(Dthold_t));
+
+		/* a level is the distance of an object from its home slot */
+		for(tbl = hash->htbl, b = hash->hbits; tbl; tbl = tbl == hash->htbl ? hash->otbl : NIL(Lpslot_t*), b = hash->obits)
+		{	st->tsize[0] += 1;
+			for(z = ((ssize_t)1)<<b, i = 0; i < z; ++i)
+			{	s = tbl+i;
+				if(!s->link || s->link == LPGONE)
+					continue;
+				n = s->dist - 1;
+				st->mlev = n+1 > st->mlev ? n+1 : st->mlev;
+				if(n < DT_MAXSIZE)
+				{	st->msize = n+1 > st->msize ? n+1 : st->msize;
+					st->lsize[n] += 1;
+				}
+			}
+		}
+	}
+
+	return (Void_t*)hash->data.size;
+}
+
+#if __STD_C
+static Void_t* dtlphash(Dt_t* dt, Void_t* obj, int type)
+#else
+static Void_t* dtlphash(dt,obj,type)
+Dt_t*	dt;
+Void_t*	obj;
+int	type;
+#endif
+{
+	int		lk;
+	Dtlink_t	*lnk;
+	Lpslot_t	*s;
+	Void_t		*key, *o;
+	uint		hsh;
+	Dtdisc_t	*disc = dt->disc;
+	Dtlphash_t	*hash = (Dtlphash_t*)dt->data;
+
+	type = DTTYPE(dt,type); /* map type for upward compatibility */
+	if(!(type&DT_OPERATIONS) )
+		return NIL(Void_t*);
+
+	/* in DT_SHARE mode, searches share the table and leave the finger alone */
+	lk = (type&DT_RELINK) ? 0 : (type&(DT_SEARCH|DT_MATCH|DT_ATLEAST|DT_ATMOST)) ? DT_LKSHARE : DT_LKALONE;
+	DTSETLOCK(dt,lk);
+
+	if(lk == DT_LKSHARE && !hash->htbl)
+	{	DTCLRLOCK(dt,lk);
+		lk = DT_LKALONE;
+		DTSETLOCK(dt,lk);
+	}
+
+	if(!hash->htbl && lptable(dt) < 0 ) /* initialize hash table */
+		DTRETURN(obj, NIL(Void_t*));
+
+	if(type&(DT_FIRST|DT_LAST|DT_CLEAR|DT_EXTRACT|DT_RESTORE|DT_FLATTEN|DT_STAT) )
+	{	hash->here = NIL(Dtlink_t*);
+		if(type&(DT_FIRST|DT_LAST) )
+			DTRETURN(obj, lpfirst(dt));
+		else if(type&DT_CLEAR)
+			DTRETURN(obj, lpclear(dt));
+		else if(type&DT_STAT)
+			DTRETURN(obj, lpstat(dt, (Dtstat_t*)obj));
+		else /*if(type&(DT_EXTRACT|DT_RESTORE|DT_FLATTEN))*/
+			DTRETURN(obj, lplist(dt, (Dtlink_t*)obj, type));
+	}
+
+	if(lk == DT_LKSHARE)
+		lnk = NIL(Dtlink_t*);
+	else
+	{	lnk = hash->here; /* fingered object */
+		hash->here = NIL(Dtlink_t*);
+	}
+
+	if(lnk && obj == _DTOBJ(disc,lnk))
+	{	if(type&DT_SEARCH)
+		{	hash->here = lnk;
+			DTRETURN(obj, obj);
+		}
+		else if(type&(DT_NEXT|DT_PREV) )
+			DTRETURN(obj, lpnext(dt, hash->hslot));
+	}
+
+	if(type&DT_RELINK)
+	{	lnk = (Dtlink_t*)obj;
+		obj = _DTOBJ(disc,lnk);
+		key = _DTKEY(disc,obj);
+	}
+	else 
+	{	lnk = NIL(Dtlink_t*);
+		if((type&DT_MATCH) )
+		{	key = obj;
+			obj = NIL(Void_t*);
+		}
+		else	key = _DTKEY(disc,obj);
+	}
+	hsh = _DTHSH(dt,key,disc);
+
+	if((s = lpfind(dt, hsh, key, obj, type)) ) /* found object */
+	{	if(type&(DT_SEARCH|DT_MATCH|DT_ATLEAST|DT_ATMOST) )
+		{	if(lk != DT_LKSHARE)
+			{	hash->here = s->link;
+				hash->hslot = s;
+			}
+			DTRETURN(obj, _DTOBJ(disc,s->link));
+		}
+		else if(type & (DT_NEXT|DT_PREV) )
+			DTRETURN(obj, lpnext(dt, s));
+		else if(type & (DT_DELETE|DT_DETACH|DT_REMOVE) )
+		{	hash->data.size -= 1;
+			lnk = s->link;
+			if(LPOLD(hash,s))
+				s->link = LPGONE;
+			else	lpcut(hash->htbl, hash->hbits, s);
+			o = _DTOBJ(disc,lnk);
+			_dtfree(dt, lnk, type);
+			DTRETURN(obj, o);
+		}
+		else
+		{	/**/DEBUG_ASSERT(type&(DT_INSERT|DT_ATTACH|DT_APPEND|DT_RELINK));
+			if(!(dt->meth->type&DT_LPBAG) )
+			{	if(type&(DT_INSERT|DT_APPEND|DT_ATTACH) )
+					type |= DT_SEARCH; /* for announcement */
+				else if(lnk && (type&DT_RELINK) )
+					_dtfree(dt, lnk, DT_DELETE);
+				DTRETURN(obj, _DTOBJ(disc,s->link));
+			}
+			else	goto do_insert;
+		}
+	}
+	else /* no matching object */
+	{	if(!(type&(DT_INSERT|DT_APPEND|DT_ATTACH|DT_RELINK)) )
+			DTRETURN(obj, NIL(Void_t*));
+
+	do_insert: /* inserting a new object */
+		if(hash->data.size >= LPLOAD(((ssize_t)1)<<hash->hbits) )
+		{	if(lptable(dt) < 0 && hash->data.size >= (((ssize_t)1)<<hash->hbits) - 1)
+				DTRETURN(obj, NIL(Void_t*));
+		}
+		else if(hash->otbl)
+			lpmove(dt, LP_MOVE);
+
+		if(!lnk) /* inserting a new object */
+		{	if(!(lnk = _dtmake(dt, obj, type)) )
+				DTRETURN(obj, NIL(Void_t*));
+			hash->data.size += 1;
+		}
+
+		lnk->_hash = hsh; /* memoize the hash value */
+		hash->hslot = lpput(hash->htbl, hash->hbits, hsh, lnk);
+		hash->here = lnk;
+		DTRETURN(obj, _DTOBJ(disc,lnk));
+	}
+
+dt_return:
+	DTANNOUNCE(dt, obj, type);
+	DTCLRLOCK(dt,lk);
+	return obj;
+}
+
+static int lphashevent(Dt_t* dt, int event, Void_t* arg)
+{
+	Dtlphash_t	*hash = (Dtlphash_t*)dt->data;
+
+	if(event == DT_OPEN)
+	{	if(hash)
+			return 0;
+		if(!(hash = (Dtlphash_t*)(*dt->memoryf)(dt, 0, sizeof(Dtlphash_t), dt->disc)) )
+		{	DTERROR(dt, "Error in allocating a hash table with open addressing");
+			return -1;
+		}
+		memset(hash, 0, sizeof(Dtlphash_t));
+		dt->data = (Dtdata_t*)hash;
+		return 1;
+	}
+	else if(event == DT_CLOSE)
+	{	if(!hash)
+			return 0;
+		if(hash->htbl)
+		{	(void)lpclear(dt);
+			(void)(*dt->memoryf)(dt, hash->htbl, 0, dt->disc);
+		}
+		(void)(*dt->memoryf)(dt, hash, 0, dt->disc);
+		dt->data = NIL(Dtdata_t*);
+		return 0;
+	}
+	else	return 0;
+}
+
+static Dtmethod_t	_Dtlpset = { dtlphash, DT_LPSET, lphashevent, "Dtlpset" };
+static Dtmethod_t	_Dtlpbag = { dtlphash, DT_LPBAG, lphashevent, "Dtlpbag" };
+__DEFINE__(Dtmethod_t*,Dtlpset,&_Dtlpset);
+__DEFINE__(Dtmethod_t*,Dtlpbag,&_Dtlpbag);
+
+#ifdef NoF
+NoF(dtlphash)
+#endif
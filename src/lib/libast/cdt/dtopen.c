@@ -154,6 +154,43 @@ void _dtfree(Dt_t* dt, Dtlink_t* l, int type)
 		(void)(*dt->memoryf)(dt, (Void_t*)l, 0, disc);
 }
 
+/* reader/writer spin lock on data->lock for DT_SHARE mode. A waiting writer
+** keeps new readers out so that a stream of searches cannot starve it.
+*/
+int _dtlock(Dt_t* dt, int type)
+{
+	unsigned int		lk, k;
+	unsigned int volatile	*lock = &dt->data->lock;
+
+	if(type == DT_LKSHARE)
+	{	for(k = 0;; ASOLOOP(k))
+			if(!((lk = *lock)&(DT_LKWRITE|DT_LKWAIT)) && asocasint(lock, lk, lk+1) == lk)
+				return 0;
+	}
+	else if(type == DT_LKALONE)
+	{	for(k = 0;; ASOLOOP(k))
+		{	if(((lk = *lock)&~DT_LKWAIT) == 0)
+			{	if(asocasint(lock, lk, DT_LKWRITE) == lk)
+					return 0;
+			}
+			else if(!(lk&DT_LKWAIT) )
+				asocasint(lock, lk, lk|DT_LKWAIT);
+		}
+	}
+	else if(type == -DT_LKSHARE)
+	{	asodecint(lock);
+		return 0;
+	}
+	else if(type == -DT_LKALONE) /* keep the mark of any waiting writer */
+	{	for(;;)
+		{	lk = *lock;
+			if(asocasint(lock, lk, lk&DT_LKWAIT) == lk)
+				return 0;
+		}
+	}
+	else	return -1;
+}
+
 int dtuserlock(Dt_t* dt, unsigned int key, int type)
 {
 	if(type > 0)
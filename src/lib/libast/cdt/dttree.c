@@ -282,6 +282,44 @@ static void toptimize(Dt_t* dt)
 	}
 }
 
+/* In DT_SHARE mode, DT_SEARCH and DT_MATCH descend the tree without splaying
+** so that they can hold the dictionary together. A descent much deeper than
+** a balanced tree would need returns -1 so that the search is redone alone
+** with splaying. That keeps the amortized bounds of splay trees.
+*/
+#define TSHAREDEPTH	8
+
+#if __STD_C
+static int tshare(Dt_t* dt, Void_t* key, Dtlink_t** found)
+#else
+static int tshare(dt, key, found)
+Dt_t*		dt;
+Void_t*		key;
+Dtlink_t**	found;
+#endif
+{
+	int		cmp, lev, max;
+	ssize_t		n;
+	Void_t		*o, *k;
+	Dtlink_t	*t;
+	Dtdisc_t	*disc = dt->disc;
+	Dttree_t	*tree = (Dttree_t*)dt->data;
+
+	for(max = TSHAREDEPTH, n = tree->data.size; n > 0; n >>= 1)
+		max += 2;
+
+	for(lev = 0, t = tree->root; t; t = cmp < 0 ? t->_left : t->_rght)
+	{	if((lev += 1) > max)
+			return -1;
+		o = _DTOBJ(disc,t); k = _DTKEY(disc,o);
+		if((cmp = _DTCMP(dt,key,k,disc)) == 0)
+			break;
+	}
+
+	*found = t;
+	return 0;
+}
+
 static Dtlink_t* troot(Dt_t* dt, Dtlink_t* list, Dtlink_t* link, Void_t* obj, int type)
 {
 	Dtlink_t	*root, *last, *t, *r, *l;
@@ -399,7 +437,7 @@ Void_t* 	obj;
 int		type;
 #endif
 {
-	int		cmp;
+	int		cmp, lk;
 	Void_t		*o, *k, *key;
 	Dtlink_t	*root, *t, *l, *r, *me, link;
 	Dtdisc_t	*disc = dt->disc;
@@ -409,7 +447,17 @@ int		type;
 	if(!(type&DT_OPERATIONS) )
 		return NIL(Void_t*);
 
-	DTSETLOCK(dt);
+	lk = (type&DT_RELINK) ? 0 : (type&(DT_SEARCH|DT_MATCH)) ? DT_LKSHARE : DT_LKALONE;
+	DTSETLOCK(dt,lk);
+
+	if(lk == DT_LKSHARE && obj) /* search along with other readers */
+	{	if(tshare(dt, (type&DT_MATCH) ? obj : _DTKEY(disc,obj), &me) == 0)
+			DTRETURN(obj, me ? _DTOBJ(disc,me) : NIL(Void_t*));
+
+		DTCLRLOCK(dt,lk); /* path too long, splay it */
+		lk = DT_LKALONE;
+		DTSETLOCK(dt,lk);
+	}
 
 	if(type&(DT_FIRST|DT_LAST) )
 		DTRETURN(obj, tfirstlast(dt, type));
@@ -632,12 +680,13 @@ int		type;
 
 dt_return:
 	DTANNOUNCE(dt,obj,type);
-	DTCLRLOCK(dt);
+	DTCLRLOCK(dt,lk);
 	return obj;
 }
 
 static int treeevent(Dt_t* dt, int event, Void_t* arg)
 {
+	int		lk;
 	Dttree_t	*tree = (Dttree_t*)dt->data;
 
 	if(event == DT_OPEN)
@@ -661,7 +710,10 @@ static int treeevent(Dt_t* dt, int event, Void_t* arg)
                 return 0;
 	}
 	else if(event == DT_OPTIMIZE) /* balance the search tree */
-	{	toptimize(dt);
+	{	lk = DT_LKALONE;
+		DTSETLOCK(dt,lk);
+		toptimize(dt);
+		DTCLRLOCK(dt,lk);
 		return 0;
 	}
 	else	return 0;
@@ -671,7 +723,7 @@ static int treeevent(Dt_t* dt, int event, Void_t* arg)
 
 Void_t* dtfinger(Dt_t* dt)
 {
-	return (dt && dt->meth && (dt->meth->type & DT_ORDERED)) ? (Void_t*)((Dttree_t*)dt->data)->root : NIL(Void_t*);
+	return (dt && dt->meth && (dt->meth->type & (DT_OSET|DT_OBAG))) ? (Void_t*)((Dttree_t*)dt->data)->root : NIL(Void_t*);
 }
 
 #endif
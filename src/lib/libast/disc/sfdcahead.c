@@ -0,0 +1,149 @@
+/***********************************************************************
+*                                                                      *
+*               This software is part of the ast package               *
+*          Copyright (c) 1985-2012 AT&T Intellectual Property          *
+*                      and is licensed under the                       *
+*                 Eclipse Public License, Version 1.0                  *
+*                    by AT&T Intellectual Property                     *
+*                                                                      *
+*                A copy of the License is available at                 *
+*          http://www.eclipse.org/org/documents/epl-v10.html           *
+*         (with md5 checksum b35adb5213ca9657e911e9befb180842)         *
+*                                                                      *
+*              Information and Software Systems Research               *
+*                            AT&T Research                             *
+*                           Florham Park NJ                            *
+*                                                                      *
+*                 Glenn Fowler <gsf@research.att.com>                  *
+*                  David Korn <dgk@research.att.com>                   *
+*                   Phong Vo <kpv@research.att.com>                    *
+*                                                                      *
+***********************************************************************/
+#include	"sfdchdr.h"
+
+/*	Discipline to keep the kernel reading ahead of a sequential reader.
+**	Each read hints that the next depth buffers past the current
+**	offset will be needed so that disk I/O overlaps with processing.
+**	The hints are refreshed only after half the window is consumed.
+**	This only applies to regular files on systems with posix_fadvise().
+**	Memory mapped streams are left mapped and only marked sequential
+**	since the mapped windows already read ahead with MADV_SEQUENTIAL.
+*/
+
+#if _lib_posix_fadvise && defined(POSIX_FADV_WILLNEED)
+#define _sfdc_ahead	1
+#endif
+
+typedef struct _ahead_s
+{	Sfdisc_t	disc;	/* Sfio discipline		*/
+	size_t		size;	/* size of each buffer		*/
+	int		depth;	/* buffers kept in flight	*/
+	Sfoff_t		lo;	/* start of hinted window	*/
+	Sfoff_t		hi;	/* end of hinted window		*/
+} Ahead_t;
+
+#if __STD_C
+static ssize_t aheadread(Sfio_t* f, Void_t* buf, size_t n, Sfdisc_t* disc)
+#else
+static ssize_t aheadread(f, buf, n, disc)
+Sfio_t*		f;
+Void_t*		buf;
+size_t		n;
+Sfdisc_t*	disc;
+#endif
+{
+#ifdef _sfdc_ahead
+	reg Ahead_t*	ah = (Ahead_t*)disc;
+	reg Sfoff_t	here, want;
+
+	here = f->here;
+	want = here + n + (Sfoff_t)ah->depth*ah->size;
+	if(here < ah->lo || here > ah->hi)
+		ah->lo = ah->hi = here; /* seek outside the window */
+	if(ah->hi < want - (Sfoff_t)(ah->depth/2)*ah->size)
+	{	/* less than half the window left, extend it */
+		if(ah->hi < here + n)
+			ah->hi = here + n;
+		if(posix_fadvise(f->file,(off_t)ah->hi,(off_t)(want-ah->hi),
+				 POSIX_FADV_WILLNEED) == 0)
+		{	ah->lo = here;
+			ah->hi = want;
+		}
+	}
+#endif
+	return sfrd(f,buf,n,disc);
+}
+
+#if __STD_C
+static int aheadexcept(Sfio_t* f, int type, Void_t* data, Sfdisc_t* disc)
+#else
+static int aheadexcept(f,type,data,disc)
+Sfio_t*		f;
+int		type;
+Void_t*		data;
+Sfdisc_t*	disc;
+#endif
+{
+	NOTUSED(f);
+	NOTUSED(data);
+
+	if(type == SF_FINAL || type == SF_DPOP)
+		free(disc);
+	return 0;
+}
+
+#if __STD_C
+int sfdcahead(Sfio_t* f, size_t bufsize, int depth)
+#else
+int sfdcahead(f, bufsize, depth)
+Sfio_t*	f;
+size_t	bufsize;
+int	depth;
+#endif
+{
+#ifndef _sfdc_ahead
+	return -1;
+#else
+	Ahead_t*	ah;
+	Sfoff_t		here;
+	struct stat	st;
+
+	if(!(f->flags&SF_READ) || (f->flags&SF_STRING) || f->file < 0)
+		return -1;
+	if(fstat(f->file,&st) < 0 || !S_ISREG(st.st_mode))
+		return -1;
+	if((here = sfseek(f,(Sfoff_t)0,SEEK_CUR)) < 0)
+		return -1;
+
+	if(bufsize > 0)
+		sfsetbuf(f,NIL(Void_t*),bufsize);
+	(void)posix_fadvise(f->file,(off_t)0,(off_t)0,POSIX_FADV_SEQUENTIAL);
+	if(f->bits&SF_MMAP)
+	{	/* a readf would turn off mmap, mapped windows get MADV_SEQUENTIAL */
+		f->bits |= SF_SEQUENTIAL;
+		return 0;
+	}
+	if((bufsize = f->size) <= 0)
+		bufsize = SF_BUFSIZE;
+	if(depth <= 0)
+		depth = 4;
+
+	if(!(ah = (Ahead_t*)malloc(sizeof(Ahead_t))) )
+		return -1;
+
+	ah->disc.readf = aheadread;
+	ah->disc.writef = NIL(Sfwrite_f);
+	ah->disc.seekf = NIL(Sfseek_f);
+	ah->disc.exceptf = aheadexcept;
+	ah->size = bufsize;
+	ah->depth = depth;
+	ah->lo = ah->hi = here;
+
+	if(sfdisc(f,(Sfdisc_t*)ah) != (Sfdisc_t*)ah)
+	{	free(ah);
+		return -1;
+	}
+
+	return 0;
+#endif /*_sfdc_ahead*/
+}
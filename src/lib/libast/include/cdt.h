@@ -177,8 +177,12 @@ struct _dtstat_s
 #define DT_DEQUE	0000000200 /* deque: insert top, append at tail	*/
 #define DT_RHSET	0000000400 /* rhset: sharable unique objects	*/
 #define DT_RHBAG	0000001000 /* rhbag: sharable repeated objects	*/
-#define DT_METHODS	0000001777 /* all currently supported methods	*/
-#define DT_ORDERED	(DT_OSET|DT_OBAG)
+#define DT_LPSET	0000002000 /* unordered set, open addressing	*/
+#define DT_LPBAG	0000004000 /* unordered bag, open addressing	*/
+#define DT_BTSET	0000010000 /* ordered set, B-tree		*/
+#define DT_BTBAG	0000020000 /* ordered multiset, B-tree		*/
+#define DT_METHODS	0000037777 /* all currently supported methods	*/
+#define DT_ORDERED	(DT_OSET|DT_OBAG|DT_BTSET|DT_BTBAG)
 
 /* asserts to dtdisc() to improve performance when changing disciplines */
 #define DT_SAMECMP	0000000001 /* compare functions are equivalent	*/
@@ -243,6 +247,10 @@ extern Dtmethod_t*	Dtlist;
 extern Dtmethod_t*	Dtstack;
 extern Dtmethod_t*	Dtqueue;
 extern Dtmethod_t*	Dtdeque;
+extern Dtmethod_t* 	Dtlpset;
+extern Dtmethod_t* 	Dtlpbag;
+extern Dtmethod_t* 	Dtbtset;
+extern Dtmethod_t* 	Dtbtbag;
 
 #if _PACKAGE_ast /* dtplugin() for proprietary and non-standard methods -- requires -ldll */
 
@@ -130,6 +130,7 @@
 
 struct regex_s; typedef struct regex_s regex_t;
 struct regdisc_s; typedef struct regdisc_s regdisc_t;
+struct regset_s; typedef struct regset_s regset_t;
 
 typedef int (*regclass_t)(int);
 typedef uint32_t regflags_t;
@@ -184,6 +185,15 @@ typedef struct regstat_s
 	regflags_t	re_info;	/* REG_* info			*/
 } regstat_t;
 
+typedef struct regcachestat_s
+{
+	size_t		rc_size;	/* max # cached re's		*/
+	size_t		rc_count;	/* # cached re's		*/
+	unsigned long	rc_hits;	/* regcache() cache hits	*/
+	unsigned long	rc_misses;	/* regcache() compiles		*/
+	unsigned long	rc_flushes;	/* cache flushes		*/
+} regcachestat_t;
+
 struct regex_s
 {
 	size_t		re_nsub;	/* number of subexpressions	*/
@@ -206,7 +216,7 @@ extern void	regfree(regex_t*);
 
 /* nonstandard hooks */
 
-#define _REG_cache	1	/* have regcache()			*/
+#define _REG_cache	1	/* have regcache(), regcachestat()	*/
 #define _REG_class	1	/* have regclass()			*/
 #define _REG_collate	1	/* have regcollate(), regclass()	*/
 #define _REG_comb	1	/* have regcomb()			*/
@@ -216,6 +226,7 @@ extern void	regfree(regex_t*);
 #define _REG_ncomp	1	/* have regncomp()			*/
 #define _REG_nexec	1	/* have regnexec()			*/
 #define _REG_rexec	1	/* have regrexec(), regrecord()		*/
+#define _REG_set	1	/* have regsetopen() and friends	*/
 #define _REG_stat	1	/* have regstat()			*/
 #define _REG_subcomp	1	/* have regsubcomp(), regsubexec()	*/
 
@@ -233,7 +244,13 @@ extern int	regrecord(const regex_t*);
 extern int	regrexec(const regex_t*, const char*, size_t, size_t, regmatch_t*, regflags_t, int, void*, regrecord_t);
 extern regstat_t* regstat(const regex_t*);
 
+extern regset_t* regsetopen(regdisc_t*);
+extern int	regsetadd(regset_t*, regex_t*);
+extern ssize_t	regsetexec(regset_t*, const char*, size_t, size_t, size_t*, regflags_t);
+extern int	regsetclose(regset_t*);
+
 extern regex_t*	regcache(const char*, regflags_t, int*);
+extern int	regcachestat(regcachestat_t*);
 
 extern int	regsubcomp(regex_t*, const char*, const regflags_t*, int, regflags_t);
 extern int	regsubexec(const regex_t*, const char*, size_t, regmatch_t*);
@@ -53,6 +53,7 @@ extern int		sfkeyprintf_20000308(Sfio_t*, void*, const char*, Sf_key_lookup_t, S
  * pure sfio read and/or write disciplines
  */
 
+extern int		sfdcahead(Sfio_t*, size_t, int);
 extern int		sfdcdio(Sfio_t*, size_t);
 extern int		sfdcdos(Sfio_t*);
 extern int		sfdcfilter(Sfio_t*, const char*);
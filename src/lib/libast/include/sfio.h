@@ -250,6 +250,7 @@ extern int		sfnotify _ARG_((void(*)(Sfio_t*, int, void*)));
 extern int		sfset _ARG_((Sfio_t*, int, int));
 extern int		sfsetfd _ARG_((Sfio_t*, int));
 extern Sfio_t*		sfpool _ARG_((Sfio_t*, Sfio_t*, int));
+extern int		sfwrstat _ARG_((Sfulong_t*, Sfulong_t*));
 extern ssize_t		sfread _ARG_((Sfio_t*, Void_t*, size_t));
 extern ssize_t		sfwrite _ARG_((Sfio_t*, const Void_t*, size_t));
 extern Sfoff_t		sfmove _ARG_((Sfio_t*, Sfio_t*, Sfoff_t, int));
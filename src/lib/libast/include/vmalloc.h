@@ -57,6 +57,11 @@ struct _vmstat_s
 	int	n_lock;			/* #calls where reg was locked	*/
 	int	n_probe;		/* #probes to find a region	*/
 	int	mode;			/* region mode bits		*/
+	size_t	resident;		/* resident part of extent	*/
+	size_t	released;		/* space released to system	*/
+	int	n_home;			/* #calls that found home reg	*/
+	int	n_direct;		/* #frees done in the block reg	*/
+	int	n_queue;		/* #frees queued for later	*/
 };
 
 struct _vmdisc_s
@@ -100,7 +105,8 @@ struct _vmalloc_s
 #define VM_MTLAST	0000400		/* Vmlast method		*/
 #define VM_MTDEBUG	0001000		/* Vmdebug method		*/
 #define VM_MTPROFILE	0002000		/* Vmdebug method		*/
-#define VM_METHODS	0003700		/* available allocation methods	*/
+#define VM_MTSLAB	0004000		/* Vmslab method		*/
+#define VM_METHODS	0007700		/* available allocation methods	*/
 
 #define VM_RSCOPY	0000001		/* copy old contents		*/
 #define VM_RSMOVE	0000002		/* old contents is moveable	*/
@@ -131,6 +137,7 @@ _BEGIN_EXTERNS_	 /* public data */
 extern Vmethod_t*	Vmbest;		/* best allocation		*/
 extern Vmethod_t*	Vmlast;		/* last-block allocation	*/
 extern Vmethod_t*	Vmpool;		/* pool allocation		*/
+extern Vmethod_t*	Vmslab;		/* size-class slab allocation	*/
 extern Vmethod_t*	Vmdebug;	/* allocation with debugging	*/
 extern Vmethod_t*	Vmprofile;	/* profiling memory usage	*/
 
@@ -181,6 +188,9 @@ extern int		vmdebug _ARG_(( int ));
 
 extern int		vmprofile _ARG_(( Vmalloc_t*, int ));
 
+extern ssize_t		vmsample _ARG_(( ssize_t ));
+extern int		vmsmpdump _ARG_(( int, int ));
+
 extern int		vmtrace _ARG_(( int ));
 extern int		vmtrbusy _ARG_((Vmalloc_t*));
 
@@ -24,36 +24,158 @@
 /*
  * regcomp() regex_t cache
  * at&t research
+ *
+ * entries are hashed on pattern and flags and kept in lru order;
+ * a miss frees the least recently used entry once the cache is
+ * full, so an re returned by regcache() remains valid until size
+ * other patterns have been compiled
+ *
+ * the cache is locked while it is searched and updated but not
+ * while a missed pattern is compiled; regexec() updates private
+ * data in the re so a cached re must not be used by more than
+ * one thread at a time
  */
 
 #include <ast.h>
+#include <aso.h>
 #include <regex.h>
 
-#define CACHE		8		/* default # cached re's	*/
-#define ROUND		64		/* pattern buffer size round	*/
-
-typedef unsigned long Key_t;
+#define CACHE		32		/* default # cached re's	*/
 
 typedef struct Cache_s
 {
+	struct Cache_s*	link;		/* hash bucket link		*/
+	struct Cache_s*	prev;		/* more recently used		*/
+	struct Cache_s*	next;		/* less recently used		*/
 	char*		pattern;
 	regex_t		re;
-	unsigned long	serial;
+	unsigned int	hash;
 	regflags_t	reflags;
 	int		keep;
-	int		size;
 } Cache_t;
 
 typedef struct State_s
 {
-	unsigned int	size;
-	unsigned long	serial;
+	unsigned int	size;		/* max # cached re's		*/
+	unsigned int	count;		/* # allocated entries		*/
+	unsigned int	mask;		/* hash table size - 1		*/
+	unsigned int volatile lock;	/* cache lock			*/
 	char*		locale;
-	Cache_t**	cache;
+	Cache_t**	hash;		/* hash table			*/
+	Cache_t*	mru;		/* most recently used		*/
+	Cache_t*	lru;		/* least recently used		*/
+	regcachestat_t	stat;
 } State_t;
 
 static State_t	matchstate;
 
+#define LOCK()		asolock(&matchstate.lock, 1, ASO_SPINLOCK)
+#define UNLOCK()	asolock(&matchstate.lock, 1, ASO_UNLOCK)
+
+/*
+ * hash pattern and reflags
+ */
+
+static unsigned int
+hash(const char* pattern, regflags_t reflags)
+{
+	return strhash(pattern) ^ (unsigned int)reflags * 0x9e3779b1;
+}
+
+/*
+ * free the re in cp and remove cp from the hash table
+ */
+
+static void
+release(register Cache_t* cp)
+{
+	register Cache_t**	pp;
+
+	if (cp->keep)
+	{
+		for (pp = &matchstate.hash[cp->hash & matchstate.mask]; *pp != cp; pp = &(*pp)->link);
+		*pp = cp->link;
+		cp->keep = 0;
+		regfree(&cp->re);
+	}
+}
+
+/*
+ * return the cache entry for pattern,reflags with hash h, 0 if not cached
+ */
+
+static Cache_t*
+search(const char* pattern, regflags_t reflags, unsigned int h)
+{
+	register Cache_t*	cp;
+
+	for (cp = matchstate.hash[h & matchstate.mask]; cp; cp = cp->link)
+		if (cp->hash == h && cp->reflags == reflags && !strcmp(cp->pattern, pattern))
+			break;
+	return cp;
+}
+
+/*
+ * remove cp from the lru list
+ */
+
+static void
+detach(register Cache_t* cp)
+{
+	if (cp->prev)
+		cp->prev->next = cp->next;
+	else
+		matchstate.mru = cp->next;
+	if (cp->next)
+		cp->next->prev = cp->prev;
+	else
+		matchstate.lru = cp->prev;
+	cp->prev = cp->next = 0;
+}
+
+/*
+ * add cp to the lru list as the most recently used entry
+ */
+
+static void
+attach(register Cache_t* cp)
+{
+	if (cp->next = matchstate.mru)
+		cp->next->prev = cp;
+	else
+		matchstate.lru = cp;
+	matchstate.mru = cp;
+}
+
+/*
+ * size the hash table for n entries
+ */
+
+static int
+rehash(unsigned int n)
+{
+	register Cache_t*	cp;
+	register Cache_t**	hp;
+	register unsigned int	m;
+
+	for (m = 2 * CACHE; m < 2 * n; m <<= 1);
+	if (m - 1 == matchstate.mask)
+		return 0;
+	if (!(hp = newof(0, Cache_t*, m, 0)))
+		return -1;
+	if (matchstate.hash)
+		free(matchstate.hash);
+	matchstate.hash = hp;
+	matchstate.mask = m - 1;
+	for (cp = matchstate.mru; cp; cp = cp->next)
+		if (cp->keep)
+		{
+			cp->link = hp[cp->hash & matchstate.mask];
+			hp[cp->hash & matchstate.mask] = cp;
+		}
+	return 0;
+}
+
 /*
  * flush the cache
  */
@@ -61,14 +183,21 @@ static State_t	matchstate;
 static void
 flushcache(void)
 {
-	register int		i;
+	register Cache_t*	cp;
+	register int		n;
 
-	for (i = matchstate.size; i--;)
-		if (matchstate.cache[i] && matchstate.cache[i]->keep)
+	for (n = 0, cp = matchstate.mru; cp; cp = cp->next)
+		if (cp->keep)
 		{
-			matchstate.cache[i]->keep = 0;
-			regfree(&matchstate.cache[i]->re);
+			cp->keep = 0;
+			regfree(&cp->re);
+			n++;
 		}
+	if (n)
+	{
+		memset(matchstate.hash, 0, (matchstate.mask + 1) * sizeof(Cache_t*));
+		matchstate.stat.rc_flushes++;
+	}
 }
 
 /*
@@ -80,11 +209,11 @@ regcache(const char* pattern, regflags_t reflags, int* status)
 {
 	register Cache_t*	cp;
 	register int		i;
+	Cache_t*		np;
+	unsigned int		h;
 	char*			s;
-	int			empty;
-	int			unused;
-	int			old;
-	Key_t			key;
+
+	LOCK();
 
 	/*
 	 * 0 pattern flushes the cache and reflags>0 extends cache
@@ -96,22 +225,25 @@ regcache(const char* pattern, regflags_t reflags, int* status)
 		i = 0;
 		if (reflags > matchstate.size)
 		{
-			if (matchstate.cache = newof(matchstate.cache, Cache_t*, reflags, 0))
+			if (!rehash(reflags))
 				matchstate.size = reflags;
 			else
-			{
-				matchstate.size = 0;
 				i = 1;
-			}
 		}
+		UNLOCK();
 		if (status)
 			*status = i;
 		return 0;
 	}
-	if (!matchstate.cache)
+	if (!matchstate.hash)
 	{
-		if (!(matchstate.cache = newof(0, Cache_t*, CACHE, 0)))
+		if (rehash(CACHE))
+		{
+			UNLOCK();
+			if (status)
+				*status = REG_ESPACE;
 			return 0;
+		}
 		matchstate.size = CACHE;
 	}
 
@@ -131,68 +263,97 @@ regcache(const char* pattern, regflags_t reflags, int* status)
 	 * check if the pattern is in the cache
 	 */
 
-	for (i = 0; i < sizeof(key) && pattern[i]; i++)
-		((char*)&key)[i] = pattern[i];
-	for (; i < sizeof(key); i++)
-		((char*)&key)[i] = 0;
-	empty = unused = -1;
-	old = 0;
-	for (i = matchstate.size; i--;)
-		if (!matchstate.cache[i])
-			empty = i;
-		else if (!matchstate.cache[i]->keep)
-			unused = i;
-		else if (*(Key_t*)matchstate.cache[i]->pattern == key && !strcmp(matchstate.cache[i]->pattern, pattern) && matchstate.cache[i]->reflags == reflags)
-			break;
-		else if (!matchstate.cache[old] || matchstate.cache[old]->serial > matchstate.cache[i]->serial)
-			old = i;
-	if (i < 0)
+	h = hash(pattern, reflags);
+	if (cp = search(pattern, reflags, h))
 	{
-		if (unused < 0)
-		{
-			if (empty < 0)
-				unused = old;
-			else
-				unused = empty;
-		}
-		if (!(cp = matchstate.cache[unused]) && !(cp = matchstate.cache[unused] = newof(0, Cache_t, 1, 0)))
-		{
-			if (status)
-				*status = REG_ESPACE;
-			return 0;
-		}
-		if (cp->keep)
-		{
-			cp->keep = 0;
-			regfree(&cp->re);
-		}
-		if ((i = strlen(pattern) + 1) > cp->size)
-		{
-			cp->size = roundof(i, ROUND);
-			if (!(cp->pattern = newof(cp->pattern, char, cp->size, 0)))
-			{
-				if (status)
-					*status = REG_ESPACE;
-				return 0;
-			}
-		}
-		strcpy(cp->pattern, pattern);
-		while (++i < sizeof(Key_t))
-			cp->pattern[i] = 0;
-		pattern = (const char*)cp->pattern;
-		if (i = regcomp(&cp->re, pattern, reflags))
+		matchstate.stat.rc_hits++;
+		detach(cp);
+		attach(cp);
+		UNLOCK();
+		if (status)
+			*status = 0;
+		return &cp->re;
+	}
+	matchstate.stat.rc_misses++;
+	UNLOCK();
+
+	/*
+	 * compile into a new entry without the lock
+	 */
+
+	i = strlen(pattern) + 1;
+	if (!(np = newof(0, Cache_t, 1, i)))
+	{
+		if (status)
+			*status = REG_ESPACE;
+		return 0;
+	}
+	np->pattern = (char*)(np + 1);
+	memcpy(np->pattern, pattern, i);
+	if (i = regcomp(&np->re, np->pattern, reflags))
+	{
+		free(np);
+		if (status)
+			*status = i;
+		return 0;
+	}
+	np->keep = 1;
+	np->hash = h;
+	np->reflags = reflags;
+	LOCK();
+
+	/*
+	 * another thread may have cached the pattern meanwhile
+	 */
+
+	if (cp = search(pattern, reflags, h))
+		detach(cp);
+	else
+	{
+		/*
+		 * free an unused entry, or the lru entry if the cache is full
+		 */
+
+		if ((cp = matchstate.lru) && (!cp->keep || matchstate.count >= matchstate.size))
 		{
-			if (status)
-				*status = i;
-			return 0;
+			release(cp);
+			detach(cp);
+			free(cp);
+			matchstate.count--;
 		}
-		cp->keep = 1;
-		cp->reflags = reflags;
+		cp = np;
+		cp->link = matchstate.hash[h & matchstate.mask];
+		matchstate.hash[h & matchstate.mask] = cp;
+		matchstate.count++;
+		np = 0;
+	}
+	attach(cp);
+	UNLOCK();
+	if (np)
+	{
+		regfree(&np->re);
+		free(np);
 	}
-	else
-		cp = matchstate.cache[i];
-	cp->serial = ++matchstate.serial;
 	if (status)
 		*status = 0;
 	return &cp->re;
 }
+
+/*
+ * copy the cache statistics to sp
+ */
+
+int
+regcachestat(regcachestat_t* sp)
+{
+	register Cache_t*	cp;
+
+	LOCK();
+	matchstate.stat.rc_size = matchstate.size;
+	for (matchstate.stat.rc_count = 0, cp = matchstate.mru; cp; cp = cp->next)
+		if (cp->keep)
+			matchstate.stat.rc_count++;
+	*sp = matchstate.stat;
+	UNLOCK();
+	return 0;
+}
@@ -2999,6 +2999,171 @@ bmtrie(Cenv_t* env, Rex_t* a, unsigned char* v, Trie_node_t* x, int n, int m, Bm
 	return b;
 }
 
+/*
+ * add the chars that can start a match of the rex list e to s
+ * 0 returned if a match must consume a char, 1 if it may be
+ * empty, -1 if s can't be determined
+ */
+
+static int
+firstset(register Rex_t* e, register Set_t* s)
+{
+	register int	c;
+	register int	i;
+	int		r;
+
+	for (; e; e = e->next)
+		switch (e->type)
+		{
+		case REX_ALT:
+			if ((r = firstset(e->re.group.expr.binary.left, s)) < 0 || (i = firstset(e->re.group.expr.binary.right, s)) < 0)
+				return -1;
+			if (!r && !i)
+				return 0;
+			break;
+		case REX_BEG:
+		case REX_BEG_STR:
+		case REX_BM:
+		case REX_END:
+		case REX_END_STR:
+		case REX_FIN_STR:
+		case REX_NULL:
+		case REX_WBEG:
+		case REX_WEND:
+		case REX_WORD:
+		case REX_WORD_NOT:
+			break;
+		case REX_CLASS:
+			for (c = 0; c <= UCHAR_MAX; c++)
+				if (settst(e->re.charclass, c))
+					setadd(s, c);
+			if (e->lo)
+				return 0;
+			break;
+		case REX_ONECHAR:
+		case REX_STRING:
+			if (e->type == REX_STRING)
+			{
+				if (!e->re.string.size)
+					break;
+				i = e->re.string.base[0];
+			}
+			else
+				i = e->re.onechar;
+			if (e->map)
+			{
+				for (c = 0; c <= UCHAR_MAX; c++)
+					if (e->map[c] == i)
+						setadd(s, c);
+			}
+			else
+				setadd(s, i);
+			if (e->type == REX_STRING || e->lo)
+				return 0;
+			break;
+		case REX_TRIE:
+			for (i = 0; i <= UCHAR_MAX; i++)
+				if (e->re.trie.root[i])
+					for (c = 0; c <= UCHAR_MAX; c++)
+						if ((e->map ? e->map[c] : c) == i)
+							setadd(s, c);
+			if (e->re.trie.min)
+				return 0;
+			break;
+		case REX_GROUP:
+			if ((r = firstset(e->re.group.expr.rex, s)) <= 0)
+				return r;
+			break;
+		case REX_REP:
+			if ((r = firstset(e->re.group.expr.rex, s)) < 0)
+				return -1;
+			if (!r && e->lo)
+				return 0;
+			break;
+		default:
+			return -1;
+		}
+	return 1;
+}
+
+/*
+ * return the rarest looking of c and the literal chars required
+ * by every match of the rex list e, -1 if there are none
+ */
+
+#define RARITY(c)	(isalnum(c)?(islower(c)?1:2):isspace(c)?0:3)
+
+static int
+required(register Rex_t* e, register int c)
+{
+	register int	i;
+
+	for (; e; e = e->next)
+		switch (e->type)
+		{
+		case REX_ALT:
+			return c;
+		case REX_GROUP:
+			c = required(e->re.group.expr.rex, c);
+			break;
+		case REX_KMP:
+		case REX_STRING:
+			if (!e->map)
+				for (i = 0; i < e->re.string.size; i++)
+					if (c < 0 || RARITY(e->re.string.base[i]) > RARITY(c))
+						c = e->re.string.base[i];
+			break;
+		case REX_ONECHAR:
+			if (e->lo && !e->map && (c < 0 || RARITY(e->re.onechar) > RARITY(c)))
+				c = e->re.onechar;
+			break;
+		case REX_REP:
+			if (e->lo)
+				c = required(e->re.group.expr.rex, c);
+			break;
+		}
+	return c;
+}
+
+/*
+ * determine the regnexec() prefilter chars
+ * only single byte locales get a first char set
+ */
+
+static void
+prefilter(Cenv_t* env, regex_t* p)
+{
+	register int	c;
+	register int	n;
+	Set_t		s;
+
+	if (p->env->first)
+	{
+		alloc(env->disc, p->env->first, 0);
+		p->env->first = 0;
+	}
+	p->env->firstc = -1;
+	p->env->must = p->env->rex->type == REX_BM ? -1 : required(p->env->rex, -1);
+	if (mbwide() || p->env->once)
+		return;
+	memset(&s, 0, sizeof(s));
+	if (firstset(p->env->rex, &s))
+		return;
+	for (n = 0, c = 0; c <= UCHAR_MAX; c++)
+		if (settst(&s, c) && !n++)
+			p->env->firstc = c;
+	if (n >= UCHAR_MAX)
+		p->env->firstc = -1;
+	else if (p->env->first = (Set_t*)alloc(env->disc, 0, sizeof(Set_t)))
+	{
+		*p->env->first = s;
+		if (n > 1)
+			p->env->firstc = -1;
+	}
+	else
+		p->env->firstc = -1;
+}
+
 /*
  * rewrite the expression tree for some special cases
  * 1. it is a null expression - illegal
@@ -3385,6 +3550,7 @@ regcomp(regex_t* p, const char* pattern, regflags_t flags)
 	}
 	if (special(&env, p))
 		goto bad;
+	prefilter(&env, p);
 	serialize(&env, p->env->rex, 1);
 	p->re_nsub = env.stats.p;
 	if (env.type == KRE)
@@ -3464,6 +3630,8 @@ regcomb(regex_t* p, regex_t* q)
 		return REG_ESUBREG;
 	memset(&env, 0, sizeof(env));
 	env.disc = p->env->disc;
+	if (p->env->dfa)
+		dfafree(p->env);
 	if (e->type == REX_BM)
 	{
 		p->env->rex = e->next;
@@ -3543,6 +3711,7 @@ regcomb(regex_t* p, regex_t* q)
 		regfree(p);
 		return fatal(p->env->disc, env.error ? env.error : REG_ESPACE, NiL);
 	}
+	prefilter(&env, p);
 	p->env->min = g->re.trie.min;
 	return 0;
 }
@@ -0,0 +1,623 @@
+/***********************************************************************
+*                                                                      *
+*               This software is part of the ast package               *
+*          Copyright (c) 1985-2012 AT&T Intellectual Property          *
+*                      and is licensed under the                       *
+*                 Eclipse Public License, Version 1.0                  *
+*                    by AT&T Intellectual Property                     *
+*                                                                      *
+*                A copy of the License is available at                 *
+*          http://www.eclipse.org/org/documents/epl-v10.html           *
+*         (with md5 checksum b35adb5213ca9657e911e9befb180842)         *
+*                                                                      *
+*              Information and Software Systems Research               *
+*                            AT&T Research                             *
+*                           Florham Park NJ                            *
+*                                                                      *
+*                 Glenn Fowler <gsf@research.att.com>                  *
+*                  David Korn <dgk@research.att.com>                   *
+*                   Phong Vo <kpv@research.att.com>                    *
+*                                                                      *
+***********************************************************************/
+#pragma prototyped
+
+/*
+ * posix regex lazy dfa executor
+ *
+ * expressions with no backreferences, lookaround or augmented
+ * operators are translated to a Thompson nfa on first use, and
+ * dfa states (sets of nfa nodes) are built on demand while the
+ * subject is scanned, so a match/nomatch decision is linear in
+ * the subject length no matter how the expression is written
+ *
+ * the state cache is flushed when it fills up, so memory stays
+ * bounded for expressions with a large dfa
+ */
+
+#include "reglib.h"
+
+#define DFA_NODES	4096		/* max nfa nodes		*/
+#define DFA_STATES	256		/* max cached dfa states	*/
+#define DFA_HASH	256		/* state hash table size	*/
+
+#define N_CHAR		1		/* match one char in set	*/
+#define N_SPLIT		2		/* epsilon to out and alt	*/
+#define N_BEG		3		/* ^				*/
+#define N_BEG_STR	4		/* ^ of subject only		*/
+#define N_END		5		/* $				*/
+#define N_FIN		6		/* $ of subject only		*/
+#define N_MATCH		7		/* accept			*/
+
+#define C_BEG		0		/* at the subject beginning	*/
+#define C_NL		1		/* just after newline		*/
+#define C_CHAR		2		/* just after any other char	*/
+
+#define L_NONE		(-1)		/* lookahead not known yet	*/
+#define L_EOS		(UCHAR_MAX+1)	/* lookahead is end of subject	*/
+
+#define E_UNKNOWN	(-1)		/* end of subject not checked	*/
+
+typedef struct Dfanode_s		/* nfa node			*/
+{
+	unsigned char	type;		/* N_* node type		*/
+	unsigned char	nl;		/* REG_NEWLINE ^ or $		*/
+	int		out;		/* next node			*/
+	int		alt;		/* N_SPLIT alternate		*/
+	Set_t		set;		/* N_CHAR chars			*/
+} Dfanode_t;
+
+typedef struct Dfastate_s		/* dfa state			*/
+{
+	struct Dfastate_s*	link;	/* hash chain			*/
+	struct Dfastate_s*	next[UCHAR_MAX+1]; /* transitions	*/
+	unsigned int		hash;	/* node set hash		*/
+	int			ctx;	/* C_* context			*/
+	int			match;	/* nfa match node in set	*/
+	int			eos;	/* match at end of subject	*/
+	int			size;	/* # nfa nodes			*/
+	int			node[1];/* sorted nfa nodes		*/
+} Dfastate_t;
+
+typedef struct Dfa_s
+{
+	regdisc_t*	disc;		/* allocation discipline	*/
+	Dfanode_t*	node;		/* nfa nodes			*/
+	int		nodes;		/* # nfa nodes			*/
+	int		alloc;		/* # allocated nfa nodes	*/
+	int		start;		/* nfa start node		*/
+	int		states;		/* # cached dfa states		*/
+	int		flushed;	/* cache flushed in transition	*/
+	int		bad;		/* not representable		*/
+	int		nl;		/* has REG_NEWLINE ^		*/
+	regflags_t	flags;		/* exec flags for cached states	*/
+	int*		list;		/* closure node list		*/
+	int*		stack;		/* closure stack		*/
+	int*		mark;		/* closure generation marks	*/
+	int		gen;		/* current closure generation	*/
+	int		size;		/* # nodes in list		*/
+	Dfastate_t*	begin;		/* start state			*/
+	Dfastate_t*	idle;		/* no partial match state	*/
+	Dfastate_t	hit;		/* match on lookahead state	*/
+	Dfastate_t*	hash[DFA_HASH];	/* state hash table		*/
+} Dfa_t;
+
+static int	build(Dfa_t*, Rex_t*, int);
+
+/*
+ * add an nfa node, -1 when the nfa gets too big
+ */
+
+static int
+node(register Dfa_t* d, int type, int out, int alt)
+{
+	register Dfanode_t*	n;
+	int			m;
+
+	if (d->nodes >= d->alloc)
+	{
+		if (d->alloc >= DFA_NODES)
+			return -1;
+		m = d->alloc ? 2 * d->alloc : 64;
+		if (!(n = (Dfanode_t*)alloc(d->disc, d->node, m * sizeof(Dfanode_t))))
+			return -1;
+		d->node = n;
+		d->alloc = m;
+	}
+	n = d->node + d->nodes;
+	n->type = type;
+	n->nl = 0;
+	n->out = out;
+	n->alt = alt;
+	memset(&n->set, 0, sizeof(n->set));
+	return d->nodes++;
+}
+
+/*
+ * add an N_CHAR node for chars that map to c
+ */
+
+static int
+mapped(register Dfa_t* d, unsigned char* map, int c, int out)
+{
+	register int	i;
+	register int	k;
+
+	if ((k = node(d, N_CHAR, out, -1)) < 0)
+		return -1;
+	if (map)
+	{
+		for (i = 0; i <= UCHAR_MAX; i++)
+			if (map[i] == c)
+				setadd(&d->node[k].set, i);
+	}
+	else
+		setadd(&d->node[k].set, c);
+	return k;
+}
+
+/*
+ * one iteration of the single char or repeated subexpression rex
+ */
+
+static int
+item(register Dfa_t* d, register Rex_t* rex, int out)
+{
+	register int	i;
+	register int	k;
+
+	switch (rex->type)
+	{
+	case REX_CLASS:
+		if ((k = node(d, N_CHAR, out, -1)) >= 0)
+			d->node[k].set = *rex->re.charclass;
+		return k;
+	case REX_DOT:
+		if ((k = node(d, N_CHAR, out, -1)) >= 0)
+		{
+			for (i = 0; i <= UCHAR_MAX; i++)
+				setadd(&d->node[k].set, i);
+			if (rex->explicit >= 0)
+				setclr(&d->node[k].set, rex->explicit);
+		}
+		return k;
+	case REX_ONECHAR:
+		return mapped(d, rex->map, rex->re.onechar, out);
+	case REX_REP:
+		return rex->re.group.expr.rex ? build(d, rex->re.group.expr.rex, out) : out;
+	}
+	return -1;
+}
+
+/*
+ * rex->lo to rex->hi iterations of item() followed by out
+ */
+
+static int
+repeat(register Dfa_t* d, register Rex_t* rex, int out)
+{
+	register int	i;
+	register int	k;
+	register int	s;
+	int		x;
+
+	if (rex->lo > rex->hi || rex->lo > DFA_NODES)
+		return -1;
+	x = out;
+	if (rex->hi == RE_DUP_INF)
+	{
+		if ((s = node(d, N_SPLIT, -1, out)) < 0 || (k = item(d, rex, s)) < 0)
+			return -1;
+		d->node[s].out = k;
+		out = s;
+	}
+	else if (rex->hi - rex->lo > DFA_NODES)
+		return -1;
+	else
+		for (i = rex->lo; i < rex->hi; i++)
+			if ((k = item(d, rex, out)) < 0 || (out = node(d, N_SPLIT, k, x)) < 0)
+				return -1;
+	for (i = 0; i < rex->lo; i++)
+		if ((out = item(d, rex, out)) < 0)
+			return -1;
+	return out;
+}
+
+/*
+ * the strings in the trie sibling list x followed by out
+ */
+
+static int
+trie(register Dfa_t* d, register Trie_node_t* x, unsigned char* map, int out)
+{
+	register int	k;
+	register int	r;
+	int		s;
+
+	for (r = -1; x; x = x->sib)
+	{
+		if (!x->son)
+			s = out;
+		else if ((s = trie(d, x->son, map, out)) < 0 || x->end && (s = node(d, N_SPLIT, out, s)) < 0)
+			return -1;
+		if ((k = mapped(d, map, x->c, s)) < 0 || r >= 0 && (k = node(d, N_SPLIT, k, r)) < 0)
+			return -1;
+		r = k;
+	}
+	return r;
+}
+
+/*
+ * nfa for the rex list followed by out
+ * -1 if rex has parts that need the backtracking executor
+ */
+
+static int
+build(register Dfa_t* d, register Rex_t* rex, int out)
+{
+	register int		i;
+	register int		k;
+	register unsigned char*	s;
+	int			x;
+
+	if (!rex)
+		return out;
+	if (rex->next && (out = build(d, rex->next, out)) < 0)
+		return -1;
+	switch (rex->type)
+	{
+	case REX_NULL:
+		return out;
+	case REX_ALT:
+		if (rex->next || !rex->re.group.expr.binary.left || !rex->re.group.expr.binary.right)
+			return -1;
+		if ((i = build(d, rex->re.group.expr.binary.left, out)) < 0 || (k = build(d, rex->re.group.expr.binary.right, out)) < 0)
+			return -1;
+		return node(d, N_SPLIT, i, k);
+	case REX_BEG:
+	case REX_END:
+		if ((k = node(d, rex->type == REX_BEG ? N_BEG : N_END, out, -1)) >= 0 && (rex->flags & REG_NEWLINE))
+		{
+			d->node[k].nl = 1;
+			if (rex->type == REX_BEG)
+				d->nl = 1;
+		}
+		return k;
+	case REX_BEG_STR:
+		return node(d, N_BEG_STR, out, -1);
+	case REX_FIN_STR:
+		return node(d, N_FIN, out, -1);
+	case REX_CLASS:
+	case REX_DOT:
+	case REX_ONECHAR:
+	case REX_REP:
+		return repeat(d, rex, out);
+	case REX_GROUP:
+		return build(d, rex->re.group.expr.rex, out);
+	case REX_KMP:
+	case REX_STRING:
+		s = rex->re.string.base;
+		for (i = rex->re.string.size; i-- > 0;)
+			if ((out = mapped(d, rex->map, s[i], out)) < 0)
+				return -1;
+		if (rex->type == REX_KMP)
+		{
+			if ((i = node(d, N_SPLIT, out, -1)) < 0 || (k = node(d, N_CHAR, i, -1)) < 0)
+				return -1;
+			memset(&d->node[k].set, ~0, sizeof(d->node[k].set));
+			d->node[i].alt = k;
+			out = i;
+		}
+		return out;
+	case REX_TRIE:
+		for (k = -1, i = 0; i <= UCHAR_MAX; i++)
+			if (rex->re.trie.root[i])
+			{
+				if ((x = trie(d, rex->re.trie.root[i], rex->map, out)) < 0 || k >= 0 && (x = node(d, N_SPLIT, x, k)) < 0)
+					return -1;
+				k = x;
+			}
+		return k;
+	}
+	return -1;
+}
+
+/*
+ * epsilon closure of the seed nodes in context ctx with lookahead look
+ * the CHAR, MATCH and unresolved END/FIN nodes are left in d->list
+ * non-zero returned if MATCH is in the closure
+ */
+
+#define PUSH(d,k,n)	do { if ((d)->mark[k] != (d)->gen) { (d)->mark[k] = (d)->gen; (d)->stack[n++] = (k); } } while (0)
+
+static int
+closure(register Dfa_t* d, int* seed, int n, int ctx, int look)
+{
+	register Dfanode_t*	x;
+	register int		k;
+	register int		p;
+	int			match;
+
+	if (++d->gen <= 0)
+	{
+		memset(d->mark, 0, d->nodes * sizeof(int));
+		d->gen = 1;
+	}
+	match = 0;
+	d->size = 0;
+	p = 0;
+	while (n-- > 0)
+		PUSH(d, seed[n], p);
+	while (p > 0)
+	{
+		x = d->node + (k = d->stack[--p]);
+		switch (x->type)
+		{
+		case N_MATCH:
+			match = 1;
+			/*FALLTHROUGH*/
+		case N_CHAR:
+			d->list[d->size++] = k;
+			break;
+		case N_SPLIT:
+			PUSH(d, x->alt, p);
+			PUSH(d, x->out, p);
+			break;
+		case N_BEG:
+			if (ctx == C_BEG ? !(d->flags & REG_NOTBOL) : (ctx == C_NL && x->nl))
+				PUSH(d, x->out, p);
+			break;
+		case N_BEG_STR:
+			if (ctx == C_BEG)
+				PUSH(d, x->out, p);
+			break;
+		case N_END:
+			if (look == L_NONE)
+				d->list[d->size++] = k;
+			else if (look == L_EOS ? !(d->flags & REG_NOTEOL) : (look == '\n' && x->nl))
+				PUSH(d, x->out, p);
+			break;
+		case N_FIN:
+			if (look == L_NONE)
+				d->list[d->size++] = k;
+			else if (look == L_EOS)
+				PUSH(d, x->out, p);
+			break;
+		}
+	}
+	return match;
+}
+
+/*
+ * drop all cached states
+ */
+
+static void
+flush(register Dfa_t* d)
+{
+	register Dfastate_t*	s;
+	register Dfastate_t*	t;
+	register int		i;
+
+	for (i = 0; i < DFA_HASH; i++)
+	{
+		for (s = d->hash[i]; s; s = t)
+		{
+			t = s->link;
+			alloc(d->disc, s, 0);
+		}
+		d->hash[i] = 0;
+	}
+	d->states = 0;
+	d->begin = d->idle = 0;
+	d->flushed = 1;
+}
+
+static int
+byindex(const void* a, const void* b)
+{
+	return *(int*)a - *(int*)b;
+}
+
+/*
+ * return the state for the d->list closure in context ctx
+ */
+
+static Dfastate_t*
+lookup(register Dfa_t* d, int ctx, int match)
+{
+	register Dfastate_t*	s;
+	register unsigned int	h;
+	register int		i;
+
+	if (d->size > 1)
+		qsort(d->list, d->size, sizeof(int), byindex);
+	h = ctx;
+	for (i = 0; i < d->size; i++)
+		h = h * 31 + d->list[i];
+	for (s = d->hash[h % DFA_HASH]; s; s = s->link)
+		if (s->hash == h && s->ctx == ctx && s->size == d->size && !memcmp(s->node, d->list, d->size * sizeof(int)))
+			return s;
+	if (d->states >= DFA_STATES)
+		flush(d);
+	if (!(s = (Dfastate_t*)alloc(d->disc, 0, sizeof(Dfastate_t) + d->size * sizeof(int))))
+		return 0;
+	memset(s->next, 0, sizeof(s->next));
+	s->hash = h;
+	s->ctx = ctx;
+	s->match = match;
+	s->eos = E_UNKNOWN;
+	s->size = d->size;
+	memcpy(s->node, d->list, d->size * sizeof(int));
+	s->link = d->hash[h % DFA_HASH];
+	d->hash[h % DFA_HASH] = s;
+	d->states++;
+	return s;
+}
+
+/*
+ * the transition from s on c
+ */
+
+static Dfastate_t*
+transition(register Dfa_t* d, register Dfastate_t* s, int c)
+{
+	register Dfanode_t*	x;
+	register Dfastate_t*	t;
+	register int		i;
+	register int		n;
+	int*			seed;
+	int			ctx;
+
+	d->flushed = 0;
+	if (closure(d, s->node, s->size, s->ctx, c))
+		t = &d->hit;
+	else
+	{
+		seed = d->stack + d->nodes;
+		for (n = i = 0; i < d->size; i++)
+			if ((x = d->node + d->list[i])->type == N_CHAR && settst(&x->set, c))
+				seed[n++] = x->out;
+		if (!(d->flags & REG_LEFT))
+			seed[n++] = d->start;
+		ctx = c == '\n' ? C_NL : C_CHAR;
+		if (!(t = lookup(d, ctx, closure(d, seed, n, ctx, L_NONE))))
+			return 0;
+	}
+	if (!d->flushed)
+		s->next[c] = t;
+	return t;
+}
+
+/*
+ * translate env->rex to an nfa
+ * 0 returned if the dfa can't be used for env
+ */
+
+static Dfa_t*
+compile(register Env_t* env)
+{
+	register Dfa_t*	d;
+	Rex_t*		rex;
+	int		k;
+
+	if (!(d = (Dfa_t*)alloc(env->disc, 0, sizeof(Dfa_t))))
+		return 0;
+	memset(d, 0, sizeof(*d));
+	d->disc = env->disc;
+	env->dfa = d;
+	if (!(rex = env->rex) || rex->type == REX_BM && !(rex = rex->next))
+		d->bad = 1;
+	else if (env->leading >= 0)
+		d->bad = 1;
+	else if ((k = node(d, N_MATCH, -1, -1)) < 0 || (d->start = build(d, rex, k)) < 0)
+		d->bad = 1;
+	else if (!(d->list = (int*)alloc(d->disc, 0, (4 * d->nodes + 1) * sizeof(int))))
+		d->bad = 1;
+	else
+	{
+		d->stack = d->list + d->nodes;
+		d->mark = d->stack + 2 * d->nodes + 1;
+		memset(d->mark, 0, d->nodes * sizeof(int));
+		d->hit.match = 1;
+		d->hit.eos = 1;
+	}
+	if (d->bad && d->node)
+	{
+		alloc(d->disc, d->node, 0);
+		d->node = 0;
+	}
+	return d;
+}
+
+/*
+ * lazy dfa match on the subject s..e
+ * 1 for match, 0 for no match, -1 if the dfa can't be used
+ */
+
+int
+dfaexec(register Env_t* env, unsigned char* s, unsigned char* e, regflags_t flags)
+{
+	register Dfa_t*		d;
+	register Dfastate_t*	p;
+	register Dfastate_t*	q;
+	register Dfastate_t*	idle;
+	unsigned char*		t;
+	int			skip;
+
+	if (mbwide() || (env->disc->re_flags & REG_NOFREE))
+		return -1;
+	if (!(d = env->dfa) && !(d = compile(env)) || d->bad)
+		return -1;
+	flags = ((flags & REG_LEFT) || env->once ? REG_LEFT : 0) | (env->flags & (REG_NOTBOL|REG_NOTEOL));
+	if (flags != d->flags)
+	{
+		flush(d);
+		d->flags = flags;
+	}
+	if (!(p = d->begin))
+	{
+		if (d->states >= DFA_STATES - 1)
+			flush(d);
+		if (!(d->idle = lookup(d, C_CHAR, closure(d, &d->start, 1, C_CHAR, L_NONE))) ||
+		    !(p = lookup(d, C_BEG, closure(d, &d->start, 1, C_BEG, L_NONE))))
+			return -1;
+		d->begin = p;
+	}
+	if (p->match)
+		return 1;
+
+	/*
+	 * in the idle state (no partial match in progress) memchr()
+	 * to the only char that can start a match; a first char set
+	 * scan costs as much as the dfa transitions it would skip
+	 * idle is a local so the loop does not reload it for each char,
+	 * and it is refreshed after transition() since that may flush
+	 */
+
+	skip = env->firstc >= 0 && !d->nl && !(flags & REG_LEFT);
+	idle = skip ? d->idle : 0;
+	for (; s < e; s++)
+	{
+		if (p == idle)
+		{
+			if (!(t = (unsigned char*)memchr(s, env->firstc, e - s)))
+				break;
+			s = t;
+		}
+		if (!(q = p->next[*s]))
+		{
+			if (!(q = transition(d, p, *s)))
+				return -1;
+			if (skip)
+				idle = d->idle;
+		}
+		if ((p = q)->match)
+			return 1;
+		if (!p->size && (flags & REG_LEFT))
+			return 0;
+	}
+	if (p->eos == E_UNKNOWN)
+		p->eos = closure(d, p->node, p->size, p->ctx, L_EOS);
+	return p->eos;
+}
+
+/*
+ * free the dfa
+ */
+
+void
+dfafree(Env_t* env)
+{
+	register Dfa_t*	d;
+
+	if (d = env->dfa)
+	{
+		env->dfa = 0;
+		flush(d);
+		if (d->node)
+			alloc(d->disc, d->node, 0);
+		if (d->list)
+			alloc(d->disc, d->list, 0);
+		alloc(d->disc, d, 0);
+	}
+}
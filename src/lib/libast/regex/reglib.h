@@ -39,6 +39,8 @@
 
 #define alloc		_reg_alloc
 #define classfun	_reg_classfun
+#define dfaexec		_reg_dfaexec
+#define dfafree		_reg_dfafree
 #define drop		_reg_drop
 #define fatal		_reg_fatal
 #define state		_reg_state
@@ -537,6 +539,10 @@ typedef struct reglib_s			/* library private regex_t info	*/
 	regmatch_t*	match;		/* subexrs in current match 	*/
 	regmatch_t*	best;		/* ditto in best match yet	*/
 	Stk_pos_t	stk;		/* exec stack pos		*/
+	struct Dfa_s*	dfa;		/* lazy dfa for regnexec()	*/
+	Set_t*		first;		/* chars that can start a match	*/
+	int		firstc;		/* first if it has one char	*/
+	int		must;		/* char in every match		*/
 	size_t		min;		/* minimum match length		*/
 	size_t		nsub;		/* internal re_nsub		*/
 	regflags_t	flags;		/* flags from regcomp()		*/
@@ -582,6 +588,8 @@ extern State_t		state;
 
 extern void*		alloc(regdisc_t*, void*, size_t);
 extern regclass_t	classfun(int);
+extern int		dfaexec(Env_t*, unsigned char*, unsigned char*, regflags_t);
+extern void		dfafree(Env_t*);
 extern void		drop(regdisc_t*, Rex_t*);
 extern int		fatal(regdisc_t*, int, const char*);
 
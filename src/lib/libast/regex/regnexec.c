@@ -1837,6 +1837,22 @@ list(Env_t* env, Rex_t* rex)
 
 #endif
 
+/*
+ * return the number of chars from s to the next
+ * char in env->first -- the only possible match starts
+ */
+
+static ssize_t
+first(register Env_t* env, register unsigned char* s)
+{
+	register unsigned char*	t;
+
+	if (env->firstc >= 0)
+		return (t = (unsigned char*)memchr(s, env->firstc, env->end - s)) ? t - s : env->end - s;
+	for (t = s; t < env->end && !settst(env->first, *t); t++);
+	return t - s;
+}
+
 /*
  * returning REG_BADPAT or REG_ESPACE is not explicitly
  * countenanced by the standard
@@ -1865,12 +1881,40 @@ regnexec(const regex_t* p, const char* s, size_t len, size_t nmatch, regmatch_t*
 		DEBUG_TEST(0x0080,(sfprintf(sfstdout, "AHA#%04d REG_NOMATCH %d %d\n", __LINE__, len, env->min)),(0));
 		return REG_NOMATCH;
 	}
+	if (env->must >= 0 && !memchr(s, env->must, len))
+	{
+		DEBUG_TEST(0x0080,(sfprintf(sfstdout, "AHA#%04d REG_NOMATCH must '%c'\n", __LINE__, env->must)),(0));
+		return REG_NOMATCH;
+	}
 	env->regex = p;
 	env->beg = (unsigned char*)s;
 	env->end = env->beg + len;
 	stknew(stkstd, &env->stk);
 	env->flags &= ~REG_EXEC;
 	env->flags |= (flags & REG_EXEC);
+	if (env->rex->type != REX_BM && (i = dfaexec(env, env->beg, env->end, flags)) >= 0)
+	{
+		/*
+		 * the lazy dfa decides match/nomatch in linear time
+		 * parse() is still needed for subexpression offsets
+		 * and it still backtracks on a subject that matches,
+		 * exponentially for some expressions -- only the
+		 * nomatch case is bounded when nmatch>0
+		 */
+
+		if (!i)
+		{
+			k = REG_NOMATCH;
+			goto done;
+		}
+		if (!nmatch || (env->flags & REG_NOSUB))
+		{
+			if (!(env->flags & REG_NOSUB) && (env->flags & (REG_SHELL|REG_AUGMENTED)) == (REG_SHELL|REG_AUGMENTED))
+				((regex_t*)p)->re_nsub = 0;
+			k = 0;
+			goto done;
+		}
+	}
 	advance = 0;
 	if (env->stack = env->hard || !(env->flags & REG_NOSUB) && nmatch)
 	{
@@ -1967,11 +2011,22 @@ regnexec(const regex_t* p, const char* s, size_t len, size_t nmatch, regmatch_t*
 	}
 	j = env->once || (flags & REG_LEFT);
 	DEBUG_TEST(0x0080,(sfprintf(sfstdout, "AHA#%04d parse once=%d\n", __LINE__, j)),(0));
+	if (!j && env->first && !mbwide())
+	{
+		i = first(env, (unsigned char*)s);
+		s += i;
+		if ((unsigned char*)s > env->end - env->min)
+			goto done;
+		if (env->stack)
+			env->best[0].rm_so += i;
+	}
 	while ((i = parse(env, e, &env->done, (unsigned char*)s)) == NONE || advance && !env->best[0].rm_eo && !(advance = 0))
 	{
 		if (j)
 			goto done;
 		i = MBSIZE(s);
+		if (env->first && !mbwide())
+			i += first(env, (unsigned char*)s + i);
 		s += i;
 		if ((unsigned char*)s > env->end - env->min)
 			goto done;
@@ -2034,6 +2089,10 @@ regfree(regex_t* p)
 		if (--env->refs <= 0 && !(env->disc->re_flags & REG_NOFREE))
 		{
 			drop(env->disc, env->rex);
+			if (env->dfa)
+				dfafree(env);
+			if (env->first)
+				alloc(env->disc, env->first, 0);
 			if (env->pos)
 				vecclose(env->pos);
 			if (env->bestpos)
@@ -0,0 +1,574 @@
+/***********************************************************************
+*                                                                      *
+*               This software is part of the ast package               *
+*          Copyright (c) 1985-2011 AT&T Intellectual Property          *
+*                      and is licensed under the                       *
+*                 Eclipse Public License, Version 1.0                  *
+*                    by AT&T Intellectual Property                     *
+*                                                                      *
+*                A copy of the License is available at                 *
+*          http://www.eclipse.org/org/documents/epl-v10.html           *
+*         (with md5 checksum b35adb5213ca9657e911e9befb180842)         *
+*                                                                      *
+*              Information and Software Systems Research               *
+*                            AT&T Research                             *
+*                           Florham Park NJ                            *
+*                                                                      *
+*                 Glenn Fowler <gsf@research.att.com>                  *
+*                  David Korn <dgk@research.att.com>                   *
+*                   Phong Vo <kpv@research.att.com>                    *
+*                                                                      *
+***********************************************************************/
+#pragma prototyped
+
+/*
+ * posix regex set executor
+ *
+ * a set of compiled expressions is matched against a subject in
+ * one pass of an Aho-Corasick automaton built from the literal
+ * strings each expression requires; expressions whose literal is
+ * the whole expression match on the automaton hit alone, the other
+ * hits (and expressions with no required literal) are confirmed
+ * with regnexec()
+ */
+
+#include "reglib.h"
+
+typedef struct Setkey_s			/* literal key			*/
+{
+	int		next;		/* next key ending at same node	*/
+	int		index;		/* regex index			*/
+	int		exact;		/* key match is the regex match	*/
+} Setkey_t;
+
+typedef struct Setnode_s		/* automaton node		*/
+{
+	int		son;		/* first child			*/
+	int		sib;		/* next sibling			*/
+	int		fail;		/* failure link			*/
+	int		dict;		/* next node on fail path w/keys*/
+	int		key;		/* first key ending here	*/
+	unsigned char	c;		/* edge char			*/
+} Setnode_t;
+
+typedef struct Setedge_s		/* hashed automaton edge	*/
+{
+	unsigned int	key;		/* EDGE(node,c), 0 if empty	*/
+	int		son;		/* child node			*/
+} Setedge_t;
+
+#define EDGE(n,c)	(((unsigned int)(n)<<CHAR_BIT)|(c))
+#define HASH(s,k)	(((k)*2654435761U)>>(s)->shift)
+
+struct regset_s
+{
+	regdisc_t*	disc;		/* allocation discipline	*/
+	regex_t**	re;		/* the expressions		*/
+	int		nre;		/* # expressions		*/
+	int		mre;		/* # allocated expressions	*/
+	Setnode_t*	node;		/* automaton nodes		*/
+	int		nnode;		/* # nodes			*/
+	int		mnode;		/* # allocated nodes		*/
+	Setedge_t*	edge;		/* node edge hash		*/
+	unsigned int	mask;		/* edge hash size - 1		*/
+	int		shift;		/* HASH() shift			*/
+	Setkey_t*	key;		/* keys				*/
+	int		nkey;		/* # keys			*/
+	int		mkey;		/* # allocated keys		*/
+	int*		always;		/* expressions with no key	*/
+	int		nalways;	/* # always			*/
+	unsigned int*	seen;		/* candidate generation marks	*/
+	unsigned int*	sure;		/* exact match generation marks	*/
+	unsigned int	gen;		/* current generation		*/
+	size_t*		cand;		/* candidate indices		*/
+	unsigned char*	map;		/* key fold map			*/
+	int		built;		/* automaton is current		*/
+	int		root[UCHAR_MAX+1]; /* root transitions		*/
+};
+
+/*
+ * grow the array *p of *m elements of size z to hold n+1
+ */
+
+static int
+grow(regdisc_t* disc, void** p, int* m, int n, size_t z)
+{
+	void*	v;
+	int	k;
+
+	if (n < *m)
+		return 0;
+	k = *m ? 2 * *m : 256;
+	if (!(v = alloc(disc, *p, k * z)))
+		return -1;
+	*p = v;
+	*m = k;
+	return 0;
+}
+
+/*
+ * return the child of node n on c, creating it if x!=0
+ * 0 (the root) returned if there is no child
+ */
+
+static int
+child(register regset_t* set, int n, int c, int x)
+{
+	register Setnode_t*	p;
+	register int		k;
+
+	if (!n)
+		k = set->root[c];
+	else
+		for (k = set->node[n].son; k && set->node[k].c != c; k = set->node[k].sib);
+	if (k || !x)
+		return k;
+	if (grow(set->disc, (void**)&set->node, &set->mnode, set->nnode, sizeof(Setnode_t)))
+		return -1;
+	p = set->node + (k = set->nnode++);
+	memset(p, 0, sizeof(*p));
+	p->key = -1;
+	p->c = c;
+	if (n)
+	{
+		p->sib = set->node[n].son;
+		set->node[n].son = k;
+	}
+	else
+		set->root[c] = k;
+	return k;
+}
+
+/*
+ * add a key for regex index i ending at node n
+ */
+
+static int
+key(register regset_t* set, int n, int i, int exact)
+{
+	register Setkey_t*	k;
+	register int		j;
+
+	for (j = set->node[n].key; j >= 0; j = set->key[j].next)
+		if (set->key[j].index == i)
+		{
+			if (exact)
+				set->key[j].exact = 1;
+			return 0;
+		}
+	if (grow(set->disc, (void**)&set->key, &set->mkey, set->nkey, sizeof(Setkey_t)))
+		return -1;
+	k = set->key + set->nkey;
+	k->index = i;
+	k->exact = exact;
+	k->next = set->node[n].key;
+	set->node[n].key = set->nkey++;
+	return 0;
+}
+
+/*
+ * add the string s of n chars with fold map for regex index i
+ */
+
+static int
+string(register regset_t* set, unsigned char* s, size_t n, unsigned char* map, int i, int exact)
+{
+	register int	k;
+
+	if (map != set->map)
+	{
+		if (map)
+			return 1;
+		exact = 0;
+	}
+	for (k = 0; n-- > 0; s++)
+		if ((k = child(set, k, set->map && !map ? set->map[*s] : *s, 1)) < 0)
+			return -1;
+	return key(set, k, i, exact);
+}
+
+/*
+ * add the strings in the trie sibling list x below node n for regex index i
+ */
+
+static int
+trie(register regset_t* set, register Trie_node_t* x, int n, int i, int exact)
+{
+	register int	k;
+
+	for (; x; x = x->sib)
+	{
+		if ((k = child(set, n, x->c, 1)) < 0)
+			return -1;
+		if (x->end && key(set, k, i, exact))
+			return -1;
+		if (x->son && trie(set, x->son, k, i, exact))
+			return -1;
+	}
+	return 0;
+}
+
+/*
+ * return the longest literal required by every match of the rex list e
+ */
+
+static Rex_t*
+required(register Rex_t* e, Rex_t* r)
+{
+	for (; e; e = e->next)
+		switch (e->type)
+		{
+		case REX_ALT:
+			return r;
+		case REX_GROUP:
+			r = required(e->re.group.expr.rex, r);
+			break;
+		case REX_KMP:
+		case REX_STRING:
+			if (!r || r->type == REX_TRIE || r->re.string.size < e->re.string.size)
+				r = e;
+			break;
+		case REX_REP:
+			if (e->lo)
+				r = required(e->re.group.expr.rex, r);
+			break;
+		case REX_TRIE:
+			if (!r || r->type == REX_TRIE && r->re.trie.min < e->re.trie.min)
+				r = e;
+			break;
+		}
+	return r;
+}
+
+/*
+ * add the keys for regex index i
+ * 1 returned if the regex has no usable key
+ */
+
+static int
+keys(register regset_t* set, int i)
+{
+	register Rex_t*	e;
+	register Rex_t*	r;
+	int		exact;
+	int		n;
+
+	if (!(e = set->re[i]->env->rex))
+		return 1;
+	if (e->type == REX_BM)
+		e = e->next;
+	exact = !e->next && !(set->re[i]->env->flags & REG_LEFT);
+	if (!e->next && (e->type == REX_KMP || e->type == REX_STRING || e->type == REX_TRIE || e->type == REX_ONECHAR && e->lo == 1 && e->hi == 1))
+		r = e;
+	else
+	{
+		exact = 0;
+		if (!(r = required(e, NiL)))
+			return 1;
+	}
+	switch (r->type)
+	{
+	case REX_ONECHAR:
+		return string(set, &r->re.onechar, 1, r->map, i, exact);
+	case REX_KMP:
+	case REX_STRING:
+		if (!r->re.string.size)
+			return 1;
+		return string(set, r->re.string.base, r->re.string.size, r->map, i, exact);
+	case REX_TRIE:
+		if (r->map != set->map)
+			return 1;
+		for (n = 0; n <= UCHAR_MAX; n++)
+			if (r->re.trie.root[n] && trie(set, r->re.trie.root[n], 0, i, exact))
+				return -1;
+		return 0;
+	}
+	return 1;
+}
+
+/*
+ * build the automaton
+ */
+
+static int
+build(register regset_t* set)
+{
+	register Setnode_t*	p;
+	register int		i;
+	register int		k;
+	register int		n;
+	int*			q;
+	int			h;
+	int			t;
+	Rex_t*			e;
+
+	if (set->node)
+		alloc(set->disc, set->node, 0);
+	if (set->key)
+		alloc(set->disc, set->key, 0);
+	if (set->edge)
+		alloc(set->disc, set->edge, 0);
+	set->node = 0;
+	set->key = 0;
+	set->edge = 0;
+	set->nnode = set->mnode = set->nkey = set->mkey = set->nalways = 0;
+	memset(set->root, 0, sizeof(set->root));
+	set->map = 0;
+	for (i = 0; i < set->nre; i++)
+		if ((e = set->re[i]->env->rex) && (e->type != REX_BM || (e = e->next)) && e->map)
+		{
+			set->map = e->map;
+			break;
+		}
+	if (child(set, 0, 0, 1) < 0)
+		return -1;
+	set->root[0] = 0;
+	for (i = 0; i < set->nre; i++)
+		if ((k = keys(set, i)) < 0)
+			return -1;
+		else if (k)
+			set->always[set->nalways++] = i;
+
+	/*
+	 * breadth first failure and dictionary links
+	 */
+
+	if (!(q = (int*)alloc(set->disc, 0, set->nnode * sizeof(int))))
+		return -1;
+	h = t = 0;
+	for (i = 0; i <= UCHAR_MAX; i++)
+		if (k = set->root[i])
+		{
+			set->node[k].fail = set->node[k].dict = 0;
+			q[t++] = k;
+		}
+	while (h < t)
+	{
+		n = q[h++];
+		for (k = set->node[n].son; k; k = set->node[k].sib)
+		{
+			p = set->node + k;
+			for (i = set->node[n].fail; i && !child(set, i, p->c, 0); i = set->node[i].fail);
+			if ((i = child(set, i, p->c, 0)) == k)
+				i = 0;
+			p->fail = i;
+			p->dict = set->node[i].key >= 0 ? i : set->node[i].dict;
+			q[t++] = k;
+		}
+	}
+	alloc(set->disc, q, 0);
+
+	/*
+	 * the sibling lists are too slow to search while scanning
+	 * so the non-root edges are hashed on EDGE(node,c)
+	 */
+
+	if (set->nnode > (1 << (sizeof(int) * CHAR_BIT - CHAR_BIT - 1)))
+		return -1;
+	for (i = 2, set->shift = sizeof(unsigned int) * CHAR_BIT - 1; i < 2 * set->nnode; i <<= 1, set->shift--);
+	set->mask = i - 1;
+	if (!(set->edge = (Setedge_t*)alloc(set->disc, 0, i * sizeof(Setedge_t))))
+		return -1;
+	memset(set->edge, 0, i * sizeof(Setedge_t));
+	for (n = 1; n < set->nnode; n++)
+		for (k = set->node[n].son; k; k = set->node[k].sib)
+		{
+			for (i = HASH(set, EDGE(n, set->node[k].c)); set->edge[i].key; i = (i + 1) & set->mask);
+			set->edge[i].key = EDGE(n, set->node[k].c);
+			set->edge[i].son = k;
+		}
+	set->built = 1;
+	return 0;
+}
+
+/*
+ * open an empty set
+ */
+
+regset_t*
+regsetopen(regdisc_t* disc)
+{
+	regset_t*	set;
+
+	if (!disc)
+		disc = &state.disc;
+	if (!(set = (regset_t*)alloc(disc, 0, sizeof(regset_t))))
+		return 0;
+	memset(set, 0, sizeof(*set));
+	set->disc = disc;
+	return set;
+}
+
+/*
+ * add p to the set
+ * the set index of p is the number of previous regsetadd() calls
+ * p belongs to the set from here on: the automaton subsumes the
+ * Boyer-Moore prefilter of p, so it is freed to keep the space for
+ * large sets in check, and p alone still matches, but without it
+ */
+
+int
+regsetadd(regset_t* set, regex_t* p)
+{
+	Rex_t*	e;
+	void*	v;
+	int	n;
+
+	if (!set || !p || !p->env)
+		return REG_BADPAT;
+	if ((e = p->env->rex) && e->type == REX_BM && e->next)
+	{
+		p->env->rex = e->next;
+		e->next = 0;
+		drop(p->env->disc, e);
+	}
+	if (set->nre >= set->mre)
+	{
+		n = set->mre ? 2 * set->mre : 64;
+		if (!(v = alloc(set->disc, set->re, n * sizeof(regex_t*))))
+			return REG_ESPACE;
+		set->re = (regex_t**)v;
+		if (!(v = alloc(set->disc, set->always, n * sizeof(int))))
+			return REG_ESPACE;
+		set->always = (int*)v;
+		if (!(v = alloc(set->disc, set->seen, n * sizeof(unsigned int))))
+			return REG_ESPACE;
+		set->seen = (unsigned int*)v;
+		if (!(v = alloc(set->disc, set->sure, n * sizeof(unsigned int))))
+			return REG_ESPACE;
+		set->sure = (unsigned int*)v;
+		if (!(v = alloc(set->disc, set->cand, n * sizeof(size_t))))
+			return REG_ESPACE;
+		set->cand = (size_t*)v;
+		set->mre = n;
+	}
+	set->seen[set->nre] = set->sure[set->nre] = 0;
+	set->re[set->nre++] = p;
+	set->built = 0;
+	return 0;
+}
+
+static int
+byindex(const void* a, const void* b)
+{
+	return *(size_t*)a < *(size_t*)b ? -1 : *(size_t*)a > *(size_t*)b;
+}
+
+/*
+ * match the set against the len char subject s
+ * the set indices of up to nindex matching expressions are
+ * stored in index in ascending order and the number stored is
+ * returned, -1 on error
+ */
+
+ssize_t
+regsetexec(regset_t* set, const char* s, size_t len, size_t nindex, size_t* index, regflags_t flags)
+{
+	register unsigned char*	u;
+	register unsigned char*	e;
+	register Setnode_t*	node;
+	register Setedge_t*	edge;
+	register unsigned int	x;
+	register unsigned int	j;
+	register int		n;
+	register int		k;
+	unsigned char*		map;
+	ssize_t			m;
+	size_t			c;
+	size_t			i;
+	int			r;
+
+	if (!set || !s)
+		return -1;
+	if (!set->built && build(set))
+		return -1;
+	if (!++set->gen)
+	{
+		memset(set->seen, 0, set->nre * sizeof(unsigned int));
+		memset(set->sure, 0, set->nre * sizeof(unsigned int));
+		set->gen = 1;
+	}
+	node = set->node;
+	edge = set->edge;
+	map = set->map;
+	c = 0;
+	if (set->nkey)
+		for (u = (unsigned char*)s, e = u + len, n = 0; u < e; u++)
+		{
+			r = map ? map[*u] : *u;
+			for (;;)
+			{
+				if (!n)
+				{
+					n = set->root[r];
+					break;
+				}
+				x = EDGE(n, r);
+				for (j = HASH(set, x); edge[j].key; j = (j + 1) & set->mask)
+					if (edge[j].key == x)
+						break;
+				if (edge[j].key)
+				{
+					n = edge[j].son;
+					break;
+				}
+				n = node[n].fail;
+			}
+			for (k = node[n].key >= 0 ? n : node[n].dict; k; k = node[k].dict)
+				for (r = node[k].key; r >= 0; r = set->key[r].next)
+				{
+					i = set->key[r].index;
+					if (set->seen[i] != set->gen)
+					{
+						set->seen[i] = set->gen;
+						set->cand[c++] = i;
+					}
+					if (set->key[r].exact && !(flags & REG_LEFT))
+						set->sure[i] = set->gen;
+				}
+		}
+	for (n = 0; n < set->nalways; n++)
+		set->cand[c++] = set->always[n];
+	if (c > 1)
+		qsort(set->cand, c, sizeof(size_t), byindex);
+	for (m = 0, i = 0; i < c && m < nindex; i++)
+		if (set->sure[set->cand[i]] == set->gen)
+			index[m++] = set->cand[i];
+		else if (!(r = regnexec(set->re[set->cand[i]], s, len, 0, NiL, flags)))
+			index[m++] = set->cand[i];
+		else if (r != REG_NOMATCH)
+			return -1;
+	return m;
+}
+
+/*
+ * close the set -- the expressions are not freed
+ */
+
+int
+regsetclose(regset_t* set)
+{
+	regdisc_t*	disc;
+
+	if (!set)
+		return -1;
+	disc = set->disc;
+	if (set->re)
+		alloc(disc, set->re, 0);
+	if (set->always)
+		alloc(disc, set->always, 0);
+	if (set->seen)
+		alloc(disc, set->seen, 0);
+	if (set->sure)
+		alloc(disc, set->sure, 0);
+	if (set->cand)
+		alloc(disc, set->cand, 0);
+	if (set->node)
+		alloc(disc, set->node, 0);
+	if (set->key)
+		alloc(disc, set->key, 0);
+	if (set->edge)
+		alloc(disc, set->edge, 0);
+	alloc(disc, set, 0);
+	return 0;
+}
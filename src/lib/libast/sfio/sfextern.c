@@ -61,6 +61,7 @@ Sfextern_t _Sfextern =
 
 ssize_t	_Sfi = -1;		/* value for a few fast macro functions	*/
 ssize_t _Sfmaxr = 0;		/* default (unlimited) max record size	*/
+ssize_t _Sfmaxm = 0;		/* SF_MAXM mmap window size, 0 for default */
 
 #if vt_threaded
 static Vtmutex_t	_Sfmtxin, _Sfmtxout, _Sfmtxerr;
@@ -118,6 +118,17 @@ int		type;
 		/* amount to be read */
 		n = s - f->next;
 
+		/* a mapped stream remaps the window at the record start
+		   so that the record is returned in place without a copy */
+		if(!found && !us && (f->bits&SF_MMAP) && !(f->flags&SF_STRING) &&
+		   (_Sfmaxr <= 0 || n+1 < _Sfmaxr) )
+		{	(void)SFFILBUF(f,n+1);
+			if((f->endb - f->next) > n)
+				continue;
+			/* a short window holds at most the rest of the record */
+			n = f->endb - f->next;
+		}
+
 		if(!found && (_Sfmaxr > 0 && un+n+1 >= _Sfmaxr || (f->flags&SF_STRING))) /* already exceed limit */
 		{	us = NIL(uchar*);
 			goto done;
@@ -299,6 +299,12 @@
 #undef MAP_TYPE
 #endif
 
+/* see if buffered data can be written together with sfwrite() data */
+#if _lib_writev && _sys_uio
+#include	<sys/uio.h>
+#define _sfwritev	1
+#endif
+
 #include	"FEATURE/float"
 
 #include	<errno.h>
@@ -853,6 +859,9 @@ typedef struct _sfextern_s
 #define SF_NMAP		32
 #endif
 
+/* SF_MAXM windows at least this size get huge page advice */
+#define SF_HUGEPAGE	(2*1024*1024)
+
 #ifndef MAP_VARIABLE
 #define MAP_VARIABLE	0
 #endif
@@ -877,6 +886,17 @@ typedef struct _sfextern_s
 #define SFMMSEQOFF(f,a,s)
 #endif
 
+/* large SF_MAXM windows may be backed by huge pages */
+#if _lib_madvise && defined(MADV_HUGEPAGE)
+#define SFMMHUGE(f,a,s) \
+		do { int oerrno = errno; \
+		     (void)madvise((caddr_t)(a),(size_t)(s),MADV_HUGEPAGE); \
+		     errno = oerrno; \
+		} while(0)
+#else
+#define SFMMHUGE(f,a,s)
+#endif
+
 #define SFMUNMAP(f,a,s)		(sysmunmapf((caddr_t)(a),(size_t)(s)), \
 				 ((f)->endb = (f)->endr = (f)->endw = (f)->next = \
 				  (f)->data = NIL(uchar*)) )
@@ -1183,6 +1203,7 @@ extern Sfrsrv_t*	_sfrsrv _ARG_((Sfio_t*, ssize_t));
 extern int		_sfsetpool _ARG_((Sfio_t*));
 extern char*		_sfcvt _ARG_((Void_t*,char*,size_t,int,int*,int*,int*,int));
 extern char**		_sfgetpath _ARG_((char*));
+extern ssize_t		_sfwrv _ARG_((Sfio_t*, const Void_t*, size_t));
 
 #if _BLD_sfio && defined(__EXPORT__)
 #define extern		__EXPORT__
@@ -1192,6 +1213,7 @@ extern char**		_sfgetpath _ARG_((char*));
 #endif
 
 extern Sfextern_t	_Sfextern;
+extern ssize_t		_Sfmaxm;
 
 extern int		_sfmode _ARG_((Sfio_t*, int, int));
 extern int		_sftype _ARG_((const char*, int*, int*, int*));
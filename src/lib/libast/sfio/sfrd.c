@@ -188,8 +188,10 @@ Sfdisc_t*	disc;
 			}
 
 			if(f->data)
-			{	if(f->bits&SF_SEQUENTIAL)
+			{	if((f->bits&SF_SEQUENTIAL) || _Sfmaxm > 0)
 					SFMMSEQON(f,f->data,r);
+				if(_Sfmaxm >= SF_HUGEPAGE)
+					SFMMHUGE(f,f->data,r);
 				f->next = f->data+a;
 				f->endr = f->endb = f->data+r;
 				f->endw = f->data;
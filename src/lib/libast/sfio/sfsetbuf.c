@@ -68,6 +68,7 @@ static int sfsetlinemode()
 
 	static int		modes = -1;
 	static const char	sf_line[] = "SF_LINE";
+	static const char	sf_maxm[] = "SF_MAXM=";
 	static const char	sf_maxr[] = "SF_MAXR=";
 	static const char	sf_wcwidth[] = "SF_WCWIDTH";
 
@@ -83,6 +84,13 @@ static int sfsetlinemode()
 				if((endw-astsfio) > (sizeof(sf_line)-1) &&
 				   strncmp(astsfio,sf_line,sizeof(sf_line)-1) == 0)
 					modes |= SF_LINE;
+				else if((endw-astsfio) > (sizeof(sf_maxm)-1) &&
+				   strncmp(astsfio,sf_maxm,sizeof(sf_maxm)-1) == 0)
+#if _PACKAGE_ast
+					_Sfmaxm = (ssize_t)strtonll(astsfio+sizeof(sf_maxm)-1,NiL,NiL,0);
+#else
+					_Sfmaxm = (ssize_t)strtol(astsfio+sizeof(sf_maxm)-1,NiL,0);
+#endif
 				else if((endw-astsfio) > (sizeof(sf_maxr)-1) &&
 				   strncmp(astsfio,sf_maxr,sizeof(sf_maxr)-1) == 0)
 #if _PACKAGE_ast
@@ -329,11 +337,15 @@ size_t	size;	/* buffer size, -1 for default size */
 		if(!disc)
 		{	f->bits |= SF_MMAP;
 			if(size == (size_t)SF_UNBOUND)
-			{	if(bufsize > _Sfpage)
-					size = bufsize * SF_NMAP;
-				else	size = _Sfpage * SF_NMAP;
-				if(size > 256*1024)
-					size = 256*1024;
+			{	if(_Sfmaxm > 0) /* SFIO_OPTIONS=SF_MAXM=size */
+					size = ((_Sfmaxm + _Sfpage-1)/_Sfpage)*_Sfpage;
+				else
+				{	if(bufsize > _Sfpage)
+						size = bufsize * SF_NMAP;
+					else	size = _Sfpage * SF_NMAP;
+					if(size > 256*1024)
+						size = 256*1024;
+				}
 			}
 		}
 	}
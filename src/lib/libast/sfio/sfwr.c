@@ -250,3 +250,84 @@ Sfdisc_t*	disc;
 		disc = dc;
 	}
 }
+
+/* counts of vectored writes and the bytes they wrote */
+static Sfulong_t	Wrvcalls, Wrvbytes;
+
+/* Write the pending buffer and a large sfwrite() pass-through with one writev().
+** Return the amount of buf written, 0 if the caller should do it the usual way.
+*/
+#if __STD_C
+ssize_t _sfwrv(Sfio_t* f, const Void_t* buf, size_t n)
+#else
+ssize_t _sfwrv(f,buf,n)
+Sfio_t*		f;
+Void_t*		buf;
+size_t		n;
+#endif
+{
+#if _sfwritev
+	reg Sfdisc_t*	dc;
+	reg ssize_t	v, w;
+	struct iovec	iov[2];
+
+	if((f->flags&(SF_STRING|SF_WHOLE|SF_APPENDWR|SF_IOCHECK)) ||
+	   f->file < 0 || SFISNULL(f) || (v = f->next - f->data) <= 0 )
+		return 0;
+	for(dc = f->disc; dc; dc = dc->disc)
+		if(dc->writef)
+			return 0;
+
+	/* leave page aligned appends to sfoutput() to keep holes */
+	if(f->extent >= 0 && f->here == f->extent &&
+	   (ssize_t)n >= _Sfpage && ((f->here+v)%_Sfpage) == 0 )
+		return 0;
+
+	if(f->extent >= 0 && (f->flags&(SF_SHARE|SF_PUBLIC)) == SF_SHARE &&
+	   SFSK(f,f->here,SEEK_SET,f->disc) != f->here )
+		return 0;
+
+	iov[0].iov_base = (Void_t*)f->data;
+	iov[0].iov_len = v;
+	iov[1].iov_base = (Void_t*)buf;
+	iov[1].iov_len = n;
+	if((w = writev(f->file,iov,2)) <= 0)
+		return 0;
+
+	Wrvcalls += 1;
+	Wrvbytes += w;
+	f->flags &= ~(SF_EOF|SF_ERROR);
+	f->bits &= ~SF_HOLE;
+	if((f->flags&SF_PUBLIC) && f->extent >= 0)
+		f->here = SFSK(f,(Sfoff_t)0,SEEK_CUR,f->disc);
+	else	f->here += w;
+	if(f->extent >= 0 && f->here > f->extent)
+		f->extent = f->here;
+
+	if(w < v) /* only part of the buffer went out */
+	{	memmove(f->data,f->data+w,v-w);
+		f->next = f->data+(v-w);
+		return 0;
+	}
+
+	f->next = f->data;
+	return w-v;
+#else
+	return 0;
+#endif
+}
+
+#if __STD_C
+int sfwrstat(Sfulong_t* calls, Sfulong_t* bytes)
+#else
+int sfwrstat(calls, bytes)
+Sfulong_t*	calls;	/* number of vectored writes	*/
+Sfulong_t*	bytes;	/* bytes written by them	*/
+#endif
+{
+	if(calls)
+		*calls = Wrvcalls;
+	if(bytes)
+		*bytes = Wrvbytes;
+	return 0;
+}
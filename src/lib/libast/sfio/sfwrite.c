@@ -36,7 +36,7 @@ size_t		n;	/* number of bytes. 		*/
 #endif
 {
 	reg uchar	*s, *begs, *next;
-	reg ssize_t	w;
+	reg ssize_t	w, v;
 	reg int		local;
 	SFMTXDECL(f);
 
@@ -102,6 +102,15 @@ size_t		n;	/* number of bytes. 		*/
 			break;
 		}
 
+		/* write pending data and a large pass-through together */
+		if(f->next > f->data && SFDIRECT(f,n) && (v = _sfwrv(f,s,n)) > 0)
+		{	s += v;
+			if((n -= v) == 0)
+				break;
+			continue;
+		}
+		w = f->endb - f->next; /* _sfwrv() may have moved f->next */
+
 		/* attempt to create space in buffer */
 		if(w == 0 || ((f->flags&SF_WHOLE) && w < (ssize_t)n) )
 		{	if(f->flags&SF_STRING) /* extend buffer */
@@ -99,16 +99,28 @@ typedef struct ______mstats Mstats_t;
 **			on failure
 **	    break	try sbrk() block allocator first
 **	    check	if Vmregion==Vmbest then the region is checked every op
+**	    dump=f	the sample profile is written to file f, default &2
 **	    free	disable addfreelist()
+**	    interval=n	the sample profile is also rewritten every n seconds
 **	    keep	disable free -- if code works with this enabled then it
 **	    		probably accesses free'd data
+**	    lazy	with release, release pages with MADV_FREE where
+**			supported so they are only reclaimed under memory pressure
 **	    method=m	sets Vmregion=m if not defined, m (Vm prefix optional)
-**			may be one of { best debug last profile }
+**			may be one of { best debug last profile slab },
+**			the default is best
 **	    mmap	try mmap() block allocator first
 **	    period=n	sets Vmregion=Vmdebug if not defined, if
 **			Vmregion==Vmdebug the region is checked every n ops
 **	    profile=f	sets Vmregion=Vmprofile if not set, if
 **			Vmregion==Vmprofile then profile info printed to file f
+**	    release=n	after n bytes have been free()'d the region is
+**			compacted and the pages of free areas of at least n
+**			bytes are released to the system, n may have a k or m
+**			suffix, at least 16k, 1m if omitted, default 0 (off)
+**	    sample=n	sample about one malloc() per n bytes allocated and
+**			write a pprof heap profile of the sampled call stacks
+**			on exit, n may have a k or m suffix, default 512k
 **	    start=n	sets Vmregion=Vmdebug if not defined, if
 **			Vmregion==Vmdebug region checking starts after n ops
 **	    trace=f	enables tracing to file f
@@ -142,6 +154,7 @@ static Vmulong_t	_Vmdbstart = 0;
 static Vmulong_t	_Vmdbcheck = 0;
 static Vmulong_t	_Vmdbtime = 0;
 static int		_Vmpffd = -1;
+static int		_Vmsmpfd = -1;
 
 #if ( !_std_malloc || !_BLD_ast ) && !_AST_std_malloc
 
@@ -277,10 +290,26 @@ static unsigned int	Regmax = 0;
 #endif
 static unsigned int	Regnum = 0; 	/* current #concurrent regions	*/
 
+/* threads run on separate stacks so a stack address picks a home region */
+#define REGHOME(a)	((unsigned int)((((Vmulong_t)(a)) >> 20) * 2654435761U) >> 7)
+
 /* statistics */
 static unsigned int	Regopen = 0; 	/* #allocation calls opened	*/
 static unsigned int	Reglock = 0; 	/* #allocation calls locked	*/
 static unsigned int	Regprobe = 0; 	/* #probes to find a region	*/
+static unsigned int	Reghome = 0; 	/* #calls in the home region	*/
+static unsigned int	Regdirect = 0; 	/* #frees done in their region	*/
+static unsigned int	Regqueue = 0; 	/* #frees queued on Regfree	*/
+
+/* unlock a region locked by asocasint() -- a plain store of 0 could be
+** reordered before the region updates on weakly ordered cpus
+*/
+#define REGUNLOCK(vm)	((void)asocasint(&(vm)->data->lock, 1, 0))
+
+/* free() compacts the region after _Vmrelsize bytes to release pages */
+static size_t		Relfree = 0;	/* bytes freed since last release */
+#define RELEASE(vm,d)	(_Vmrelsize > 0 && ((vm)->meth.meth&(VM_MTBEST|VM_MTSLAB)) && \
+			 (Relfree += SIZE(BLOCK(d))&~BITS) >= _Vmrelsize && !(Relfree = 0) )
 
 int setregmax(int regmax)
 {
@@ -313,12 +342,17 @@ int _mallocstat(Vmstat_t* st)
 		st->m_free += vmst.m_free;
 		st->n_seg  += vmst.n_seg;
 		st->extent += vmst.extent;
+		st->resident += vmst.resident;
+		st->released += vmst.released;
 	}
 
 	st->n_region = Regnum+1;
 	st->n_open = Regopen;
 	st->n_lock = Reglock;
 	st->n_probe = Regprobe;
+	st->n_home = Reghome;
+	st->n_direct = Regdirect;
+	st->n_queue = Regqueue;
 
 	return 0;
 }
@@ -333,7 +367,7 @@ static Vmalloc_t* regionof(Void_t* addr)
 #else
 #define CAUTIOUS	0
 #endif
-	if(CAUTIOUS || Vmregion->meth.meth != VM_MTBEST )
+	if(CAUTIOUS || !(Vmregion->meth.meth&(VM_MTBEST|VM_MTSLAB)) )
 	{	/* addr will not be dereferenced here */
 		if(vmaddr(Vmregion,addr) == 0 )
 			return Vmregion;
@@ -388,7 +422,7 @@ static void clrfreelist()
 		if(vm = regionof((Void_t*)list))
 		{	if(asocasint(&vm->data->lock, 0, 1) == 0) /* can free this now */
 			{	(void)(*vm->meth.freef)(vm, (Void_t*)list, 1);
-				vm->data->lock = 0;
+				REGUNLOCK(vm);
 			}
 			else	addfreelist(list); /* ah well, back in the queue */
 		}
@@ -427,6 +461,15 @@ static Vmalloc_t* getregion(int* local)
 		Vmregion->data->lock = 1;
 		return Vmregion;
 	}
+
+	if(Regnum > 0 && (vm = Region[REGHOME(&vm)%Regnum]) &&
+	   asocasint(&vm->data->lock, 0, 1) == 0 )
+	{	/* home region is open, this keeps threads apart */
+		*local = 1;
+		asoincint(&Regopen);
+		asoincint(&Reghome);
+		return vm;
+	}
 	else if(asocasint(&Vmregion->data->lock, 0, 1) == 0 )
 	{	/* Vmregion is open, so use it */
 		*local = 1;
@@ -461,7 +504,7 @@ static Vmalloc_t* getregion(int* local)
 		}
 
 		/**/ASSERT(Region[p] == NIL(Vmalloc_t*));
-		if((vm = vmopen(&Regdisc.disc, Vmbest, VM_SHARE)) != NIL(Vmalloc_t*) )
+		if((vm = vmopen(&Regdisc.disc, Vmregion->meth.meth == VM_MTSLAB ? Vmslab : Vmbest, VM_SHARE)) != NIL(Vmalloc_t*) )
 		{	vm->data->lock = 1; /* lock new region now */
 			*local = 1;
 			asoincint(&Regopen);
@@ -500,9 +543,9 @@ reg size_t	s_obj;
 	addr = (*vm->meth.resizef)(vm, NIL(Void_t*), n_obj*s_obj, VM_RSZERO, local);
 	if(local)
 	{	/**/ASSERT(vm->data->lock == 1);
-		vm->data->lock = 0;
+		REGUNLOCK(vm);
 	}
-	return VMRECORD(addr);
+	return VMRECORD(VMSAMPLE(addr, n_obj*s_obj));
 }
 
 #if __STD_C
@@ -521,9 +564,9 @@ reg size_t	size;
 	addr = (*vm->meth.allocf)(vm, size, local);
 	if(local)
 	{	/**/ASSERT(vm->data->lock == 1);
-		vm->data->lock = 0;
+		REGUNLOCK(vm);
 	}
-	return VMRECORD(addr);
+	return VMRECORD(VMSAMPLE(addr, size));
 }
 
 #if __STD_C
@@ -542,25 +585,30 @@ reg size_t	size;	/* new size			*/
 	if(!data)
 		return malloc(size);
 	else if((vm = regionof(data)) )
-	{	if(vm == Vmregion && vm != Vmheap) /* no multiple region usage here */
-		{	addr = (*vm->meth.resizef)(vm, data, size, VM_RSCOPY|VM_RSMOVE, 0);
-			return VMRECORD(addr);
+	{	/* data keeps its sample record if the resize fails */
+		if(vm == Vmregion && vm != Vmheap) /* no multiple region usage here */
+		{	if((addr = (*vm->meth.resizef)(vm, data, size, VM_RSCOPY|VM_RSMOVE, 0)) )
+				VMSMPFREE(data);
+			return VMRECORD(VMSAMPLE(addr, size));
 		}
 		if(asocasint(&vm->data->lock, 0, 1) == 0 ) /* region is open */
-		{	addr = (*vm->meth.resizef)(vm, data, size, VM_RSCOPY|VM_RSMOVE, 1);
-			vm->data->lock = 0;
-			return VMRECORD(addr);
+		{	if((addr = (*vm->meth.resizef)(vm, data, size, VM_RSCOPY|VM_RSMOVE, 1)) )
+				VMSMPFREE(data); /* before data can be reused */
+			REGUNLOCK(vm);
+			return VMRECORD(VMSAMPLE(addr, size));
 		}
 		else if(Regmax > 0 && Vmregion == Vmheap && (addr = malloc(size)) )
 		{	if((copy = SIZE(BLOCK(data))&~BITS) > size )
 				copy = size;	
 			memcpy(addr, data, copy);
+			VMSMPFREE(data);
 			addfreelist((Regfree_t*)data);
 			return VMRECORD(addr);
 		}
 		else /* this may block but it is the best that we can do now */
-		{	addr = (*vm->meth.resizef)(vm, data, size, VM_RSCOPY|VM_RSMOVE, 0);
-			return VMRECORD(addr);
+		{	if((addr = (*vm->meth.resizef)(vm, data, size, VM_RSCOPY|VM_RSMOVE, 0)) )
+				VMSMPFREE(data);
+			return VMRECORD(VMSAMPLE(addr, size));
 		}
 	}
 	else /* not our data */
@@ -587,15 +635,32 @@ reg Void_t*	data;
 #endif
 {
 	Vmalloc_t	*vm;
+	int		release;
 	VMFLINIT();
 
 	if(!data || (_Vmassert & VM_keep))
 		return;
 	else if((vm = regionof(data)) )
-	{	
+	{	release = RELEASE(vm, data);
 		if(vm == Vmregion && Vmregion != Vmheap || (_Vmassert & VM_free))
-			(void)(*vm->meth.freef)(vm, data, 0);
-		else	addfreelist((Regfree_t*)data);
+		{	if((*vm->meth.freef)(vm, data, 0) >= 0)
+				VMSMPFREE(data);
+			if(release)
+				(void)(*vm->meth.compactf)(vm, 0);
+		}
+		else if(asocasint(&vm->data->lock, 0, 1) == 0 ) /* region is open */
+		{	if((*vm->meth.freef)(vm, data, 1) >= 0)
+				VMSMPFREE(data); /* before data can be reused */
+			if(release)
+				(void)(*vm->meth.compactf)(vm, 1);
+			REGUNLOCK(vm);
+			asoincint(&Regdirect);
+		}
+		else /* batch return later */
+		{	VMSMPFREE(data);
+			addfreelist((Regfree_t*)data);
+			asoincint(&Regqueue);
+		}
 		return;
 	}
 	else /* not our data */
@@ -641,10 +706,10 @@ reg size_t	size;
 	addr = (*vm->meth.alignf)(vm, size, align, local);
 	if(local)
 	{	/**/ASSERT(vm->data->lock == 1);
-		vm->data->lock = 0;
+		REGUNLOCK(vm);
 	}
 	VMUNBLOCK
-	return VMRECORD(addr);
+	return VMRECORD(VMSAMPLE(addr, size));
 }
 
 #if __STD_C
@@ -1255,6 +1320,15 @@ static void pfprint()
 		vmprofile(Vmregion,_Vmpffd);
 }
 
+#if __STD_C
+static void smprint(void)
+#else
+static void smprint()
+#endif
+{
+	vmsmpdump(_Vmsmpfd,0);
+}
+
 /*
  * initialize runtime options from the VMALLOC_OPTIONS env var
  */
@@ -1273,6 +1347,8 @@ void _vmoptions()
 	char*		t;
 	char*		v;
 	Vmulong_t	n;
+	Vmulong_t	smp = 0;
+	int		secs = 0;
 	int		fd;
 	char		buf[1024];
 
@@ -1324,12 +1400,23 @@ void _vmoptions()
 			case 'c':		/* check */
 				_Vmassert |= VM_check;
 				break;
+			case 'd':		/* dump=<path> */
+				if (v)
+					_Vmsmpfd = createfile(v);
+				break;
 			case 'f':		/* free */
 				_Vmassert |= VM_free;
 				break;
+			case 'i':		/* interval=<seconds> */
+				if (v)
+					secs = (int)atou(&v);
+				break;
 			case 'k':		/* keep */
 				_Vmassert |= VM_keep;
 				break;
+			case 'l':		/* lazy */
+				_Vmassert |= VM_lazy;
+				break;
 			case 'm':
 				if (v)
 					switch (t[1])
@@ -1347,6 +1434,8 @@ void _vmoptions()
 								vm = vmopen(Vmdcsystem, Vmlast, 0);
 							else if (strcmp(v, "best") == 0)
 								vm = Vmheap;
+							else if (strcmp(v, "slab") == 0)
+								vm = vmopen(Vmdcsystem, Vmslab, VM_SHARE);
 						}
 						break;
 					case 'm': /* mmap */
@@ -1372,11 +1461,34 @@ void _vmoptions()
 						break;
 					}
 				break;
-			case 's':		/* start=<count> */
-				if (!vm)
-					vm = vmopen(Vmdcsystem, Vmdebug, 0);
-				if (v && vm && vm->meth.meth == VM_MTDEBUG)
-					_Vmdbstart = atou(&v);
+			case 'r':		/* release[=<size>] */
+				n = v ? atou(&v) : 1;
+				if (!v || *v == 'm' || *v == 'M')
+					n *= 1024*1024;
+				else if (*v == 'k' || *v == 'K')
+					n *= 1024;
+				if (n > 0 && n < 2*VMPAGESIZE)
+					n = 2*VMPAGESIZE;
+				_Vmrelsize = (size_t)n;
+				break;
+			case 's':
+				switch (t[1])
+				{
+				case 'a':	/* sample=<size> */
+					n = v ? atou(&v) : 512;
+					if (!v || *v == 'k' || *v == 'K')
+						n *= 1024;
+					else if (*v == 'm' || *v == 'M')
+						n *= 1024*1024;
+					smp = n;
+					break;
+				case 't':	/* start=<count> */
+					if (!vm)
+						vm = vmopen(Vmdcsystem, Vmdebug, 0);
+					if (v && vm && vm->meth.meth == VM_MTDEBUG)
+						_Vmdbstart = atou(&v);
+					break;
+				}
 				break;
 			case 't':		/* trace=<path> */
 				trace = v;
@@ -1423,7 +1535,7 @@ void _vmoptions()
 			vmtrace(fd);
 		}
 	}
-	else if (Vmregion != Vmheap || asometh(0, 0)->type == ASO_SIGNAL)
+	else if (Vmregion != Vmheap && Vmregion->meth.meth != VM_MTSLAB || asometh(0, 0)->type == ASO_SIGNAL)
 		setregmax(0);
 
 	/* make sure that profile data is output upon exiting */
@@ -1440,6 +1552,23 @@ void _vmoptions()
 		close(_Vmpffd);
 		_Vmpffd = -1;
 	}
+
+	/* start heap sampling and output the profile upon exiting */
+
+	if (smp > 0)
+	{
+		if (_Vmsmpfd < 0)
+			_Vmsmpfd = 2;
+		if (secs > 0)
+			vmsmpdump(_Vmsmpfd, secs);
+		vmsample((ssize_t)smp);
+		atexit(smprint);
+	}
+	else if (_Vmsmpfd >= 0)
+	{
+		close(_Vmsmpfd);
+		_Vmsmpfd = -1;
+	}
 }
 
 /*
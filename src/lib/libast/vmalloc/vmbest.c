@@ -518,6 +518,28 @@ int		c;
 	return saw_wanted;
 }
 
+/* release the pages of large free blocks in the tree rooted at node */
+#if __STD_C
+static void bestrelease(Vmalloc_t* vm, Block_t* node)
+#else
+static void bestrelease(vm, node)
+Vmalloc_t*	vm;
+Block_t*	node;
+#endif
+{
+	reg Block_t	*bp;
+
+	for(; node; node = RIGHT(node))
+	{	if(SIZE(node) < _Vmrelsize) /* and so is everything on the left */
+			continue;
+		if(LEFT(node))
+			bestrelease(vm, LEFT(node));
+		for(bp = node; bp; bp = LINK(bp)) /* keep tree links and SELF */
+			(void)(*_Vmrelease)(vm, (Vmuchar_t*)DATA(bp)+BODYSIZE,
+					    SIZE(bp)-BODYSIZE-sizeof(Block_t*));
+	}
+}
+
 #if __STD_C
 static int bestcompact(Vmalloc_t* vm, int local)
 #else
@@ -594,6 +616,14 @@ int		local;
 		}
 	}
 
+	/* give back the pages of large free blocks still in the region */
+	if(_Vmrelsize > 0 && VMETHOD(vd) == VM_MTBEST)
+	{	if((bp = vd->wild) && SIZE(bp) >= _Vmrelsize)
+			(void)(*_Vmrelease)(vm, (Vmuchar_t*)DATA(bp)+BODYSIZE,
+					    SIZE(bp)-BODYSIZE-sizeof(Block_t*));
+		bestrelease(vm, vd->root);
+	}
+
 	if(!local && _Vmtrace && (vd->mode&VM_TRACE) && VMETHOD(vd) == VM_MTBEST)
 		(*_Vmtrace)(vm, (Vmuchar_t*)0, (Vmuchar_t*)0, 0, 0);
 
@@ -1170,6 +1200,8 @@ static Void_t* win32mem(Void_t* caddr, size_t csize, size_t nsize)
 #endif /* _mem_win32 */
 
 #if _mem_sbrk /* getting space via brk/sbrk - not concurrent-ready */
+static Vmuchar_t*	Brkaddr;	/* lowest address from sbrkmem()	*/
+
 static Void_t* sbrkmem(Void_t* caddr, size_t csize, size_t nsize)
 {
 	Vmuchar_t	*addr = (Vmuchar_t*)sbrk(0);
@@ -1180,7 +1212,10 @@ static Void_t* sbrkmem(Void_t* caddr, size_t csize, size_t nsize)
 	if(csize > 0 && addr != (Vmuchar_t*)caddr+csize)
 		return NIL(Void_t*);
 	else if(csize == 0)
-		caddr = addr;
+	{	caddr = addr;
+		if(!Brkaddr || addr < Brkaddr)
+			Brkaddr = addr;
+	}
 
 	/**/ASSERT(addr == (Vmuchar_t*)caddr+csize);
 	if(nsize < csize)
@@ -1216,6 +1251,10 @@ static Void_t* sbrkmem(Void_t* caddr, size_t csize, size_t nsize)
 #define FD_INIT		(-1)		/* uninitialized file desc	*/
 #define FD_NONE		(-2)		/* no mapping with file desc	*/
 
+#if _std_malloc
+static int		Mallocmem;	/* mallocmem() has been used	*/
+#endif
+
 typedef struct _mmdisc_s
 {	Vmdisc_t	disc;
 	int		fd;
@@ -1264,16 +1303,23 @@ static Void_t* mmapmem(Void_t* caddr, size_t csize, size_t nsize, Mmdisc_t* mmdc
 			return caddr;
 		}
 	}
-	else if(nsize == 0)
-	{	Vmuchar_t	*addr = (Vmuchar_t*)sbrk(0);
-		if(addr < (Vmuchar_t*)caddr ) /* in sbrk space */
-			return NIL(Void_t*);
-		else
-		{	(void)munmap(caddr, csize);
-			return caddr;
-		}
-	}
-	else	return NIL(Void_t*);
+
+	/* releasing all or the tail of a segment */
+	if(nsize >= csize)
+		return NIL(Void_t*);
+#if _mem_sbrk
+	if(Brkaddr && (Vmuchar_t*)caddr >= Brkaddr &&
+	   (Vmuchar_t*)caddr < (Vmuchar_t*)sbrk(0) ) /* in sbrk space */
+		return NIL(Void_t*);
+#endif
+#if _std_malloc
+	if(Mallocmem) /* might be native malloc space */
+		return NIL(Void_t*);
+#endif
+	if(nsize%_Vmpagesize != 0 ||
+	   munmap((Vmuchar_t*)caddr+nsize, csize-nsize) < 0 )
+		return NIL(Void_t*);
+	return caddr;
 }
 #endif /* _mem_map_anon || _mem_mmap_zero */
 
@@ -1282,7 +1328,9 @@ static Void_t* mallocmem(Void_t* caddr, size_t csize, size_t nsize)
 {
 	/**/ASSERT(csize > 0 || nsize > 0);
 	if(csize == 0)
+	{	Mallocmem = 1;
 		return (Void_t*)malloc(nsize);
+	}
 	else if(nsize == 0)
 	{	free(caddr);
 		return caddr;
@@ -55,6 +55,12 @@ Vmalloc_t*	vm;
 		for(s = 0; s <= S_CACHE; ++s)
 			CACHE(vd)[s] = NIL(Block_t*);
 	}
+	if(vd->mode&VM_MTSLAB)
+	{	for(s = 0; s < S_SLAB; ++s)
+			SLAB(vd)[s] = NIL(Slab_t*);
+		for(s = 0; s < S_RUNS; ++s)
+			RUNS(vd)[s] = NIL(Slab_t*);
+	}
 
 	for(seg = vd->seg; seg; seg = next)
 	{	next = seg->next;
@@ -64,7 +70,7 @@ Vmalloc_t*	vm;
 
 		SEG(tp) = seg;
 		SIZE(tp) = size;
-		if((vd->mode&(VM_MTLAST|VM_MTPOOL)) )
+		if((vd->mode&(VM_MTLAST|VM_MTPOOL|VM_MTSLAB)) )
 			seg->free = tp;
 		else
 		{	SIZE(tp) |= BUSY|JUNK;
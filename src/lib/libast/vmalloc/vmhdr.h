@@ -98,6 +98,7 @@ typedef union _head_u	Head_t;
 typedef union _body_u	Body_t;
 typedef struct _block_s	Block_t;
 typedef struct _seg_s	Seg_t;
+typedef struct _slab_s	Slab_t;
 typedef struct _pfobj_s	Pfobj_t;
 
 #define NIL(t)		((t)0)
@@ -126,6 +127,7 @@ typedef struct _pfobj_s	Pfobj_t;
 #define VM_free		0x0008	/* disable addfreelist()		*/
 #define VM_keep		0x0010	/* disable free()			*/
 #define VM_mmap		0x0020	/* try mmap() block allocator first	*/
+#define VM_lazy		0x0040	/* release pages with MADV_FREE		*/
 
 #if _UWIN
 #include <ast_windows.h>
@@ -302,6 +304,12 @@ struct _tiny_s
 #define TINY(vd)	((vd)->tiny)
 #define CACHE(vd)	((vd)->cache)
 
+/* Vmslab size classes and free run lists, see vmslab.c */
+#define S_SLAB		28	/* # of size classes of small blocks		*/
+#define S_RUNS		72	/* # of lists of free runs			*/
+#define SLAB(vd)	((vd)->slab)
+#define RUNS(vd)	((vd)->runs)
+
 struct _vmdata_s /* core region data - could be in shared/persistent memory	*/
 {	unsigned int	lock;		/* lock status				*/
 	int		mode;		/* current mode for region		*/
@@ -313,6 +321,9 @@ struct _vmdata_s /* core region data - could be in shared/persistent memory	*/
 	Block_t*	root;		/* root of free tree			*/
 	Block_t*	tiny[S_TINY];	/* small blocks				*/
 	Block_t*	cache[S_CACHE+1]; /* delayed free blocks		*/
+	Slab_t*		slab[S_SLAB];	/* Vmslab slabs with free blocks	*/
+	Slab_t*		runs[S_RUNS];	/* Vmslab free runs			*/
+	size_t		released;	/* space released to the system		*/
 };
 
 #include	"vmalloc.h"
@@ -336,6 +347,33 @@ struct _seg_s
 	Block_t*	last;	/* Vmlast last-allocated block	*/
 };
 
+/* A Vmslab segment is carved into runs, each headed by a Slab_t.
+** A run is either a slab of blocks of one size class, a single large
+** block or free. Busy blocks have SEG(b) pointing to their Slab_t,
+** whose first field matches Seg_t so that vmregion() still works.
+*/
+struct _slab_s
+{	Vmdata_t*	vmdt;	/* the data region holding this	*/
+	Seg_t*		seg;	/* segment containing the run	*/
+	Slab_t*		next;	/* next in class or run list	*/
+	Slab_t*		prev;	/* previous in list		*/
+	size_t		extent;	/* extent of this run		*/
+	Vmuchar_t*	data;	/* first block in run		*/
+	Block_t*	free;	/* list of free blocks		*/
+	size_t		size;	/* block size including head	*/
+	int		kind;	/* class, SL_LARGE or SL_FREE	*/
+	int		pfree;	/* preceding run is free	*/
+	int		nblk;	/* number of blocks		*/
+	int		busy;	/* number of busy blocks	*/
+	int		mark;	/* blocks carved so far		*/
+	unsigned int	bits[1]; /* bitmap of busy blocks	*/
+};
+#define SL_LARGE	(-1)	/* run holds a single large block	*/
+#define SL_FREE		(-2)	/* run is free				*/
+#define SLISBUSY(sl,i)	((sl)->bits[(i)>>5] & (1U<<((i)&037)))
+#define SLNEXT(sl)	((Slab_t*)((Vmuchar_t*)(sl) + (sl)->extent))
+#define SLISRUN(seg,sl)	((Block_t*)(sl) != (seg)->free && (Block_t*)(sl) < BLOCK((seg)->baddr))
+
 /* starting block of a segment */
 #define SEGBLOCK(s)	((Block_t*)(((Vmuchar_t*)(s)) + ROUND(sizeof(Seg_t),ALIGN)))
 
@@ -448,7 +486,9 @@ typedef Block_t*	(*Vmsearch_f)_ARG_((Vmdata_t*, size_t, Block_t*));
 typedef struct _vmextern_s
 {	Block_t*	(*vm_extend)_ARG_((Vmalloc_t*, size_t, Vmsearch_f ));
 	ssize_t		(*vm_truncate)_ARG_((Vmalloc_t*, Seg_t*, size_t, int));
+	ssize_t		(*vm_release)_ARG_((Vmalloc_t*, Void_t*, size_t));
 	size_t		vm_pagesize;
+	size_t		vm_relsize;
 	char*		(*vm_strcpy)_ARG_((char*, const char*, int));
 	char*		(*vm_itoa)_ARG_((Vmulong_t, int));
 	void		(*vm_trace)_ARG_((Vmalloc_t*,
@@ -457,11 +497,15 @@ typedef struct _vmextern_s
 	unsigned int	vm_lock;
 	int		vm_assert;
 	int		vm_options;
+	ssize_t		vm_smpleft;
+	size_t		vm_smpbusy;
 } Vmextern_t;
 
 #define _Vmextend	(_Vmextern.vm_extend)
 #define _Vmtruncate	(_Vmextern.vm_truncate)
+#define _Vmrelease	(_Vmextern.vm_release)
 #define _Vmpagesize	(_Vmextern.vm_pagesize)
+#define _Vmrelsize	(_Vmextern.vm_relsize)
 #define _Vmstrcpy	(_Vmextern.vm_strcpy)
 #define _Vmitoa		(_Vmextern.vm_itoa)
 #define _Vmtrace	(_Vmextern.vm_trace)
@@ -469,6 +513,13 @@ typedef struct _vmextern_s
 #define _Vmlock		(_Vmextern.vm_lock)
 #define _Vmassert	(_Vmextern.vm_assert)
 #define _Vmoptions	(_Vmextern.vm_options)
+#define _Vmsmpleft	(_Vmextern.vm_smpleft)	/* bytes to next sample	*/
+#define _Vmsmpbusy	(_Vmextern.vm_smpbusy)	/* sampled busy blocks	*/
+
+/* malloc() heap sampling, see vmsample.c */
+#define VMSAMPLE(d,s)	(_Vmsmpleft > 0 && (d) && (_Vmsmpleft -= (ssize_t)(s)) <= 0 ? \
+				_vmsample((Void_t*)(d),(size_t)(s)) : (Void_t*)(d) )
+#define VMSMPFREE(d)	(_Vmsmpbusy > 0 ? _vmsmpfree((Void_t*)(d)) : 0 )
 
 #define VMOPTIONS()     do { if (!_Vmoptions) { _vmoptions(); } } while (0)
 
@@ -476,6 +527,8 @@ extern int		_vmbestcheck _ARG_((Vmdata_t*, Block_t*));
 extern int		_vmfd _ARG_((int));
 extern int		_vmlock _ARG_((Vmalloc_t*, int));
 extern void		_vmoptions _ARG_((void));
+extern Void_t*		_vmsample _ARG_((Void_t*, size_t));
+extern int		_vmsmpfree _ARG_((Void_t*));
 
 _BEGIN_EXTERNS_
 
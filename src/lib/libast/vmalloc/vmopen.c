@@ -151,7 +151,7 @@ int		mode;	/* type of region		*/
 	SEG(np) = seg;
 	SIZE(np) = BUSY|PFREE;
 
-	if(vd->mode&(VM_MTLAST|VM_MTPOOL))
+	if(vd->mode&(VM_MTLAST|VM_MTPOOL|VM_MTSLAB))
 		seg->free = bp;
 	else	vd->wild = bp;
 
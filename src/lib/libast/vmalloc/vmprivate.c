@@ -27,6 +27,10 @@ void _STUB_vmprivate(){}
 
 #include	"vmhdr.h"
 
+#if _lib_madvise
+#include	<sys/mman.h>
+#endif
+
 static char*	Version = "\n@(#)$Id: Vmalloc (AT&T Labs - Research) 2011-08-08 $\0\n";
 
 
@@ -254,6 +258,47 @@ int		exact;
 	}
 }
 
+/* Give the whole pages inside a free area back to the system.
+** The addresses stay valid and read as zeros or old data when reused.
+** Only memory from Vmdcsystem is privately mapped for sure so other
+** disciplines are left alone.
+*/
+#if __STD_C
+static ssize_t _vmrelease(Vmalloc_t* vm, Void_t* addr, size_t size)
+#else
+static ssize_t _vmrelease(vm, addr, size)
+Vmalloc_t*	vm;	/* containing region		*/
+Void_t*		addr;	/* start of free area		*/
+size_t		size;	/* size of free area		*/
+#endif
+{
+#if _lib_madvise && defined(MADV_DONTNEED)
+	reg Vmulong_t	begp, endp;
+
+	if(vm->disc->memoryf != Vmdcsystem->memoryf)
+		return 0;
+
+	GETPAGESIZE(_Vmpagesize);
+	begp = ROUND(VLONG(addr), _Vmpagesize);
+	endp = ((VLONG(addr) + size) / _Vmpagesize) * _Vmpagesize;
+	if(endp <= begp)
+		return 0;
+
+	if(
+#ifdef MADV_FREE /* lazy release, fall back on kernels without it */
+	   ((_Vmassert & VM_lazy) && madvise((Void_t*)begp, endp-begp, MADV_FREE) == 0) ||
+#endif
+	   madvise((Void_t*)begp, endp-begp, MADV_DONTNEED) == 0 )
+	{	vm->data->released += endp-begp;
+		return endp-begp;
+	}
+	else	return 0;
+#else
+	NOTUSED(vm); NOTUSED(addr); NOTUSED(size);
+	return 0;
+#endif
+}
+
 int _vmlock(Vmalloc_t* vm, int locking)
 {
 	if(!vm) /* some sort of global locking */
@@ -279,7 +324,9 @@ int _vmlock(Vmalloc_t* vm, int locking)
 Vmextern_t	_Vmextern =
 {	_vmextend,						/* _Vmextend	*/
 	_vmtruncate,						/* _Vmtruncate	*/
+	_vmrelease,						/* _Vmrelease	*/
 	0,							/* _Vmpagesize	*/
+	0,							/* _Vmrelsize	*/
 	NIL(char*(*)_ARG_((char*,const char*,int))),		/* _Vmstrcpy	*/
 	NIL(char*(*)_ARG_((Vmulong_t,int))),			/* _Vmitoa	*/
 	NIL(void(*)_ARG_((Vmalloc_t*,
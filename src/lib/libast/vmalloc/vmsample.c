@@ -0,0 +1,395 @@
+/***********************************************************************
+*                                                                      *
+*               This software is part of the ast package               *
+*          Copyright (c) 1985-2012 AT&T Intellectual Property          *
+*                      and is licensed under the                       *
+*                 Eclipse Public License, Version 1.0                  *
+*                    by AT&T Intellectual Property                     *
+*                                                                      *
+*                A copy of the License is available at                 *
+*          http://www.eclipse.org/org/documents/epl-v10.html           *
+*         (with md5 checksum b35adb5213ca9657e911e9befb180842)         *
+*                                                                      *
+*              Information and Software Systems Research               *
+*                            AT&T Research                             *
+*                           Florham Park NJ                            *
+*                                                                      *
+*                 Glenn Fowler <gsf@research.att.com>                  *
+*                  David Korn <dgk@research.att.com>                   *
+*                   Phong Vo <kpv@research.att.com>                    *
+*                                                                      *
+***********************************************************************/
+#if defined(_UWIN) && defined(_BLD_ast)
+
+void _STUB_vmsample(){}
+
+#else
+
+#include	"vmhdr.h"
+
+/*	Sampling heap profiler for the malloc() interface.
+**	About one allocation per period bytes allocated is sampled: its
+**	call stack is recorded and accumulated by stack, and the sampled
+**	block is remembered by address until it is freed. The cost of
+**	unsampled calls is a counter decrement in malloc() and a test of
+**	_Vmsmpbusy in free().
+**	The profile is written in the text heap profile format understood
+**	by pprof: a header line, one line per call stack, then the process
+**	memory map for symbolization. The counts are not scaled; pprof
+**	unsamples them using the heap_v2/period in the header.
+*/
+
+#if _hdr_execinfo && _lib_backtrace
+#include	<execinfo.h>
+#endif
+#include	<fcntl.h>
+#include	<time.h>
+
+#define SMPDEPTH	32	/* max call stack depth recorded	*/
+#define SMPSKIP		1	/* skip _vmsample() in the stack	*/
+#define SMPSTACK	1021	/* call stack hash table size		*/
+#define SMPADDR		1024	/* initial address table size		*/
+#define SMPBITS		(1<<16)	/* bits to filter free() addresses	*/
+
+typedef struct _smpstk_s	Smpstk_t;
+struct _smpstk_s
+{	Smpstk_t*	next;	/* next in hash chain			*/
+	Vmulong_t	hash;	/* hash of the call stack		*/
+	Vmulong_t	n_busy;	/* sampled blocks still busy		*/
+	Vmulong_t	s_busy;	/* and their total size			*/
+	Vmulong_t	n_alloc;/* all sampled blocks			*/
+	Vmulong_t	s_alloc;/* and their total size			*/
+	int		depth;	/* number of frames in pc[]		*/
+	Void_t*		pc[1];	/* the call stack, innermost first	*/
+};
+
+typedef struct _smpaddr_s
+{	Void_t*		addr;	/* a sampled busy block			*/
+	size_t		size;	/* its requested size			*/
+	Smpstk_t*	stk;	/* the call stack that allocated it	*/
+} Smpaddr_t;
+
+static Vmalloc_t*	Vmsmp;		/* region for our own data	*/
+static Smpstk_t*	Smpstk[SMPSTACK];/* call stacks by hash		*/
+static Smpaddr_t*	Smpaddr;	/* sampled blocks by address	*/
+static size_t		Smpasize;	/* size of Smpaddr, a power of 2 */
+static ssize_t		Smpperiod;	/* mean bytes between samples	*/
+static unsigned int	Smplock;	/* lock for all of the above	*/
+static Vmulong_t	Smprand = 0x2545F491;	/* random number state	*/
+static int		Smpfd = -1;	/* rewrite the profile here	*/
+static int		Smpsecs;	/* every this many seconds	*/
+static time_t		Smptime;	/* time of the next rewrite	*/
+static unsigned char	Smpbits[SMPBITS/8]; /* may be sampled	*/
+
+#define SMPHASH(a)	((((Vmulong_t)(a)) >> 4) * 0x9E3779B1)
+#define SMPBIT(a)	((SMPHASH(a) >> 12) & (SMPBITS-1))
+
+/* Bytes to the next sample. Sampling at exponentially distributed
+** intervals makes each byte equally likely to be sampled, which is
+** what pprof assumes when it unsamples the counts.
+*/
+#if __STD_C
+static ssize_t smpnext(void)
+#else
+static ssize_t smpnext()
+#endif
+{
+	double		u, t, t2, ln;
+	int		k;
+
+	/* xorshift to a uniform u in (0,1] */
+	Smprand ^= Smprand << 13;
+	Smprand ^= Smprand >> 17;
+	Smprand ^= Smprand << 5;
+	u = ((double)((Smprand & 0xffffff) + 1)) / (double)0x1000000;
+
+	/* ln(u) = k*ln(2) + ln(x) with x in [1,2), the last by series */
+	for(k = 0; u < 1.; ++k)
+		u *= 2.;
+	t = (u - 1.)/(u + 1.);
+	t2 = t*t;
+	ln = 2.*t*(1. + t2*(1./3. + t2*(1./5. + t2*(1./7. + t2/9.)))) - k*0.69314718055994531;
+
+	if((t = -ln * (double)Smpperiod) < 1.)
+		t = 1.;
+	return (ssize_t)t;
+}
+
+#if __STD_C
+static Smpaddr_t* smpfind(Void_t* addr)
+#else
+static Smpaddr_t* smpfind(addr)
+Void_t*		addr;
+#endif
+{
+	reg Smpaddr_t	*sa;
+	reg size_t	mask = Smpasize-1;
+	reg size_t	h;
+
+	for(h = SMPHASH(addr) & mask;; h = (h+1) & mask)
+		if((sa = &Smpaddr[h])->addr == addr || !sa->addr)
+			return sa;
+}
+
+#if __STD_C
+static int smpgrow(void)
+#else
+static int smpgrow()
+#endif
+{
+	reg Smpaddr_t	*old, *sa, *endsa;
+	reg size_t	oldsize, h;
+
+	old = Smpaddr;
+	oldsize = Smpasize;
+	Smpasize = oldsize ? 2*oldsize : SMPADDR;
+	if(!(Smpaddr = (Smpaddr_t*)vmalloc(Vmsmp, Smpasize*sizeof(Smpaddr_t))) )
+	{	Smpaddr = old;
+		Smpasize = oldsize;
+		return -1;
+	}
+	memset(Smpaddr, 0, Smpasize*sizeof(Smpaddr_t));
+	memset(Smpbits, 0, sizeof(Smpbits)); /* drop the stale bits */
+
+	for(endsa = (sa = old) + oldsize; sa < endsa; ++sa)
+		if(sa->addr)
+		{	*smpfind(sa->addr) = *sa;
+			h = SMPBIT(sa->addr);
+			Smpbits[h>>3] |= 1 << (h&7);
+		}
+	if(old)
+		vmfree(Vmsmp, old);
+	return 0;
+}
+
+/* record a sampled block; called by VMSAMPLE() when _Vmsmpleft runs out */
+#if __STD_C
+Void_t* _vmsample(Void_t* addr, size_t size)
+#else
+Void_t* _vmsample(addr, size)
+Void_t*		addr;
+size_t		size;
+#endif
+{
+	reg Smpstk_t	*stk;
+	reg Smpaddr_t	*sa;
+	reg Vmulong_t	h;
+	reg int		n, depth;
+	Void_t*		pc[SMPDEPTH+SMPSKIP];
+
+	if(asocasint(&Smplock, 0, 1) != 0)
+		return addr; /* another thread, or malloc() from backtrace() */
+
+	if(Smpperiod <= 0)
+	{	_Vmsmpleft = 0;
+		goto done;
+	}
+	_Vmsmpleft = smpnext();
+	if(!Vmsmp && !(Vmsmp = vmopen(Vmdcsystem, Vmbest, 0)) )
+		goto done;
+
+#if _hdr_execinfo && _lib_backtrace
+	depth = backtrace(pc, SMPDEPTH+SMPSKIP) - SMPSKIP;
+#else
+#if __GNUC__
+	pc[SMPSKIP] = __builtin_return_address(0);
+	depth = 1;
+#else
+	depth = 0;
+#endif
+#endif
+	if(depth < 0)
+		depth = 0;
+
+	for(h = depth, n = 0; n < depth; ++n)
+		h = (h << 7) + (h >> 25) + SMPHASH(pc[n+SMPSKIP]);
+	for(stk = Smpstk[h%SMPSTACK]; stk; stk = stk->next)
+		if(stk->hash == h && stk->depth == depth &&
+		   memcmp(stk->pc, pc+SMPSKIP, depth*sizeof(Void_t*)) == 0 )
+			break;
+	if(!stk)
+	{	n = sizeof(Smpstk_t) + (depth > 0 ? depth-1 : 0)*sizeof(Void_t*);
+		if(!(stk = (Smpstk_t*)vmalloc(Vmsmp, n)) )
+			goto done;
+		memset(stk, 0, n);
+		stk->hash = h;
+		stk->depth = depth;
+		memcpy(stk->pc, pc+SMPSKIP, depth*sizeof(Void_t*));
+		stk->next = Smpstk[h%SMPSTACK];
+		Smpstk[h%SMPSTACK] = stk;
+	}
+	stk->n_alloc += 1;
+	stk->s_alloc += size;
+
+	if(2*(_Vmsmpbusy+1) > Smpasize && smpgrow() < 0)
+		goto done;
+	if((sa = smpfind(addr))->addr) /* a free() was missed */
+	{	sa->stk->n_busy -= 1;
+		sa->stk->s_busy -= sa->size;
+	}
+	else	_Vmsmpbusy += 1;
+	sa->addr = addr;
+	sa->size = size;
+	sa->stk = stk;
+	h = SMPBIT(addr);
+	Smpbits[h>>3] |= 1 << (h&7);
+	stk->n_busy += 1;
+	stk->s_busy += size;
+
+	if(Smpsecs > 0 && time(NIL(time_t*)) >= Smptime)
+	{	Smplock = 0;
+		if(lseek(Smpfd, (off_t)0, SEEK_SET) == 0) /* a file, not a pipe */
+			ftruncate(Smpfd, (off_t)0);
+		vmsmpdump(Smpfd, 0);
+		Smptime = time(NIL(time_t*)) + Smpsecs;
+		return addr;
+	}
+
+done:	Smplock = 0;
+	return addr;
+}
+
+/* forget a sampled block; called by VMSMPFREE() once it is freed or moved */
+#if __STD_C
+int _vmsmpfree(Void_t* addr)
+#else
+int _vmsmpfree(addr)
+Void_t*		addr;
+#endif
+{
+	reg Smpaddr_t	*sa, *hole;
+	reg size_t	mask, h;
+
+	/* most blocks were never sampled */
+	h = SMPBIT(addr);
+	if(!(Smpbits[h>>3] & (1 << (h&7))) || asocasint(&Smplock, 0, 1) != 0)
+		return 0;
+
+	if(Smpaddr && (sa = smpfind(addr))->addr)
+	{	sa->stk->n_busy -= 1;
+		sa->stk->s_busy -= sa->size;
+		_Vmsmpbusy -= 1;
+
+		/* close the hole so that later probes still get through */
+		mask = Smpasize-1;
+		for(hole = sa, h = (sa-Smpaddr+1) & mask; (sa = &Smpaddr[h])->addr; h = (h+1) & mask)
+		{	size_t	home = SMPHASH(sa->addr) & mask;
+			size_t	d = (hole - Smpaddr);
+			if(((h - home) & mask) >= ((h - d) & mask))
+			{	*hole = *sa;
+				hole = sa;
+			}
+		}
+		hole->addr = NIL(Void_t*);
+	}
+
+	Smplock = 0;
+	return 0;
+}
+
+/* set the mean number of bytes allocated between samples, 0 to stop */
+#if __STD_C
+ssize_t vmsample(ssize_t period)
+#else
+ssize_t vmsample(period)
+ssize_t		period;
+#endif
+{
+	ssize_t		old = Smpperiod;
+
+	if(period < 0)
+		return old;
+	Smpperiod = period;
+	_Vmsmpleft = period > 0 ? smpnext() : 0;
+	return old;
+}
+
+/* write the sampled heap profile to fd now, or every secs seconds if secs > 0 */
+#if __STD_C
+int vmsmpdump(int fd, int secs)
+#else
+int vmsmpdump(fd, secs)
+int	fd;
+int	secs;
+#endif
+{
+	reg Smpstk_t	*stk;
+	reg int		n, k;
+	Vmulong_t	n_busy, s_busy, n_alloc, s_alloc;
+	char		buf[1024], *bufp, *endbuf;
+
+	if(fd < 0)
+		return -1;
+	if(secs > 0)
+	{	Smpfd = fd;
+		Smpsecs = secs;
+		Smptime = time(NIL(time_t*)) + secs;
+		return 0;
+	}
+
+	/* initialize functions from vmtrace.c that we use below */
+	if((n = vmtrace(-1)) >= 0)
+		vmtrace(n);
+
+	for(k = 0;; ASOLOOP(k))
+		if(asocasint(&Smplock, 0, 1) == 0)
+			break;
+
+	n_busy = s_busy = n_alloc = s_alloc = 0;
+	for(n = 0; n < SMPSTACK; ++n)
+		for(stk = Smpstk[n]; stk; stk = stk->next)
+		{	n_busy += stk->n_busy;
+			s_busy += stk->s_busy;
+			n_alloc += stk->n_alloc;
+			s_alloc += stk->s_alloc;
+		}
+
+#define SMPCOUNTS(b,nb,sb,na,sa) \
+	(b = (*_Vmstrcpy)(b, (*_Vmitoa)(nb,1), ':'), *b++ = ' ', \
+	 b = (*_Vmstrcpy)(b, (*_Vmitoa)(sb,1), ' '), *b++ = '[', \
+	 b = (*_Vmstrcpy)(b, (*_Vmitoa)(na,1), ':'), *b++ = ' ', \
+	 b = (*_Vmstrcpy)(b, (*_Vmitoa)(sa,1), ']'), *b++ = ' ', *b++ = '@' )
+
+	bufp = buf;
+	endbuf = buf + sizeof(buf) - 64;
+	bufp = (*_Vmstrcpy)(bufp, "heap profile:", ' ');
+	SMPCOUNTS(bufp, n_busy, s_busy, n_alloc, s_alloc);
+	bufp = (*_Vmstrcpy)(bufp, " heap_v2/", 0);
+	bufp = (*_Vmstrcpy)(bufp, (*_Vmitoa)((Vmulong_t)Smpperiod,1), '\n');
+
+	for(n = 0; n < SMPSTACK; ++n)
+		for(stk = Smpstk[n]; stk; stk = stk->next)
+		{	if(stk->n_alloc == 0)
+				continue;
+			SMPCOUNTS(bufp, stk->n_busy, stk->s_busy, stk->n_alloc, stk->s_alloc);
+			for(k = 0; k < stk->depth; ++k)
+			{	if(bufp >= endbuf)
+				{	write(fd, buf, bufp-buf);
+					bufp = buf;
+				}
+				bufp = (*_Vmstrcpy)(bufp, " 0x", 0);
+				bufp = (*_Vmstrcpy)(bufp, (*_Vmitoa)(VLONG(stk->pc[k]),0), 0);
+			}
+			*bufp++ = '\n';
+			write(fd, buf, bufp-buf);
+			bufp = buf;
+		}
+
+	Smplock = 0;
+
+	/* the memory map lets pprof symbolize the addresses */
+	if((k = open("/proc/self/maps", O_RDONLY)) >= 0)
+	{	write(fd, "\nMAPPED_LIBRARIES:\n", 19);
+		while((n = read(k, buf, sizeof(buf))) > 0)
+			write(fd, buf, n);
+		close(k);
+	}
+
+	return 0;
+}
+
+#ifdef NoF
+NoF(vmsample)
+#endif
+
+#endif
@@ -0,0 +1,752 @@
+/***********************************************************************
+*                                                                      *
+*               This software is part of the ast package               *
+*          Copyright (c) 1985-2012 AT&T Intellectual Property          *
+*                      and is licensed under the                       *
+*                 Eclipse Public License, Version 1.0                  *
+*                    by AT&T Intellectual Property                     *
+*                                                                      *
+*                A copy of the License is available at                 *
+*          http://www.eclipse.org/org/documents/epl-v10.html           *
+*         (with md5 checksum b35adb5213ca9657e911e9befb180842)         *
+*                                                                      *
+*              Information and Software Systems Research               *
+*                            AT&T Research                             *
+*                           Florham Park NJ                            *
+*                                                                      *
+*                 Glenn Fowler <gsf@research.att.com>                  *
+*                  David Korn <dgk@research.att.com>                   *
+*                   Phong Vo <kpv@research.att.com>                    *
+*                                                                      *
+***********************************************************************/
+#if defined(_UWIN) && defined(_BLD_ast)
+
+void _STUB_vmslab(){}
+
+#else
+
+#include	"vmhdr.h"
+
+/*	Segregated-fit allocation with size-class slabs.
+**	Requests up to MAXSLAB bytes are rounded to one of S_SLAB size
+**	classes and served from slabs, runs of equal-size blocks with a
+**	bitmap of busy blocks. Each class keeps a list of slabs with free
+**	blocks so both allocation and freeing are constant time.
+**	Larger requests get a run of their own. Free runs are coalesced
+**	with their neighbors and kept in S_RUNS lists by extent, or merged
+**	back into the free tail of their segment.
+**	The following fields of Vmdata_t are used as:
+**		slab:	slabs with free blocks, by size class.
+**		runs:	free runs, by extent.
+**	and in each segment, free is the unused tail.
+*/
+
+#define SLABSIZE	(16*1024)	/* minimum extent of a slab	*/
+#define SLABBLKS	8		/* minimum # of blocks in slab	*/
+#define MAXSLAB		2048		/* largest size served by slabs	*/
+#define SLABSEG		(16*SLABSIZE)	/* minimum region extension	*/
+#define R_UNIT		ROUND(256,ALIGN) /* granularity of run extents	*/
+#define R_EXACT		64		/* runs lists of exact extents	*/
+
+#define SLHEAD		ROUND(sizeof(Slab_t),ALIGN)
+#define RUNSELF(r)	(((Slab_t**)SLNEXT(r))[-1])
+#define RUNPREV(r)	(((Slab_t**)(r))[-1])
+
+/* size class of a request of s bytes, 0 < s <= MAXSLAB */
+#if __STD_C
+static int slabclass(size_t s)
+#else
+static int slabclass(s)
+size_t	s;
+#endif
+{
+	size_t	b;
+	int	c;
+
+	if(s <= 256)
+		return (int)((s-1) >> 4);
+	for(c = 16, b = 256; s > 2*b; b *= 2)
+		c += 4;
+	return c + (int)((s-b-1) / (b/4));
+}
+
+/* the block capacity of a size class */
+#if __STD_C
+static size_t slabcap(int c)
+#else
+static size_t slabcap(c)
+int	c;
+#endif
+{
+	size_t	b;
+
+	if(c < 16)
+		return ROUND((c+1)*16, ALIGN);
+	b = ((size_t)256) << ((c-16)/4);
+	return ROUND(b + ((c-16)%4 + 1)*(b/4), ALIGN);
+}
+
+/* the free run list holding runs of extent e */
+#if __STD_C
+static int runindex(size_t e)
+#else
+static int runindex(e)
+size_t	e;
+#endif
+{
+	int	i;
+
+	if((e /= R_UNIT) < R_EXACT)
+		return (int)e - 1;
+	for(i = R_EXACT-1, e /= R_EXACT; e > 1 && i < S_RUNS-1; e >>= 1)
+		i += 1;
+	return i;
+}
+
+#if __STD_C
+static void runlink(Vmdata_t* vd, Slab_t* r)
+#else
+static void runlink(vd, r)
+Vmdata_t*	vd;
+Slab_t*		r;
+#endif
+{
+	int	i = runindex(r->extent);
+
+	r->kind = SL_FREE;
+	r->prev = NIL(Slab_t*);
+	if((r->next = RUNS(vd)[i]) )
+		r->next->prev = r;
+	RUNS(vd)[i] = r;
+	RUNSELF(r) = r;
+}
+
+#if __STD_C
+static void rununlink(Vmdata_t* vd, Slab_t* r)
+#else
+static void rununlink(vd, r)
+Vmdata_t*	vd;
+Slab_t*		r;
+#endif
+{
+	if(r->next)
+		r->next->prev = r->prev;
+	if(r->prev)
+		r->prev->next = r->next;
+	else	RUNS(vd)[runindex(r->extent)] = r->next;
+}
+
+/* cut a run of extent ext from the free tail tp of seg */
+#if __STD_C
+static Slab_t* runtail(Vmdata_t* vd, Seg_t* seg, Block_t* tp, size_t ext)
+#else
+static Slab_t* runtail(vd, seg, tp, ext)
+Vmdata_t*	vd;
+Seg_t*		seg;
+Block_t*	tp;
+size_t		ext;
+#endif
+{
+	Slab_t	*r;
+	size_t	s;
+
+	s = SIZE(tp) + sizeof(Head_t); /**/ASSERT(s >= ext);
+	r = (Slab_t*)tp;
+	if((s - ext) < R_UNIT) /* too small to be worth keeping */
+	{	ext = s;
+		seg->free = NIL(Block_t*);
+	}
+	else
+	{	tp = (Block_t*)((Vmuchar_t*)r + ext);
+		SEG(tp) = seg;
+		SIZE(tp) = (s - ext) - sizeof(Head_t);
+		seg->free = tp;
+	}
+
+	r->vmdt = vd;
+	r->seg = seg;
+	r->extent = ext;
+	r->pfree = 0; /* free runs never precede the tail */
+	return r;
+}
+
+/* get a run of at least ext bytes */
+#if __STD_C
+static Slab_t* runalloc(Vmalloc_t* vm, size_t ext)
+#else
+static Slab_t* runalloc(vm, ext)
+Vmalloc_t*	vm;
+size_t		ext;
+#endif
+{
+	Slab_t		*r, *n;
+	Block_t		*tp;
+	Seg_t		*seg;
+	int		i;
+	Vmdata_t	*vd = vm->data;
+
+	for(i = runindex(ext); i < S_RUNS; ++i)
+		for(r = RUNS(vd)[i]; r; r = r->next)
+			if(r->extent >= ext)
+				goto got_run;
+
+	/* look thru all segments for a suitable free tail */
+	for(seg = vd->seg; seg; seg = seg->next)
+		if((tp = seg->free) && (SIZE(tp) + sizeof(Head_t)) >= ext)
+			return runtail(vd, seg, tp, ext);
+
+	/* extend generously as tails too small for a slab are wasted */
+	if(!(tp = (*_Vmextend)(vm, ROUND(ext < SLABSEG ? SLABSEG : ext, vd->incr), NIL(Vmsearch_f))) )
+		return NIL(Slab_t*);
+	return runtail(vd, SEG(tp), tp, ext);
+
+got_run:
+	rununlink(vd, r);
+	if((r->extent - ext) >= R_UNIT)
+	{	n = (Slab_t*)((Vmuchar_t*)r + ext);
+		n->vmdt = vd;
+		n->seg = r->seg;
+		n->extent = r->extent - ext;
+		n->pfree = 0;
+		runlink(vd, n);
+		r->extent = ext;
+	}
+	else	SLNEXT(r)->pfree = 0;
+	return r;
+}
+
+/* free a run, merging it with free neighbors */
+#if __STD_C
+static void runfree(Vmdata_t* vd, Slab_t* r)
+#else
+static void runfree(vd, r)
+Vmdata_t*	vd;
+Slab_t*		r;
+#endif
+{
+	Slab_t		*n, *p;
+	Block_t		*tp;
+	Seg_t		*seg = r->seg;
+	size_t		s;
+
+	n = SLNEXT(r);
+	if(!SLISRUN(seg, n)) /* r becomes part of the free tail */
+	{	s = r->extent;
+		if(r->pfree)
+		{	p = RUNPREV(r);
+			rununlink(vd, p);
+			s += p->extent;
+			r = p;
+		}
+		tp = (Block_t*)r;
+		if((Block_t*)n == seg->free)
+			s += SIZE(seg->free) + sizeof(Head_t);
+		SEG(tp) = seg;
+		SIZE(tp) = s - sizeof(Head_t);
+		seg->free = tp;
+		return;
+	}
+
+	if(n->kind == SL_FREE)
+	{	rununlink(vd, n);
+		r->extent += n->extent;
+	}
+	if(r->pfree)
+	{	p = RUNPREV(r);
+		rununlink(vd, p);
+		p->extent += r->extent;
+		r = p;
+	}
+	runlink(vd, r);
+	SLNEXT(r)->pfree = 1;
+}
+
+/* make a new slab for size class c */
+#if __STD_C
+static Slab_t* slabmake(Vmalloc_t* vm, int c)
+#else
+static Slab_t* slabmake(vm, c)
+Vmalloc_t*	vm;
+int		c;
+#endif
+{
+	Slab_t		*sl;
+	size_t		size, ext, head;
+	int		n;
+	Vmdata_t	*vd = vm->data;
+
+	size = slabcap(c) + sizeof(Head_t);
+	for(ext = SLABSIZE; ext < SLABBLKS*size; ext *= 2)
+		;
+	if(!(sl = runalloc(vm, ext)) )
+		return NIL(Slab_t*);
+
+	/* room for the bitmap may cost a block or two */
+	n = (int)((sl->extent - OFFSET(Slab_t,bits)) / size);
+	head = ROUND(OFFSET(Slab_t,bits) + ((n+31)/32)*sizeof(unsigned int), ALIGN);
+	n = (int)((sl->extent - head) / size);
+	memset(sl->bits, 0, ((n+31)/32)*sizeof(unsigned int));
+
+	sl->kind = c;
+	sl->size = size;
+	sl->data = (Vmuchar_t*)sl + head;
+	sl->free = NIL(Block_t*);
+	sl->nblk = n;
+	sl->busy = 0;
+	sl->mark = 0;
+
+	sl->prev = NIL(Slab_t*);
+	if((sl->next = SLAB(vd)[c]) )
+		sl->next->prev = sl;
+	SLAB(vd)[c] = sl;
+
+	return sl;
+}
+
+/* allocate a large block in a run of its own */
+#if __STD_C
+static Void_t* largealloc(Vmalloc_t* vm, size_t size, size_t align)
+#else
+static Void_t* largealloc(vm, size, align)
+Vmalloc_t*	vm;
+size_t		size;
+size_t		align;
+#endif
+{
+	Slab_t		*r;
+	Block_t		*bp;
+	Vmuchar_t	*data;
+	size_t		s, ext;
+
+	size = ROUND(size, ALIGN);
+	ext = SLHEAD + sizeof(Head_t) + size + (align > ALIGN ? align : 0);
+	if(ext <= size || !(r = runalloc(vm, ROUND(ext,R_UNIT))) )
+		return NIL(Void_t*);
+
+	data = (Vmuchar_t*)r + SLHEAD + sizeof(Head_t);
+	if(align > ALIGN && (s = (size_t)(VLONG(data)%align)) != 0)
+		data += align - s;
+
+	bp = BLOCK(data);
+	SEG(bp) = (Seg_t*)r;
+	SIZE(bp) = (((Vmuchar_t*)r + r->extent) - data) | BUSY;
+
+	r->kind = SL_LARGE;
+	r->data = (Vmuchar_t*)bp;
+	r->size = (SIZE(bp)&~BITS) + sizeof(Head_t);
+	r->free = NIL(Block_t*);
+	r->nblk = r->busy = r->mark = 1;
+	r->bits[0] = 1;
+
+	return (Void_t*)data;
+}
+
+#if __STD_C
+static Void_t* slaballoc(Vmalloc_t* vm, size_t size, int local)
+#else
+static Void_t* slaballoc(vm, size, local)
+Vmalloc_t*	vm;
+size_t		size;
+int		local;
+#endif
+{
+	Slab_t		*sl;
+	Block_t		*bp;
+	Void_t		*data;
+	int		c;
+	size_t		i;
+	Vmdata_t	*vd = vm->data;
+
+	SETLOCK(vm, local);
+
+	if(size > MAXSLAB)
+		data = largealloc(vm, size, 0);
+	else if(!(sl = SLAB(vd)[c = slabclass(size ? size : 1)]) &&
+		!(sl = slabmake(vm, c)) )
+		data = NIL(Void_t*);
+	else
+	{	if((bp = sl->free) )
+			sl->free = LINK(bp);
+		else /* carve a never used block */
+		{	bp = (Block_t*)(sl->data + sl->mark*sl->size);
+			sl->mark += 1;
+			SEG(bp) = (Seg_t*)sl;
+		}
+		i = ((Vmuchar_t*)bp - sl->data) / sl->size; /**/ASSERT(!SLISBUSY(sl,i));
+		sl->bits[i>>5] |= 1U << (i&037);
+		SIZE(bp) = (sl->size - sizeof(Head_t)) | BUSY;
+
+		if((sl->busy += 1) == sl->nblk) /* full slabs leave the list */
+		{	if((SLAB(vd)[c] = sl->next) )
+				sl->next->prev = NIL(Slab_t*);
+			sl->next = NIL(Slab_t*);
+		}
+
+		data = DATA(bp);
+	}
+
+	if(!local && (vd->mode&VM_TRACE) && _Vmtrace && data)
+		(*_Vmtrace)(vm, NIL(Vmuchar_t*), (Vmuchar_t*)data, size, 0);
+
+	CLRLOCK(vm, local);
+
+	return data;
+}
+
+#if __STD_C
+static long slabaddr(Vmalloc_t* vm, Void_t* addr, int local)
+#else
+static long slabaddr(vm, addr, local)
+Vmalloc_t*	vm;
+Void_t*		addr;
+int		local;
+#endif
+{
+	Slab_t		*r;
+	Block_t		*bp;
+	Seg_t		*seg;
+	size_t		i;
+	long		offset;
+	Vmuchar_t	*a = (Vmuchar_t*)addr;
+	Vmdata_t	*vd = vm->data;
+
+	SETLOCK(vm, local);
+
+	offset = -1L;
+	for(seg = vd->seg; seg; seg = seg->next)
+	{	if(a < (Vmuchar_t*)SEGBLOCK(seg) || a >= seg->baddr)
+			continue;
+
+		for(r = (Slab_t*)SEGBLOCK(seg); SLISRUN(seg, r); r = SLNEXT(r))
+		{	if(a >= (Vmuchar_t*)SLNEXT(r))
+				continue;
+			if(r->kind == SL_FREE || a < r->data)
+				break;
+			if((i = (a - r->data) / r->size) >= (size_t)r->nblk || !SLISBUSY(r,i))
+				break;
+			bp = (Block_t*)(r->data + i*r->size);
+			if(a >= (Vmuchar_t*)DATA(bp))
+				offset = (long)(a - (Vmuchar_t*)DATA(bp));
+			break;
+		}
+		break;
+	}
+
+	CLRLOCK(vm, local);
+
+	return offset;
+}
+
+#if __STD_C
+static int slabfree(Vmalloc_t* vm, Void_t* data, int local)
+#else
+static int slabfree(vm, data, local)
+Vmalloc_t*	vm;
+Void_t*		data;
+int		local;
+#endif
+{
+	Slab_t		*sl;
+	Block_t		*bp;
+	size_t		i, size;
+	Vmdata_t	*vd = vm->data;
+
+	if(!data)
+		return 0;
+
+	SETLOCK(vm, local);
+
+	/**/ASSERT(KPVADDR(vm, data, slabaddr) == 0);
+	bp = BLOCK(data);
+	sl = (Slab_t*)SEG(bp);
+	if(sl->vmdt != vd || !ISBUSY(SIZE(bp)) )
+	{	CLRLOCK(vm, local);
+		return -1;
+	}
+	size = SIZE(bp)&~BITS;
+
+	if(sl->kind == SL_LARGE)
+	{	CLRBUSY(SIZE(bp));
+		sl->busy = 0;
+		runfree(vd, sl);
+	}
+	else
+	{	i = ((Vmuchar_t*)bp - sl->data) / sl->size;
+		sl->bits[i>>5] &= ~(1U << (i&037));
+		CLRBUSY(SIZE(bp));
+		LINK(bp) = sl->free;
+		sl->free = bp;
+
+		if(sl->busy == sl->nblk) /* back on the list of its class */
+		{	sl->prev = NIL(Slab_t*);
+			if((sl->next = SLAB(vd)[sl->kind]) )
+				sl->next->prev = sl;
+			SLAB(vd)[sl->kind] = sl;
+		}
+
+		/* an empty slab is released if its class has others */
+		if((sl->busy -= 1) == 0 && (sl->prev || sl->next) )
+		{	if(sl->next)
+				sl->next->prev = sl->prev;
+			if(sl->prev)
+				sl->prev->next = sl->next;
+			else	SLAB(vd)[sl->kind] = sl->next;
+			runfree(vd, sl);
+		}
+	}
+
+	if(!local && (vd->mode&VM_TRACE) && _Vmtrace)
+		(*_Vmtrace)(vm, (Vmuchar_t*)data, NIL(Vmuchar_t*), size, 0);
+
+	CLRLOCK(vm, local);
+
+	return 0;
+}
+
+/* grow or shrink the run of a large block in place */
+#if __STD_C
+static void largeresize(Vmdata_t* vd, Slab_t* r, size_t size)
+#else
+static void largeresize(vd, r, size)
+Vmdata_t*	vd;
+Slab_t*		r;
+size_t		size;
+#endif
+{
+	Slab_t		*n;
+	Block_t		*bp = (Block_t*)r->data;
+	Seg_t		*seg = r->seg;
+	size_t		ext, s;
+
+	ext = ROUND(((Vmuchar_t*)DATA(bp) - (Vmuchar_t*)r) + size, R_UNIT);
+	if(ext > r->extent) /* extend into a following free run or tail */
+	{	n = SLNEXT(r);
+		s = ext - r->extent;
+		if(SLISRUN(seg, n))
+		{	if(n->kind != SL_FREE || n->extent < s)
+				return;
+			rununlink(vd, n);
+			if((n->extent - s) >= R_UNIT)
+			{	ext = n->extent - s;
+				n = (Slab_t*)((Vmuchar_t*)n + s);
+				n->vmdt = vd;
+				n->seg = seg;
+				n->extent = ext;
+				n->pfree = 0;
+				runlink(vd, n);
+				r->extent += s;
+			}
+			else
+			{	r->extent += n->extent;
+				SLNEXT(r)->pfree = 0;
+			}
+		}
+		else if((Block_t*)n == seg->free && (SIZE(seg->free) + sizeof(Head_t)) >= s)
+			r->extent += runtail(vd, seg, (Block_t*)n, s)->extent;
+		else	return;
+	}
+	else if((r->extent - ext) >= R_UNIT) /* give back the unused part */
+	{	n = (Slab_t*)((Vmuchar_t*)r + ext);
+		n->vmdt = vd;
+		n->seg = seg;
+		n->extent = r->extent - ext;
+		n->pfree = 0;
+		r->extent = ext;
+		runfree(vd, n);
+	}
+	else	return;
+
+	SIZE(bp) = ((Vmuchar_t*)SLNEXT(r) - (Vmuchar_t*)DATA(bp)) | BUSY;
+	r->size = (SIZE(bp)&~BITS) + sizeof(Head_t);
+}
+
+#if __STD_C
+static Void_t* slabresize(Vmalloc_t* vm, Void_t* data, size_t size, int type, int local)
+#else
+static Void_t* slabresize(vm, data, size, type, local)
+Vmalloc_t*	vm;
+Void_t*		data;
+size_t		size;
+int		type;
+int		local;
+#endif
+{
+	Slab_t		*sl;
+	Void_t		*oldd;
+	size_t		oldz, orgsize = size;
+	Void_t		*orgdata = data;
+	Vmdata_t	*vd = vm->data;
+
+	if(!data)
+	{	data = slaballoc(vm, size, local);
+		if(data && (type&VM_RSZERO) )
+			memset(data, 0, size);
+		return data;
+	}
+	if(size == 0)
+	{	(void)slabfree(vm, data, local);
+		return NIL(Void_t*);
+	}
+
+	SETLOCK(vm, local);
+
+	/**/ASSERT(KPVADDR(vm, data, slabaddr) == 0);
+	sl = (Slab_t*)SEG(BLOCK(data));
+	oldz = SIZE(BLOCK(data))&~BITS;
+
+	if(sl->kind == SL_LARGE)
+		largeresize(vd, sl, ROUND(size,ALIGN));
+
+	if(size > (SIZE(BLOCK(data))&~BITS) ||
+	   (size <= oldz/4 && (type&VM_RSMOVE) && sl->kind != SL_LARGE) )
+	{	if(!(type&(VM_RSMOVE|VM_RSCOPY)) )
+			data = NIL(Void_t*); /* old data is not moveable */
+		else
+		{	oldd = data;
+			if((data = KPVALLOC(vm, size, slaballoc)) )
+			{	if(type&VM_RSCOPY)
+					memcpy(data, oldd, oldz < size ? oldz : size);
+				(void)KPVFREE(vm, oldd, slabfree);
+			}
+		}
+	}
+
+	if(data && (type&VM_RSZERO) && (size = SIZE(BLOCK(data))&~BITS) > oldz )
+		memset((Void_t*)((Vmuchar_t*)data + oldz), 0, size-oldz);
+
+	if(!local && (vd->mode&VM_TRACE) && _Vmtrace && data)
+		(*_Vmtrace)(vm, (Vmuchar_t*)orgdata, (Vmuchar_t*)data, orgsize, 0);
+
+	CLRLOCK(vm, local);
+
+	return data;
+}
+
+#if __STD_C
+static long slabsize(Vmalloc_t* vm, Void_t* addr, int local)
+#else
+static long slabsize(vm, addr, local)
+Vmalloc_t*	vm;
+Void_t*		addr;
+int		local;
+#endif
+{
+	long	size;
+
+	SETLOCK(vm, local);
+
+	if(KPVADDR(vm, addr, slabaddr) == 0)
+		size = (long)(SIZE(BLOCK(addr))&~BITS);
+	else	size = -1L;
+
+	CLRLOCK(vm, local);
+
+	return size;
+}
+
+#if __STD_C
+static int slabcompact(Vmalloc_t* vm, int local)
+#else
+static int slabcompact(vm, local)
+Vmalloc_t*	vm;
+int		local;
+#endif
+{
+	Seg_t		*seg, *next;
+	Block_t		*fp;
+	Slab_t		*r;
+	size_t		size, segsize;
+	int		i;
+	Vmdata_t	*vd = vm->data;
+
+	SETLOCK(vm, local);
+
+	for(seg = vd->seg; seg; seg = next)
+	{	next = seg->next;
+
+		if(!(fp = seg->free))
+			continue;
+
+		if((size = SIZE(fp)) < (segsize = seg->size))
+			size += sizeof(Head_t);
+
+		if((size = (*_Vmtruncate)(vm,seg,size,0)) > 0)
+		{	if(size >= segsize) /* entire segment deleted */
+				continue;
+			if((size = seg->baddr - (Vmuchar_t*)fp - sizeof(Head_t)) > 0)
+				SIZE(fp) = size - sizeof(Head_t);
+			else	seg->free = NIL(Block_t*);
+		}
+	}
+
+	/* give back the pages of large free tails and runs */
+	if(_Vmrelsize > 0)
+	{	for(seg = vd->seg; seg; seg = seg->next)
+			if((fp = seg->free) && SIZE(fp) >= _Vmrelsize)
+				(void)(*_Vmrelease)(vm, DATA(fp), SIZE(fp));
+		for(i = runindex(_Vmrelsize); i < S_RUNS; ++i)
+			for(r = RUNS(vd)[i]; r; r = r->next)
+				if(r->extent >= _Vmrelsize) /* keep header and RUNSELF */
+					(void)(*_Vmrelease)(vm, (Vmuchar_t*)r + SLHEAD,
+							    r->extent - SLHEAD - sizeof(Slab_t*));
+	}
+
+	if(!local && (vd->mode&VM_TRACE) && _Vmtrace)
+		(*_Vmtrace)(vm, (Vmuchar_t*)0, (Vmuchar_t*)0, 0, 0);
+
+	CLRLOCK(vm, local);
+
+	return 0;
+}
+
+#if __STD_C
+static Void_t* slabalign(Vmalloc_t* vm, size_t size, size_t align, int local)
+#else
+static Void_t* slabalign(vm, size, align, local)
+Vmalloc_t*	vm;
+size_t		size;
+size_t		align;
+int		local;
+#endif
+{
+	Void_t		*data;
+	size_t		orgsize = size, orgalign = align;
+	Vmdata_t	*vd = vm->data;
+
+	if(size <= 0 || align <= 0)
+		return NIL(Void_t*);
+
+	SETLOCK(vm, local);
+
+	if((align = MULTIPLE(align,ALIGN)) <= ALIGN)
+		data = KPVALLOC(vm, size, slaballoc);
+	else	data = largealloc(vm, size, align);
+
+	if(!local && (vd->mode&VM_TRACE) && _Vmtrace && data)
+		(*_Vmtrace)(vm, NIL(Vmuchar_t*), (Vmuchar_t*)data, orgsize, orgalign);
+
+	CLRLOCK(vm, local);
+
+	return data;
+}
+
+/* Public interface */
+static Vmethod_t _Vmslab =
+{
+	slaballoc,
+	slabresize,
+	slabfree,
+	slabaddr,
+	slabsize,
+	slabcompact,
+	slabalign,
+	VM_MTSLAB
+};
+
+__DEFINE__(Vmethod_t*,Vmslab,&_Vmslab);
+
+#ifdef NoF
+NoF(vmslab)
+#endif
+
+#endif
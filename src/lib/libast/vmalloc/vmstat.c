@@ -27,11 +27,46 @@ void _STUB_vmstat(){}
 
 #include	"vmhdr.h"
 
+#if _lib_mincore
+#include	<sys/mman.h>
+#endif
+
 /*	Get statistics from a region.
 **
 **	Written by Kiem-Phong Vo, kpv@research.att.com, 01/16/94.
 */
 
+/* the part of a segment that is resident in memory */
+#if __STD_C
+static size_t segresident(Seg_t* seg)
+#else
+static size_t segresident(seg)
+Seg_t*	seg;
+#endif
+{
+#if _lib_mincore
+	Vmuchar_t	*addr, *endaddr;
+	size_t		n, k, size;
+	unsigned char	vec[256];
+
+	GETPAGESIZE(_Vmpagesize);
+	addr = (Vmuchar_t*)((VLONG(seg->addr)/_Vmpagesize)*_Vmpagesize);
+	endaddr = (Vmuchar_t*)seg->addr + seg->extent;
+	for(size = 0; addr < endaddr; addr += n*_Vmpagesize)
+	{	if((n = (endaddr - addr + _Vmpagesize-1)/_Vmpagesize) > sizeof(vec))
+			n = sizeof(vec);
+		if(mincore((Void_t*)addr, n*_Vmpagesize, (Void_t*)vec) < 0)
+			return seg->extent; /* assume it is all there */
+		for(k = 0; k < n; ++k)
+			if(vec[k]&01)
+				size += _Vmpagesize;
+	}
+	return size < seg->extent ? size : seg->extent;
+#else
+	return seg->extent;
+#endif
+}
+
 #if __STD_C
 int vmstat(Vmalloc_t* vm, Vmstat_t* st)
 #else
@@ -43,6 +78,7 @@ Vmstat_t*	st;
 	size_t		s;
 	Seg_t		*seg;
 	Block_t		*b, *endb;
+	Slab_t		*sl;
 	Vmdata_t	*vd;
 	Void_t		*d;
 
@@ -79,9 +115,11 @@ Vmstat_t*	st;
 			st->n_free += 1;
 	}
 
+	st->released = vd->released;
 	for(seg = vd->seg; seg; seg = seg->next)
 	{	st->n_seg += 1;
 		st->extent += seg->extent;
+		st->resident += segresident(seg);
 
 		b = SEGBLOCK(seg);
 		endb = BLOCK(seg->baddr);
@@ -121,6 +159,34 @@ Vmstat_t*	st;
 				st->n_busy += 1;
 			}
 		}
+		else if(vd->mode&VM_MTSLAB)
+		{	for(sl = (Slab_t*)b; SLISRUN(seg, sl); sl = SLNEXT(sl))
+			{	if(sl->kind == SL_FREE)
+				{	if((s = sl->extent) > st->m_free)
+						st->m_free = s;
+					st->s_free += s;
+					st->n_free += 1;
+					continue;
+				}
+				s = sl->size - sizeof(Head_t);
+				if(sl->busy > 0 && s > st->m_busy)
+					st->m_busy = s;
+				st->s_busy += sl->busy*s;
+				st->n_busy += sl->busy;
+				if(sl->busy < sl->nblk)
+				{	if(s > st->m_free)
+						st->m_free = s;
+					st->s_free += (sl->nblk - sl->busy)*s;
+					st->n_free += sl->nblk - sl->busy;
+				}
+			}
+			if((b = seg->free) )
+			{	if((s = SIZE(b) + sizeof(Head_t)) > st->m_free)
+					st->m_free = s;
+				st->s_free += s;
+				st->n_free += 1;
+			}
+		}
 		else if((vd->mode&VM_MTPOOL) && s > 0)
 		{	if(seg->free)
 				st->n_free += (SIZE(seg->free)+sizeof(Head_t))/s;
@@ -144,6 +144,8 @@ size_t		align;		/* alignment			*/
 		bufp = trstrcpy(bufp, "l", ':');
 	else if(type&VM_MTPOOL)
 		bufp = trstrcpy(bufp, "p", ':');
+	else if(type&VM_MTSLAB)
+		bufp = trstrcpy(bufp, "c", ':');
 	else if(type&VM_MTPROFILE)
 		bufp = trstrcpy(bufp, "s", ':');
 	else if(type&VM_MTDEBUG)
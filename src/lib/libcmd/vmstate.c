@@ -23,7 +23,7 @@
 #define FORMAT		"region=%(region)p method=%(method)s flags=%(flags)s size=%(size)d segments=%(segments)d busy=(%(busy_size)d,%(busy_blocks)d,%(busy_max)d) free=(%(free_size)d,%(free_blocks)d,%(free_max)d)"
 
 static const char usage[] =
-"[-?\n@(#)$Id: vmstate (AT&T Research) 2010-04-08 $\n]"
+"[-?\n@(#)$Id: vmstate (AT&T Research) 2026-10-18 $\n]"
 USAGE_LICENSE
 "[+NAME?vmstate - list the calling process vmalloc region state]"
 "[+DESCRIPTION?When invoked as a shell builtin, \bvmstate\b lists the "
@@ -44,6 +44,8 @@ USAGE_LICENSE
         "[+free_size?The total free block size.]"
         "[+free_blocks?The number of free blocks.]"
         "[+free_max?The maximum free block size.]"
+        "[+resident?The part of the region size resident in memory.]"
+        "[+released?The total size released to the system.]"
     "}"
 "[+SEE ALSO?\bvmalloc\b(3)]"
 ;
@@ -108,6 +110,10 @@ key(void* handle, Sffmt_t* fp, const char* arg, char** ps, Sflong_t* pn)
 		*pn = state->vs.n_free;
 	else if (streq(s, "free_max"))
 		*pn = state->vs.m_free;
+	else if (streq(s, "resident"))
+		*pn = state->vs.resident;
+	else if (streq(s, "released"))
+		*pn = state->vs.released;
 	else if (streq(s, "format"))
 		*ps = (char*)state->format;
 	else if (streq(s, "method"))
@@ -122,6 +128,10 @@ key(void* handle, Sffmt_t* fp, const char* arg, char** ps, Sflong_t* pn)
 			*ps = "debug";
 		else if (state->vs.mode & VM_MTPROFILE)
 			*ps = "profile";
+#ifdef VM_MTSLAB
+		else if (state->vs.mode & VM_MTSLAB)
+			*ps = "slab";
+#endif
 		else
 			*ps = "UNKNOWN";
 	}
@@ -28,8 +28,8 @@
 #endif
 
 #define RS_PLUGIN_VERSION	AST_PLUGIN_VERSION(20100528L)
-#define RS_VERSION		20030811L
-#define RSKEY_VERSION		20111011L
+#define RS_VERSION		20261017L
+#define RSKEY_VERSION		20261017L
 
 #define SORTLIB(m)		unsigned long plugin_version(void) { return RS_PLUGIN_VERSION; }
 
@@ -66,6 +66,8 @@ struct _rsdisc_s
 	Rsevent_f	eventf;	/* to announce various events		*/
 	unsigned long	events;	/* events to announce			*/
 	Rsdisc_t*	disc;	/* next in stack			*/
+	int		threads;/* thread method threads, 0 for all	*/
+	ssize_t		limit;	/* limit method max records, 0 for all	*/
 };
 
 struct _rsobj_s
@@ -191,7 +193,9 @@ struct _rs_s
 #define RS_MTRASP	001000
 #define RS_MTRADIX	002000
 #define RS_MTSPLAY	004000
+#define RS_MTTHREAD	010000
 #define RS_MTCOPY	020000
+#define RS_MTLIMIT	0100000
 
 #define RSKEY_ERROR	000001		/* unrecoverable error		*/
 #define RSKEY_KEYS	000002		/* keys specified		*/
@@ -218,9 +222,11 @@ extern Rsdisc_t*	rs_disc _ARG_((Rskey_t*, const char*));
 #endif
 
 extern Rsmethod_t* Rscopy;	/* copy original order	*/
+extern Rsmethod_t* Rslimit;	/* first limit records	*/
 extern Rsmethod_t* Rsrasp;	/* radix + splay trees	*/
 extern Rsmethod_t* Rsradix;	/* radix only		*/
 extern Rsmethod_t* Rssplay;	/* splay insertion	*/
+extern Rsmethod_t* Rsthread;	/* threaded radix	*/
 extern Rsmethod_t* Rsverify;	/* verify order		*/
 
 #undef extern
@@ -241,6 +247,7 @@ extern ssize_t		rsprocess _ARG_((Rs_t*, Void_t*, ssize_t));
 extern int		rslib _ARG_((Rs_t*, Rskey_t*, const char*, int));
 extern Rsobj_t*		rslist _ARG_((Rs_t*));
 extern int		rswrite _ARG_((Rs_t*, Sfio_t*, int));
+extern int		rswritepart _ARG_((Rs_t*, Sfio_t**, int, Rsobj_t*, int));
 extern int		rsmerge _ARG_((Rs_t*, Sfio_t*, Sfio_t**, int, int));
 extern Rsdisc_t*	rsdisc _ARG_((Rs_t*, Rsdisc_t*, int));
 extern Rsmethod_t*	rsmethod _ARG_((Rs_t*, Rsmethod_t*));
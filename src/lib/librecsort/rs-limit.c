@@ -0,0 +1,363 @@
+/***********************************************************************
+*                                                                      *
+*               This software is part of the ast package               *
+*          Copyright (c) 1996-2011 AT&T Intellectual Property          *
+*                      and is licensed under the                       *
+*                 Eclipse Public License, Version 1.0                  *
+*                    by AT&T Intellectual Property                     *
+*                                                                      *
+*                A copy of the License is available at                 *
+*          http://www.eclipse.org/org/documents/epl-v10.html           *
+*         (with md5 checksum b35adb5213ca9657e911e9befb180842)         *
+*                                                                      *
+*              Information and Software Systems Research               *
+*                            AT&T Research                             *
+*                           Florham Park NJ                            *
+*                                                                      *
+*                   Phong Vo <kpv@research.att.com>                    *
+*                 Glenn Fowler <gsf@research.att.com>                  *
+*                                                                      *
+***********************************************************************/
+/*	Bounded selection of the first Rsdisc_t.limit records in sort order.
+**	Strategy:
+**	1. Retained records are copied, with their keys, into private space
+**	   so that the caller may reuse its input buffers.
+**	2. They are kept in a heap with the record that would be output
+**	   last at the root. A new record either replaces the root or is
+**	   dropped on arrival, so space stays proportional to the limit.
+**	3. With RS_UNIQ, a hash table on the keys keeps one record per key.
+**	4. The list is produced by heap sort.
+**	Equivalent records are kept as distinct objects ordered by arrival
+**	(or by data for RS_DATA) so rslist() never needs to resort them.
+**	A limit <= 0 retains all records.
+*/
+
+#include	"rshdr.h"
+
+#define LIMITMIN	64	/* initial heap size with no limit	*/
+
+typedef struct _rslimobj_s	Rslimobj_t;
+
+struct _rslimobj_s
+{	Rsobj_t		obj;	/* record with private key and data	*/
+	Sfulong_t	seq;	/* arrival order			*/
+	ssize_t		size;	/* space for key and data		*/
+	Rslimobj_t*	next;	/* RS_UNIQ hash chain			*/
+};
+
+typedef struct _rslimit_s
+{	Rslimobj_t**	heap;	/* heap[0] would be output last		*/
+	ssize_t		n;	/* number of heap elements		*/
+	ssize_t		size;	/* heap size				*/
+	ssize_t		limit;	/* max heap size, 0 for none		*/
+	Rslimobj_t**	hash;	/* RS_UNIQ key table			*/
+	ulong		mask;	/* hash table size - 1			*/
+	Sfulong_t	seq;	/* arrival counter			*/
+} Rslimit_t;
+
+#define HASH(h,k,n)	{ reg uchar *_k = (k), *_e = _k + (n); \
+			  for(h = 0; _k < _e; ++_k) h = (h << 5) + h + *_k; \
+			}
+
+#if __STD_C
+static int bytecmp(reg uchar* a, ssize_t an, reg uchar* b, ssize_t bn)
+#else
+static int bytecmp(a, an, b, bn)
+reg uchar*	a;
+ssize_t		an;
+reg uchar*	b;
+ssize_t		bn;
+#endif
+{
+	reg int	c;
+
+	if((c = memcmp(a, b, an < bn ? an : bn)) )
+		return c;
+	return an < bn ? -1 : an > bn ? 1 : 0;
+}
+
+/* < 0 if object a (arrived at as) is output before b (arrived at bs) */
+#if __STD_C
+static int limcmp(int type, Rsobj_t* a, Sfulong_t as, Rsobj_t* b, Sfulong_t bs)
+#else
+static int limcmp(type, a, as, b, bs)
+int		type;
+Rsobj_t*	a;
+Sfulong_t	as;
+Rsobj_t*	b;
+Sfulong_t	bs;
+#endif
+{
+	reg int	c;
+
+	c = bytecmp(a->key, a->keylen, b->key, b->keylen);
+	if(c == 0 && (type&RS_DATA) && !(type&RS_UNIQ) )
+		c = bytecmp(a->data, a->datalen, b->data, b->datalen);
+	if(c == 0) /* rslist() reverses equivalent records too */
+		c = as < bs ? -1 : as > bs ? 1 : 0;
+	return (type&RS_REVERSE) ? -c : c;
+}
+
+#if __STD_C
+static void siftdown(int type, reg Rslimobj_t** heap, reg ssize_t i, reg ssize_t n)
+#else
+static void siftdown(type, heap, i, n)
+int			type;
+reg Rslimobj_t**	heap;
+reg ssize_t		i;
+reg ssize_t		n;
+#endif
+{
+	reg ssize_t	c;
+	reg Rslimobj_t*	e = heap[i];
+
+	while((c = 2*i + 1) < n)
+	{	if(c+1 < n && limcmp(type, &heap[c+1]->obj, heap[c+1]->seq, &heap[c]->obj, heap[c]->seq) > 0)
+			c += 1;
+		if(limcmp(type, &heap[c]->obj, heap[c]->seq, &e->obj, e->seq) <= 0)
+			break;
+		heap[i] = heap[c];
+		i = c;
+	}
+	heap[i] = e;
+}
+
+#if __STD_C
+static void siftup(int type, reg Rslimobj_t** heap, reg ssize_t i)
+#else
+static void siftup(type, heap, i)
+int			type;
+reg Rslimobj_t**	heap;
+reg ssize_t		i;
+#endif
+{
+	reg ssize_t	p;
+	reg Rslimobj_t*	e = heap[i];
+
+	for(; i > 0; i = p)
+	{	p = (i-1) / 2;
+		if(limcmp(type, &heap[p]->obj, heap[p]->seq, &e->obj, e->seq) >= 0)
+			break;
+		heap[i] = heap[p];
+	}
+	heap[i] = e;
+}
+
+/* (re)build the RS_UNIQ hash table for the current heap size */
+#if __STD_C
+static int rehash(Rs_t* rs, reg Rslimit_t* lim)
+#else
+static int rehash(rs, lim)
+Rs_t*		rs;
+reg Rslimit_t*	lim;
+#endif
+{
+	reg Rslimobj_t*	e;
+	reg ssize_t	i;
+	reg ulong	h, m;
+
+	for(m = 1; m < (ulong)lim->size; m <<= 1)
+		;
+	if(lim->hash)
+		vmfree(rs->vm, lim->hash);
+	if(!(lim->hash = (Rslimobj_t**)vmresize(rs->vm, NIL(Void_t*), m*sizeof(Rslimobj_t*), VM_RSZERO)) )
+		return -1;
+	lim->mask = m-1;
+	for(i = 0; i < lim->n; ++i)
+	{	e = lim->heap[i];
+		HASH(h, e->obj.key, e->obj.keylen);
+		h &= lim->mask;
+		e->next = lim->hash[h];
+		lim->hash[h] = e;
+	}
+	return 0;
+}
+
+/* copy obj into e, reallocating e if it is too small */
+#if __STD_C
+static Rslimobj_t* limcopy(Rs_t* rs, reg Rslimobj_t* e, reg Rsobj_t* obj)
+#else
+static Rslimobj_t* limcopy(rs, e, obj)
+Rs_t*		rs;
+reg Rslimobj_t*	e;
+reg Rsobj_t*	obj;
+#endif
+{
+	reg ssize_t	z = obj->keylen + obj->datalen;
+
+	if(!e || e->size < z)
+	{	if(e)
+			vmfree(rs->vm, e);
+		if(!(e = (Rslimobj_t*)vmalloc(rs->vm, sizeof(Rslimobj_t) + z)) )
+			return NIL(Rslimobj_t*);
+		e->size = z;
+	}
+	e->obj = *obj;
+	e->obj.equal = NIL(Rsobj_t*);
+	e->obj.key = (uchar*)(e+1);
+	memcpy(e->obj.key, obj->key, obj->keylen);
+	e->obj.data = e->obj.key + obj->keylen;
+	memcpy(e->obj.data, obj->data, obj->datalen);
+	return e;
+}
+
+#if __STD_C
+static int liminsert(Rs_t* rs, reg Rsobj_t* obj)
+#else
+static int liminsert(rs, obj)
+Rs_t*		rs;
+reg Rsobj_t*	obj;
+#endif
+{
+	reg Rslimobj_t	*e, **p;
+	reg ulong	h;
+	reg Sfulong_t	seq;
+	reg int		type = rs->type;
+	reg Rslimit_t*	lim = (Rslimit_t*)rs->methdata;
+
+	if(!lim->heap)
+	{	lim->limit = rs->disc->version >= 20261017L && rs->disc->limit > 0 ? rs->disc->limit : 0;
+		lim->size = lim->limit ? lim->limit : LIMITMIN;
+		if(!(lim->heap = (Rslimobj_t**)vmalloc(rs->vm, lim->size*sizeof(Rslimobj_t*))) )
+			return -1;
+		if((type&RS_UNIQ) && rehash(rs, lim) < 0)
+			return -1;
+	}
+	seq = lim->seq++;
+
+	h = 0;
+	if(type&RS_UNIQ)
+	{	HASH(h, obj->key, obj->keylen);
+		h &= lim->mask;
+		for(e = lim->hash[h]; e; e = e->next)
+		{	if(bytecmp(e->obj.key, e->obj.keylen, obj->key, obj->keylen) == 0)
+			{	/* rslist() keeps the last of a reversed class */
+				if((type&RS_REVERSE) && e->size >= obj->datalen + obj->keylen)
+				{	memcpy(e->obj.data = e->obj.key + e->obj.keylen, obj->data, obj->datalen);
+					e->obj.datalen = obj->datalen;
+					e->seq = seq;
+				}
+				else if(type&RS_REVERSE)
+				{	for(p = &lim->hash[h]; *p != e; p = &(*p)->next)
+						;
+					*p = e->next;
+					for(h = 0; lim->heap[h] != e; ++h)
+						;
+					if(!(e = limcopy(rs, e, obj)) )
+						return -1;
+					e->seq = seq;
+					lim->heap[h] = e;
+					HASH(h, obj->key, obj->keylen);
+					h &= lim->mask;
+					e->next = lim->hash[h];
+					lim->hash[h] = e;
+				}
+				goto done;
+			}
+		}
+	}
+
+	if(lim->n < lim->size)
+		e = NIL(Rslimobj_t*);
+	else if(!lim->limit)
+	{	if(!(p = (Rslimobj_t**)vmresize(rs->vm, lim->heap, 2*lim->size*sizeof(Rslimobj_t*), VM_RSCOPY|VM_RSMOVE)) )
+			return -1;
+		lim->heap = p;
+		lim->size *= 2;
+		if((type&RS_UNIQ) && rehash(rs, lim) < 0)
+			return -1;
+		HASH(h, obj->key, obj->keylen);
+		h &= lim->mask;
+		e = NIL(Rslimobj_t*);
+	}
+	else if(limcmp(type, obj, seq, &lim->heap[0]->obj, lim->heap[0]->seq) >= 0)
+		goto done;
+	else /* replace the record that would be output last */
+	{	e = lim->heap[0];
+		if(type&RS_UNIQ)
+		{	ulong	x;
+			HASH(x, e->obj.key, e->obj.keylen);
+			for(p = &lim->hash[x & lim->mask]; *p != e; p = &(*p)->next)
+				;
+			*p = e->next;
+		}
+	}
+
+	if(!(e = limcopy(rs, e, obj)) )
+		return -1;
+	e->seq = seq;
+	if(type&RS_UNIQ)
+	{	e->next = lim->hash[h];
+		lim->hash[h] = e;
+	}
+	if(lim->n < lim->size)
+	{	lim->heap[lim->n] = e;
+		siftup(type, lim->heap, lim->n++);
+	}
+	else
+	{	lim->heap[0] = e;
+		siftdown(type, lim->heap, 0, lim->n);
+	}
+
+done:	/* obj itself is no longer needed */
+	obj->right = rs->free;
+	rs->free = obj;
+	return 0;
+}
+
+#if __STD_C
+static Rsobj_t* limlist(Rs_t* rs)
+#else
+static Rsobj_t* limlist(rs)
+Rs_t*		rs;
+#endif
+{
+	reg Rsobj_t	*list, *r;
+	reg ssize_t	i, n;
+	reg Rslimobj_t*	e;
+	reg Rslimobj_t**	heap;
+	reg int		type = rs->type;
+	reg Rslimit_t*	lim = (Rslimit_t*)rs->methdata;
+
+	if((n = lim->n) <= 0)
+		return NIL(Rsobj_t*);
+	heap = lim->heap;
+
+	/* heap sort, the output order ends up in heap[0..n-1] */
+	for(i = n-1; i > 0; --i)
+	{	e = heap[0]; heap[0] = heap[i]; heap[i] = e;
+		siftdown(type, heap, 0, i);
+	}
+
+	/* rslist() will reverse the list for RS_REVERSE */
+	list = NIL(Rsobj_t*);
+	for(i = 0; i < n; ++i)
+	{	r = &heap[(type&RS_REVERSE) ? i : n-1-i]->obj;
+		r->right = list;
+		if(list)
+			r->left = list->left;
+		else	r->left = r;
+		list = r;
+	}
+
+	lim->heap = NIL(Rslimobj_t**);
+	lim->hash = NIL(Rslimobj_t**);
+	lim->n = lim->size = 0;
+	return list;
+}
+
+/* public method */
+static Rsmethod_t _Rslimit =
+{	liminsert,
+	limlist,
+	sizeof(Rslimit_t),
+	RS_MTLIMIT,
+	"limit",
+	"Heap selection of the first Rsdisc_t.limit records."
+};
+
+__DEFINE__(Rsmethod_t*, Rslimit, &_Rslimit);
+
+#ifdef NoF
+NoF(rslimit)
+#endif
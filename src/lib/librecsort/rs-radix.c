@@ -52,32 +52,33 @@ reg Rsobj_t*	obj;
 	return 0;
 }
 
+/*	Sort a list of objects whose keys are known to agree on the first ph bytes.
+**	The list is linked by right pointers and work->left is its last element.
+**	This is also used by the threaded method on each of its partitions.
+*/
 #if __STD_C
-static Rsobj_t* radixlist(Rs_t* rs)
+Rsobj_t* rsradixsort(reg Rsobj_t* work, ssize_t ph, int type)
 #else
-static Rsobj_t* radixlist(rs)
-Rs_t*		rs;
+Rsobj_t* rsradixsort(work, ph, type)
+reg Rsobj_t*	work;
+ssize_t		ph;
+int		type;
 #endif
 {
-	reg Rsobj_t	*work, *r;
-	reg ssize_t	ph;
+	reg Rsobj_t	*r;
 	reg Rsobj_t	**bin, *t, *empty, *list, *endl, *next, **lo, **maxpart;
 	reg ssize_t	n, maxph;
 	Rsobj_t		*part[UCHAR_MAX+1];
-	reg Rsradix_t*	radix = (Rsradix_t*)rs->methdata;
 
-	if (!radix->list)
-		return NIL(Rsobj_t*);
 	for(lo = part, maxpart = part + UCHAR_MAX+1; lo < maxpart; ++lo)
 		*lo = NIL(Rsobj_t*);
 
-	work = radix->list; radix->list = NIL(Rsobj_t*);
 	work->left->right = NIL(Rsobj_t*);
-	list = NIL(Rsobj_t*);
+	list = endl = NIL(Rsobj_t*);
 
-	if(rs->type&RS_KSAMELEN)
+	if(type&RS_KSAMELEN)
 	{	maxph = work->keylen-1;
-		for(work->order = 0; work; )
+		for(work->order = ph; work; )
 		{	next = work->left->right; work->left->right = NIL(Rsobj_t*);
 
 			lo = maxpart; n = 0;
@@ -147,7 +148,7 @@ Rs_t*		rs;
 		}
 	}
 	else
-	{	for(work->order = 0; work; )
+	{	for(work->order = ph; work; )
 		{	next = work->left->right; work->left->right = NIL(Rsobj_t*);
 			empty = NIL(Rsobj_t*);
 			lo = maxpart; n = 0;
@@ -221,6 +222,22 @@ Rs_t*		rs;
 	return list;
 }
 
+#if __STD_C
+static Rsobj_t* radixlist(Rs_t* rs)
+#else
+static Rsobj_t* radixlist(rs)
+Rs_t*		rs;
+#endif
+{
+	reg Rsobj_t*	work;
+	reg Rsradix_t*	radix = (Rsradix_t*)rs->methdata;
+
+	if (!(work = radix->list))
+		return NIL(Rsobj_t*);
+	radix->list = NIL(Rsobj_t*);
+	return rsradixsort(work, 0, rs->type);
+}
+
 /* public method */
 static Rsmethod_t _Rsradix =
 {	radixinsert,
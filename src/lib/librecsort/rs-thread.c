@@ -0,0 +1,304 @@
+/***********************************************************************
+*                                                                      *
+*               This software is part of the ast package               *
+*          Copyright (c) 1996-2011 AT&T Intellectual Property          *
+*                      and is licensed under the                       *
+*                 Eclipse Public License, Version 1.0                  *
+*                    by AT&T Intellectual Property                     *
+*                                                                      *
+*                A copy of the License is available at                 *
+*          http://www.eclipse.org/org/documents/epl-v10.html           *
+*         (with md5 checksum b35adb5213ca9657e911e9befb180842)         *
+*                                                                      *
+*              Information and Software Systems Research               *
+*                            AT&T Research                             *
+*                           Florham Park NJ                            *
+*                                                                      *
+*                   Phong Vo <kpv@research.att.com>                    *
+*                 Glenn Fowler <gsf@research.att.com>                  *
+*                                                                      *
+***********************************************************************/
+/*	Threaded radix sort.
+**	Strategy:
+**	1. All records are kept on a linked list as in the radix method.
+**	2. The list is bucketed on leading key bytes into partitions
+**	   until no partition holds more than a fair share of the records.
+**	3. A pool of threads takes partitions off a shared queue and
+**	   radix sorts each of them independently.
+**	4. The sorted partitions are concatenated in key order.
+**	The number of threads comes from Rsdisc_t.threads; <= 0 means one per
+**	online processor. Small lists are sorted without starting any threads.
+*/
+
+#include	"rshdr.h"
+
+#if _lib_pthread_create && _hdr_pthread
+#include	<pthread.h>
+#define RS_THREAD	1
+#endif
+
+#define THREADMIN	4096	/* min objects per thread		*/
+#define THREADSHARE	4	/* partitions per thread to balance	*/
+#define THREADSPLIT	64	/* max splits per thread		*/
+
+typedef struct _rspart_s	Rspart_t;
+
+struct _rspart_s
+{	Rspart_t*	next;	/* next partition in key order		*/
+	Rsobj_t*	list;	/* objects, list->left is the last one	*/
+	ssize_t		ph;	/* keys agree on the first ph bytes	*/
+	ssize_t		n;	/* number of objects			*/
+	int		done;	/* list is already in order		*/
+};
+
+typedef struct _rswork_s
+{	Rspart_t*	next;	/* next partition to be sorted		*/
+	int		type;	/* sort controls			*/
+#if RS_THREAD
+	pthread_mutex_t	lock;	/* protects next			*/
+#endif
+} Rswork_t;
+
+typedef struct _rsthread_s
+{	Rsobj_t*	list;
+	ssize_t		n;
+} Rsthread_t;
+
+#if __STD_C
+static int threadinsert(Rs_t* rs, reg Rsobj_t* obj)
+#else
+static int threadinsert(rs, obj)
+Rs_t*		rs;
+reg Rsobj_t*	obj;
+#endif
+{
+	reg Rsobj_t*	r;
+	reg Rsthread_t*	thread = (Rsthread_t*)rs->methdata;
+
+	obj->equal = NIL(Rsobj_t*);
+	if((r = thread->list) )
+		r->left->right = obj;
+	else	thread->list = (r = obj);
+	r->left = obj;
+	thread->n += 1;
+	return 0;
+}
+
+/*	Bucket the objects of a partition by the key byte at position pp->ph.
+**	pp is replaced by the resulting partitions, in key order.
+*/
+#if __STD_C
+static int split(Rs_t* rs, reg Rspart_t* pp)
+#else
+static int split(rs, pp)
+Rs_t*		rs;
+reg Rspart_t*	pp;
+#endif
+{
+	reg Rsobj_t	*work, *r, *t, *empty, **bin, **lo, **hi;
+	reg Rspart_t	*np, *last;
+	reg ssize_t	ph;
+	reg int		eq;
+	Rspart_t*	new;
+	Rsobj_t		*part[UCHAR_MAX+1];
+	ssize_t		count[UCHAR_MAX+1];
+
+	if(!(new = (Rspart_t*)vmalloc(rs->vm, (UCHAR_MAX+1)*sizeof(Rspart_t))) )
+		return -1;
+	for(bin = part, hi = part + UCHAR_MAX+1; bin < hi; ++bin)
+		*bin = NIL(Rsobj_t*);
+
+	/* with fixed length keys the last byte decides equivalence */
+	ph = pp->ph;
+	eq = (rs->type&RS_KSAMELEN) && ph == pp->list->keylen-1;
+
+	work = pp->list; work->left->right = NIL(Rsobj_t*);
+	empty = NIL(Rsobj_t*);
+	lo = hi; hi = part;
+	for(; work; work = work->right)
+	{	if(ph >= work->keylen)
+		{	if(!empty)
+				empty = work;
+			else	EQUAL(empty,work,t);
+			continue;
+		}
+		bin = part + work->key[ph];
+		if(!(r = *bin) )
+		{	r = *bin = work;
+			count[bin-part] = 0;
+			if(lo > bin)
+				lo = bin;
+			if(hi < bin)
+				hi = bin;
+		}
+		else if(eq)
+		{	EQUAL(r,work,t);
+		}
+		else	r->left->right = work;
+		r->left = work;
+		count[bin-part] += 1;
+	}
+
+	last = NIL(Rspart_t*);
+	np = pp;
+	if(empty)
+	{	empty->left = empty;
+		empty->right = NIL(Rsobj_t*);
+		np->list = empty;
+		np->n = 1;
+		np->done = 1;
+		last = np;
+	}
+	for(bin = lo; bin <= hi; ++bin)
+	{	if(!(r = *bin) )
+			continue;
+		if(last)
+		{	np = new++;
+			np->next = last->next;
+			last->next = np;
+		}
+		np->list = r;
+		np->ph = ph+1;
+		np->n = count[bin-part];
+		if((np->done = eq || np->n == 1) )
+		{	r->left = r;
+			r->right = NIL(Rsobj_t*);
+		}
+		last = np;
+	}
+	return 0;
+}
+
+/*	Sort partitions off the shared queue until it is empty.
+*/
+#if __STD_C
+static Void_t* worker(Void_t* arg)
+#else
+static Void_t* worker(arg)
+Void_t*	arg;
+#endif
+{
+	reg Rspart_t*	pp;
+	reg Rswork_t*	work = (Rswork_t*)arg;
+
+	for(;;)
+	{
+#if RS_THREAD
+		pthread_mutex_lock(&work->lock);
+#endif
+		while((pp = work->next) && pp->done)
+			work->next = pp->next;
+		if(pp)
+			work->next = pp->next;
+#if RS_THREAD
+		pthread_mutex_unlock(&work->lock);
+#endif
+		if(!pp)
+			break;
+		pp->list = rsradixsort(pp->list, pp->ph, work->type);
+	}
+	return NIL(Void_t*);
+}
+
+#if __STD_C
+static Rsobj_t* threadlist(Rs_t* rs)
+#else
+static Rsobj_t* threadlist(rs)
+Rs_t*		rs;
+#endif
+{
+	reg Rsobj_t	*list, *endl, *r;
+	reg Rspart_t	*pp, *big;
+	reg int		n, threads, splits;
+	ssize_t		share;
+	Rspart_t	part;
+	Rswork_t	work;
+#if RS_THREAD
+	pthread_t*	tid;
+#endif
+	reg Rsthread_t*	thread = (Rsthread_t*)rs->methdata;
+
+	if(!(list = thread->list) )
+		return NIL(Rsobj_t*);
+	n = thread->n;
+	thread->list = NIL(Rsobj_t*);
+	thread->n = 0;
+
+	threads = rs->disc->version >= 20261017L ? rs->disc->threads : 0;
+#if RS_THREAD && defined(_SC_NPROCESSORS_ONLN)
+	if(threads <= 0)
+		threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+#if !RS_THREAD
+	threads = 1;
+#endif
+	if(threads > n / THREADMIN)
+		threads = n / THREADMIN;
+	if(threads <= 1)
+		return rsradixsort(list, 0, rs->type);
+
+	/* split until each partition is at most a fair share of the work */
+	part.next = NIL(Rspart_t*);
+	part.list = list;
+	part.ph = 0;
+	part.n = n;
+	part.done = 0;
+	share = n / (threads * THREADSHARE);
+	for(splits = threads * THREADSPLIT; splits > 0; --splits)
+	{	for(big = NIL(Rspart_t*), pp = &part; pp; pp = pp->next)
+			if(!pp->done && pp->n > share && (!big || pp->n > big->n) )
+				big = pp;
+		if(!big)
+			break;
+		if(split(rs, big) < 0)
+			break;
+	}
+
+	work.next = &part;
+	work.type = rs->type;
+#if RS_THREAD
+	pthread_mutex_init(&work.lock, NIL(pthread_mutexattr_t*));
+	if((tid = (pthread_t*)vmalloc(rs->vm, (threads-1)*sizeof(pthread_t))) )
+	{	for(n = 0; n < threads-1; ++n)
+			if(pthread_create(tid+n, NIL(pthread_attr_t*), worker, (Void_t*)&work) )
+				break;
+	}
+	else	n = 0;
+	worker((Void_t*)&work);
+	while(n-- > 0)
+		pthread_join(tid[n], NIL(Void_t**));
+	pthread_mutex_destroy(&work.lock);
+#else
+	worker((Void_t*)&work);
+#endif
+
+	list = endl = NIL(Rsobj_t*);
+	for(pp = &part; pp; pp = pp->next)
+	{	if(!(r = pp->list) )
+			continue;
+		if(list)
+			endl->right = r;
+		else	list = r;
+		endl = r->left;
+	}
+	list->left = endl;
+	endl->right = NIL(Rsobj_t*);
+
+	return list;
+}
+
+/* public method */
+static Rsmethod_t _Rsthread =
+{	threadinsert,
+	threadlist,
+	sizeof(Rsthread_t),
+	RS_MTTHREAD,
+	"thread",
+	"Radix sort of key partitions by a pool of threads."
+};
+
+__DEFINE__(Rsmethod_t*, Rsthread, &_Rsthread);
+
+#ifdef NoF
+NoF(rsthread)
+#endif
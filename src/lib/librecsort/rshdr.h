@@ -175,7 +175,9 @@ _END_EXTERNS_
 #define RSNOTIFY(r,o,v,x,d)	((r->events&o)?rsnotify(r,o,(Void_t*)v,(Void_t*)x,d):(0))
 
 #define rsnotify	_rs_notify
+#define rsradixsort	_rs_radixsort
 
 extern int		rsnotify _ARG_((Rs_t*, int, Void_t*, Void_t*, Rsdisc_t*));
+extern Rsobj_t*		rsradixsort _ARG_((Rsobj_t*, ssize_t, int));
 
 #endif /*_RSHDR_H*/
@@ -421,6 +421,20 @@ unsigned char*	zp;
 	return xp - cp;
 }
 
+/*
+ * word-at-a-time text coding for fields with identity translation:
+ * KEYWORD_EDGE(w) is non-zero if any byte in w is <= 1 or >= 254,
+ * i.e., needs the anti-ambiguity escape; other words copy as is
+ */
+
+typedef unsigned long Keyword_t;
+
+#define KEYWORD_ONES	((Keyword_t)~0/0xff)
+#define KEYWORD_HIGH	(KEYWORD_ONES<<7)
+#define KEYWORD_MASK	(KEYWORD_ONES*0xfe)
+#define KEYWORD_ZERO(w)	(((w)-KEYWORD_ONES)&~(w)&KEYWORD_HIGH)
+#define KEYWORD_EDGE(w)	(KEYWORD_ZERO((w)&KEYWORD_MASK)|KEYWORD_ZERO(~(w)&KEYWORD_MASK))
+
 /*
  * Encode text field subject to options -r -fdi -b.
  * Fields are separated by 0 (or 255 if rflag is set)
@@ -521,6 +535,40 @@ unsigned char*	zp;
 	else
 	{
 	native:
+		if (trans == kp->state->ident && keep == kp->state->all)
+		{
+			Keyword_t	w;
+			Keyword_t	r = reverse ? ~(Keyword_t)0 : 0;
+
+			while (len >= sizeof(w))
+			{
+				memcpy(&w, dp, sizeof(w));
+				if (!KEYWORD_EDGE(w))
+				{
+					w ^= r;
+					memcpy(xp, &w, sizeof(w));
+					xp += sizeof(w);
+					dp += sizeof(w);
+					len -= sizeof(w);
+				}
+				else
+					for (i = 0; i < sizeof(w); i++, len--)
+					{
+						c = *dp++;
+						if (c <= 1)
+						{
+							*xp++ = 1 ^ reverse;
+							c++;
+						}
+						else if (c >= 254)
+						{
+							*xp++ = 255 ^ reverse;
+							c--;
+						}
+						*xp++ = c ^ reverse;
+					}
+			}
+		}
 		while (len-- > 0)
 		{
 			c = *dp++;
@@ -647,22 +695,27 @@ Rsdisc_t*	disc;
 	case '\n':
 		break;
 	default:
-		tp = kp->tab[1] ? (kp->tab + 1) : 0;
+		if (!kp->tab[1])
+		{
+			/*
+			 * memchr() is usually the fastest delimiter scan around
+			 */
+
+			for (cp = dat; np < m && (cp = (unsigned char*)memchr(cp, t, xp - cp)); )
+				pp[np++] = ++cp;
+			break;
+		}
+		tp = kp->tab + 1;
 		for (cp = dat; cp < xp && np < m;)
 			if (*cp++ == t)
-			{
-				if (!tp)
-					pp[np++] = cp;
-				else
-					for (n = 0; (cp + n) < xp; n++)
-						if (!tp[n])
-						{
-							pp[np++] = cp + n;
-							break;
-						}
-						else if (tp[n] != cp[n])
-							break;
-			}
+				for (n = 0; (cp + n) < xp; n++)
+					if (!tp[n])
+					{
+						pp[np++] = cp + n;
+						break;
+					}
+					else if (tp[n] != cp[n])
+						break;
 		break;
 	}
 	for (fp = kp->head; fp; fp = fp->next)
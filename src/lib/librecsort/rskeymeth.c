@@ -31,8 +31,10 @@ static Rsmethod_t**	methods[] =
 	&Rsrasp,
 	&Rsradix,
 	&Rssplay,
+	&Rsthread,
 	&Rsverify,
 	&Rscopy,
+	&Rslimit,
 };
 
 /*
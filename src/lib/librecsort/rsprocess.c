@@ -107,7 +107,8 @@ ssize_t	s_data;		/* data size		*/
 	{	if((s_loop = s_data) > c_max && !single) /* max amount per loop */
 			s_loop = c_max;
 
-		if((rs->c_size += s_loop) > c_max && (r = (*rs->meth->listf)(rs)) )
+		if((rs->c_size += s_loop) > c_max && rs->meth->type != RS_MTLIMIT &&
+		   (r = (*rs->meth->listf)(rs)) )
 		{	/* start a new sorted chain */
 			Rsobj_t**	list;
 			list = (Rsobj_t**)vmresize(rs->vm, rs->list,
@@ -225,17 +226,18 @@ ssize_t	s_data;		/* data size		*/
 						s_key = 0;
 						m_key = c_key = NIL(uchar*);
 					}
-					else
+					else if(rs->meth->type != RS_MTLIMIT)
 					{	c_key += k;
 						s_key -= k;
 					}
+					/* else the key space is reused, Rslimit copies keys it keeps */
 				}
 				if(r->data != data || !(rs->events & RS_READ))
 					break;
 				if((n = rsnotify(rs,RS_READ,r,(Void_t*)0,rs->disc))<0)
 					return -1;
 				if(n == RS_DELETE)
-				{	if(defkeyf && c_key)
+				{	if(defkeyf && c_key && rs->meth->type != RS_MTLIMIT)
 					{	c_key -= k;
 						s_key += k;
 					}
@@ -69,47 +69,30 @@
 		MEMCPY(to,t,len); \
 	}
 
+/* write the object list r to f */
 #if __STD_C
-int rswrite(Rs_t* rs, Sfio_t* f, int type)
+static int rsput(Rs_t* rs, Sfio_t* f, Rsobj_t* r, int type, int local)
 #else
-int rswrite(rs, f, type)
+static int rsput(rs, f, r, type, local)
 Rs_t*	rs;	/* sorting context	*/
 Sfio_t*	f;	/* stream to write to	*/
+Rsobj_t* r;	/* sorted object list	*/
 int	type;	/* RS_TEXT 		*/
+int	local;	/* local rsmerge() call	*/
 #endif
 {
-	reg Rsobj_t	*r, *e, *o;
+	reg Rsobj_t	*e, *o;
 	reg uchar	*d, *cur, *endrsrv, *rsrv;
 	ssize_t		w, head, n;
-	int		local, flags, u, c;
+	int		u, c;
 	Rsobj_t		out;
 	Rsobj_t		tmp;
 	Rsobj_t		usr;
 
-#if 0
-	if(type == RS_OTEXT && (rs->events & RS_READ))
-	{	usr.data = 0;
-		usr.datalen = 0;
-		if((n = rsnotify(rs,RS_READ,&usr,(Void_t*)0,rs->disc))<0)
-			return -1;
-		if(n == RS_INSERT && rsprocess(rs, usr.data, usr.datalen) < 0)
-			return -1;
-	}
-#endif
-	if(GETLOCAL(rs,local))
+	if(local)
 	{	rsrv = rs->rsrv; endrsrv = rs->endrsrv; cur = rs->cur;
-		r = rs->sorted;
-	}
-	else	/* external call */
-	{	rsrv = cur = endrsrv = NIL(uchar*);
-		if(!(r = rslist(rs)) )
-			return 0;
-
-		flags = sfset(f,0,1);
-		if(!(flags&SF_WRITE))
-			return -1;
-		sfset(f,(SF_READ|SF_SHARE|SF_PUBLIC),0);
 	}
+	else	rsrv = cur = endrsrv = NIL(uchar*);
 
 #if _PACKAGE_ast
 	head = (rs->type&RS_DSAMELEN) ? -1 : (rs->disc->data & ~0xff) ? 0 : sizeof(ssize_t);
@@ -310,12 +293,130 @@ int	type;	/* RS_TEXT 		*/
 	if(local)
 	{	rs->rsrv = rsrv; rs->endrsrv = endrsrv; rs->cur = cur;
 	}
-	else
-	{	if(rsrv)
-			sfwrite(f,rsrv,cur-rsrv);
-		rsclear(rs);
+	else if(rsrv)
+		sfwrite(f,rsrv,cur-rsrv);
+
+	return 0;
+}
+
+#if __STD_C
+int rswrite(Rs_t* rs, Sfio_t* f, int type)
+#else
+int rswrite(rs, f, type)
+Rs_t*	rs;	/* sorting context	*/
+Sfio_t*	f;	/* stream to write to	*/
+int	type;	/* RS_TEXT 		*/
+#endif
+{
+	reg Rsobj_t	*r;
+	int		local, flags;
+#if 0
+	ssize_t		n;
+	Rsobj_t		usr;
+
+	if(type == RS_OTEXT && (rs->events & RS_READ))
+	{	usr.data = 0;
+		usr.datalen = 0;
+		if((n = rsnotify(rs,RS_READ,&usr,(Void_t*)0,rs->disc))<0)
+			return -1;
+		if(n == RS_INSERT && rsprocess(rs, usr.data, usr.datalen) < 0)
+			return -1;
+	}
+#endif
+	if(GETLOCAL(rs,local))
+		return rsput(rs,f,rs->sorted,type,1);
+
+	/* external call */
+	if(!(r = rslist(rs)) )
+		return 0;
+
+	flags = sfset(f,0,1);
+	if(!(flags&SF_WRITE))
+		return -1;
+	sfset(f,(SF_READ|SF_SHARE|SF_PUBLIC),0);
+
+	if(rsput(rs,f,r,type,0) < 0)
+		return -1;
+
+	rsclear(rs);
+	sfset(f,(flags&(SF_READ|SF_SHARE|SF_PUBLIC)),1);
+
+	return 0;
+}
+
+/* compare the keys of two objects */
+#if __STD_C
+static int keycmp(reg Rsobj_t* one, reg Rsobj_t* two)
+#else
+static int keycmp(one, two)
+reg Rsobj_t*	one;
+reg Rsobj_t*	two;
+#endif
+{
+	reg ssize_t	l, d;
+	reg int		cmp;
+
+	if((d = (l = one->keylen) - two->keylen) > 0)
+		l -= d;
+	if(l > 0 && (cmp = memcmp(one->key,two->key,l)) )
+		return cmp;
+	return d < 0 ? -1 : d > 0;
+}
+
+/* Write the sorted objects in rs to the n streams files[] then clear rs.
+** part[] holds n-1 splitter keys in ascending order; an object goes to
+** the partition of the number of splitter keys <= its own key. Partitions
+** are assigned to files[] in output order so that catenating the merged
+** partitions in files[] order produces the sorted output.
+*/
+#if __STD_C
+int rswritepart(Rs_t* rs, Sfio_t** files, int n, Rsobj_t* part, int type)
+#else
+int rswritepart(rs, files, n, part, type)
+Rs_t*		rs;	/* sorting context		*/
+Sfio_t**	files;	/* streams to write to		*/
+int		n;	/* number of streams		*/
+Rsobj_t*	part;	/* n-1 splitter keys		*/
+int		type;	/* RS_TEXT			*/
+#endif
+{
+	reg Rsobj_t	*r, *e, *p;
+	reg int		k, lo, hi, m;
+	int		flags;
+	Sfio_t*		f;
+
+	if(n <= 1)
+		return n == 1 ? rswrite(rs,files[0],type) : -1;
+
+	if(!(r = rslist(rs)) )
+		return 0;
+
+	for(; r; r = e)
+	{	/* the list is in output order so partitions are contiguous */
+		for(k = 0, p = NIL(Rsobj_t*), e = r; e; p = e, e = e->right)
+		{	for(lo = 0, hi = n-1; lo < hi; )
+			{	m = (lo + hi) / 2;
+				if(keycmp(part+m,e) <= 0)
+					lo = m+1;
+				else	hi = m;
+			}
+			if(p && lo != k)
+				break;
+			k = lo;
+		}
+		p->right = NIL(Rsobj_t*);
+
+		f = files[(rs->type&RS_REVERSE) ? n-1-k : k];
+		flags = sfset(f,0,1);
+		if(!(flags&SF_WRITE))
+			return -1;
+		sfset(f,(SF_READ|SF_SHARE|SF_PUBLIC),0);
+		if(rsput(rs,f,r,type,0) < 0)
+			return -1;
 		sfset(f,(flags&(SF_READ|SF_SHARE|SF_PUBLIC)),1);
 	}
 
+	rsclear(rs);
+
 	return 0;
 }
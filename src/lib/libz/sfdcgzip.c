@@ -73,6 +73,8 @@ typedef struct
 	Sfdisc_t	disc;		/* sfio discipline		*/
 	gzFile*		gz;		/* gz handle			*/
 	Sfio_t*		op;		/* original stream		*/
+	int		fd;		/* SFGZ_LAZY file descriptor	*/
+	char		mode[10];	/* SFGZ_LAZY gzbopen() mode	*/
 } Sfgzip_t;
 
 /*
@@ -131,15 +133,15 @@ sfgzexcept(Sfio_t* sp, int op, void* val, Sfdisc_t* dp)
 	case SF_DBUFFER:
 		return 1;
 	case SF_SYNC:
-		if (!val && gzsync(gz->gz, (z_off_t)(-1)) < 0)
+		if (!val && gz->gz && gzsync(gz->gz, (z_off_t)(-1)) < 0)
 			sp->_flags |= SF_ERROR;
 		return 0;
 	case SFGZ_HANDLE:
 		return (*((gzFile**)val) = gz->gz) ? 1 : -1;
 	case SFGZ_GETPOS:
-		return (*((Sfoff_t*)val) = gzsync(gz->gz, (z_off_t)(-1))) < 0 ? -1 : 0;
+		return gz->gz && (*((Sfoff_t*)val) = gzsync(gz->gz, (z_off_t)(-1))) >= 0 ? 0 : -1;
 	case SFGZ_SETPOS:
-		return gzsync(gz->gz, (z_off_t)(*((Sfoff_t*)val))) < 0 ? -1 : 0;
+		return gz->gz && gzsync(gz->gz, (z_off_t)(*((Sfoff_t*)val))) >= 0 ? 0 : -1;
 	}
 	return 0;
 }
@@ -175,6 +177,8 @@ sfgzwrite(Sfio_t* fp, const Void_t* buf, size_t size, Sfdisc_t* dp)
 {
 	register Sfgzip_t*	gz = (Sfgzip_t*)dp;
 
+	if (!gz->gz && !(gz->gz = gzbopen(gz->fd, gz->mode, NiL, 0)))
+		return -1;
 	return gzwrite(gz->gz, (void*)buf, size);
 }
 
@@ -189,6 +193,9 @@ sfgzwrite(Sfio_t* fp, const Void_t* buf, size_t size, Sfdisc_t* dp)
  *	>0	discipline pushed { g:gzip c:compress v:vczip }
  *	 0	discipline not needed
  *	<0	error
+ *
+ * (flags&SFGZ_LAZY) output defers the gzip header to the first
+ * write so that a stream that is never written stays empty
  */
 
 #undef	PRIVATE
@@ -201,8 +208,8 @@ sfdcgzip(Sfio_t* sp, int flags)
 	Sfgzip_t*	gz;
 	int		fd;
 	int		rd;
+	int		lazy;
 	size_t		z;
-	char		mode[10];
 
 	rd = sfset(sp, 0, 0) & SF_READ;
 	if (rd)
@@ -272,7 +279,8 @@ sfdcgzip(Sfio_t* sp, int flags)
 	else
 		gz->disc.writef = sfgzwrite;
 	gz->disc.seekf = sfgzseek;
-	m = mode;
+	lazy = !rd && (flags & SFGZ_LAZY);
+	m = gz->mode;
 	*m++ = rd ? 'r' : 'w';
 	*m++ = 'b';
 	if (flags & SFGZ_NOCRC)
@@ -298,7 +306,14 @@ sfdcgzip(Sfio_t* sp, int flags)
 	fd = sffileno(sp);
 	if (rd && (gz->op = sfopen(NiL, "/dev/null", "r")))
 		sfswap(sp, gz->op);
-	if (!(gz->gz = gzbopen(fd, mode, m, z)) || sfdisc(sp, &gz->disc) != &gz->disc)
+	if (lazy)
+		gz->fd = fd;
+	else if (!(gz->gz = gzbopen(fd, gz->mode, m, z)))
+	{
+		free(gz);
+		return -1;
+	}
+	if (sfdisc(sp, &gz->disc) != &gz->disc)
 	{
 		free(gz);
 		return -1;
@@ -60,6 +60,7 @@
 
 #define SFGZ_VERIFY		0x0010
 #define SFGZ_NOCRC		0x0020
+#define SFGZ_LAZY		0x0040
 
 #define SFGZ_HANDLE		SFDCEVENT('G','Z',1)
 #define SFGZ_GETPOS		SFDCEVENT('G','Z',2)